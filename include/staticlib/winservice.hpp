@@ -26,7 +26,28 @@
 
 #include "staticlib/config.hpp"
 
+#include "staticlib/winservice/async_lifecycle.hpp"
+#include "staticlib/winservice/cancellation_token.hpp"
+#include "staticlib/winservice/component_graph.hpp"
+#include "staticlib/winservice/lifecycle_events.hpp"
+#include "staticlib/winservice/notify_socket.hpp"
 #include "staticlib/winservice/operations.hpp"
+#include "staticlib/winservice/posix_scm.hpp"
+#include "staticlib/winservice/resource_usage.hpp"
+#include "staticlib/winservice/scm_backend.hpp"
+#include "staticlib/winservice/scm_session.hpp"
+#include "staticlib/winservice/service_event_bus.hpp"
+#include "staticlib/winservice/service_lifecycle.hpp"
+#include "staticlib/winservice/service_metrics.hpp"
+#include "staticlib/winservice/service_snapshot.hpp"
+#include "staticlib/winservice/service_supervisor.hpp"
+#include "staticlib/winservice/service_state.hpp"
+#include "staticlib/winservice/service_status.hpp"
+#include "staticlib/winservice/service_tracer.hpp"
+#include "staticlib/winservice/service_transition.hpp"
+#include "staticlib/winservice/simulated_scm.hpp"
+#include "staticlib/winservice/socket_handoff.hpp"
+#include "staticlib/winservice/windows_scm.hpp"
 #include "staticlib/winservice/winservice_exception.hpp"
 
 #endif /* STATICLIB_WINSERVICE_HPP */
@@ -0,0 +1,135 @@
+/*
+ * Copyright 2026, alex at staticlibs.net
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * File:   async_lifecycle.hpp
+ * Author: alex
+ *
+ * Created on October 17, 2026, 10:20 AM
+ */
+
+#ifndef STATICLIB_WINSERVICE_ASYNC_LIFECYCLE_HPP
+#define STATICLIB_WINSERVICE_ASYNC_LIFECYCLE_HPP
+
+#include <exception>
+#include <functional>
+#include <memory>
+#include <string>
+
+#include "staticlib/winservice/service_lifecycle.hpp"
+#include "staticlib/winservice/service_transition.hpp"
+
+namespace staticlib {
+namespace winservice {
+
+/**
+ * Completion handle passed to the asynchronous lifecycle callback,
+ * copies of the handle refer to the same transition. Transition is finished
+ * by the first call to 'complete' or 'fail', it fails automatically if
+ * all the copies are destroyed without completing it.
+ */
+class transition_completion {
+public:
+    class impl;
+
+private:
+    std::shared_ptr<impl> pimpl;
+
+public:
+    /**
+     * Internal constructor
+     *
+     * @param pimpl implementation
+     */
+    explicit transition_completion(std::shared_ptr<impl> pimpl);
+
+    /**
+     * Finishes the transition successfully, target state is reported to SCM,
+     * can be called from any thread, including the thread of the callback
+     */
+    void complete();
+
+    /**
+     * Finishes the transition with an error, service is stopped
+     *
+     * @param message error message
+     */
+    void fail(const std::string& message);
+
+    /**
+     * Finishes the transition with an error, service is stopped
+     *
+     * @param error exception, e.g. 'std::current_exception()'
+     */
+    void fail(std::exception_ptr error);
+
+    /**
+     * Checks whether transition was finished
+     *
+     * @return true if 'complete' or 'fail' was called
+     */
+    bool is_finished() const;
+};
+
+/**
+ * Asynchronous lifecycle callback, returns as soon as the operation
+ * is initiated, 'service_transition' stays valid until the completion
+ */
+typedef std::function<void(service_transition&, transition_completion)> async_lifecycle_callback;
+
+/**
+ * Callbacks of the service built on an event loop, callbacks are posted
+ * to the executor and return without waiting for I/O, the library reports
+ * pending state with increasing checkpoints until the completion
+ */
+struct async_service_lifecycle {
+    /**
+     * Start callback, will be called on 'START' and 'CONTINUE' events
+     */
+    async_lifecycle_callback starter;
+    /**
+     * Stop callback, will be called on 'STOP', 'PAUSE', 'SHUTDOWN' and 'PRESHUTDOWN' events
+     */
+    async_lifecycle_callback stopper;
+    /**
+     * Optional pause callback, will be called on 'PAUSE' event instead of 'stopper'
+     */
+    async_lifecycle_callback pauser;
+    /**
+     * Optional resume callback, will be called on 'CONTINUE' event instead of 'starter'
+     */
+    async_lifecycle_callback resumer;
+    /**
+     * Posts the task to the event loop of the service, if not set,
+     * callbacks are called on the lifecycle thread
+     */
+    std::function<void(std::function<void()>)> executor;
+};
+
+/**
+ * Adapts asynchronous callbacks to the 'service_lifecycle', lifecycle
+ * thread of the service waits for the completion while user threads
+ * are not blocked, other options of the returned lifecycle can be set as usual
+ *
+ * @param lifecycle asynchronous callbacks
+ * @return service lifecycle
+ */
+service_lifecycle make_async_lifecycle(async_service_lifecycle lifecycle);
+
+} // namespace
+}
+
+#endif /* STATICLIB_WINSERVICE_ASYNC_LIFECYCLE_HPP */
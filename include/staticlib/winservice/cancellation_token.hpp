@@ -0,0 +1,72 @@
+/*
+ * Copyright 2026, alex at staticlibs.net
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * File:   cancellation_token.hpp
+ * Author: alex
+ *
+ * Created on October 17, 2026, 3:10 PM
+ */
+
+#ifndef STATICLIB_WINSERVICE_CANCELLATION_TOKEN_HPP
+#define STATICLIB_WINSERVICE_CANCELLATION_TOKEN_HPP
+
+#include <cstdint>
+#include <memory>
+
+namespace staticlib {
+namespace winservice {
+
+/**
+ * Cancellation flag shared between the lifecycle callback and the control
+ * handler, copies of the token refer to the same flag
+ */
+class cancellation_token {
+    class impl;
+    std::shared_ptr<impl> pimpl;
+
+public:
+    /**
+     * Constructor, creates non-cancelled token
+     */
+    cancellation_token();
+
+    /**
+     * Cancels the token and wakes up all the waiting threads,
+     * subsequent calls have no effect
+     */
+    void cancel();
+
+    /**
+     * Checks whether the token was cancelled, does not lock
+     *
+     * @return true if cancelled
+     */
+    bool is_cancelled() const;
+
+    /**
+     * Waits for the token to be cancelled
+     *
+     * @param timeout_millis max time to wait
+     * @return true if cancelled, false on timeout
+     */
+    bool wait_for(uint32_t timeout_millis) const;
+};
+
+} // namespace
+}
+
+#endif /* STATICLIB_WINSERVICE_CANCELLATION_TOKEN_HPP */
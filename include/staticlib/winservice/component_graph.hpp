@@ -0,0 +1,105 @@
+/*
+ * Copyright 2026, alex at staticlibs.net
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * File:   component_graph.hpp
+ * Author: alex
+ *
+ * Created on October 17, 2026, 4:05 PM
+ */
+
+#ifndef STATICLIB_WINSERVICE_COMPONENT_GRAPH_HPP
+#define STATICLIB_WINSERVICE_COMPONENT_GRAPH_HPP
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "staticlib/winservice/service_lifecycle.hpp"
+#include "staticlib/winservice/winservice_exception.hpp"
+
+namespace staticlib {
+namespace winservice {
+
+/**
+ * Set of service components with declared dependencies between them,
+ * components are started in dependency order, independent components
+ * are started concurrently, stop is done in reverse order
+ */
+class component_graph {
+    class impl;
+    std::shared_ptr<impl> pimpl;
+
+public:
+    /**
+     * Constructor
+     *
+     * @param threads_count max number of components started or stopped concurrently,
+     *        number of CPU cores is used if '0' is specified
+     */
+    component_graph(uint32_t threads_count = 0);
+
+    /**
+     * Registers component, dependencies are checked on start
+     *
+     * @param name component name
+     * @param dependencies names of the components that must be started before this one
+     * @param starter start callback
+     * @param stopper stop callback
+     * @return this instance
+     * @throws winservice_exception on duplicate name
+     */
+    component_graph& add_component(const std::string& name, const std::vector<std::string>& dependencies,
+            std::function<void()> starter, std::function<void()> stopper);
+
+    /**
+     * Starts all the components that are not yet started, if any of the starters
+     * fails, components started so far are stopped and exception is thrown
+     *
+     * @param logger logger callback, start time of each component is reported to it
+     * @param progress optional callback that receives the fraction of started components
+     * @throws winservice_exception on invalid graph or start error
+     */
+    void start(std::function<void(const std::string&)> logger,
+            std::function<void(double)> progress = nullptr);
+
+    /**
+     * Stops all the started components, stop continues if any
+     * of the stoppers fails, first error is thrown after that
+     *
+     * @param logger logger callback, stop time of each component is reported to it
+     * @param progress optional callback that receives the fraction of stopped components
+     * @throws winservice_exception on stop error
+     */
+    void stop(std::function<void(const std::string&)> logger,
+            std::function<void(double)> progress = nullptr);
+
+    /**
+     * Creates service lifecycle that starts and stops this graph,
+     * returned lifecycle keeps this graph alive
+     *
+     * @param logger logger callback
+     * @return service lifecycle to pass to 'start_service_and_wait'
+     */
+    service_lifecycle create_lifecycle(std::function<void(const std::string&)> logger);
+};
+
+} // namespace
+}
+
+#endif /* STATICLIB_WINSERVICE_COMPONENT_GRAPH_HPP */
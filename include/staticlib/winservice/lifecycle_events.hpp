@@ -0,0 +1,185 @@
+/*
+ * Copyright 2026, alex at staticlibs.net
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * File:   lifecycle_events.hpp
+ * Author: alex
+ *
+ * Created on October 17, 2026, 3:05 PM
+ */
+
+#ifndef STATICLIB_WINSERVICE_LIFECYCLE_EVENTS_HPP
+#define STATICLIB_WINSERVICE_LIFECYCLE_EVENTS_HPP
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+
+#include "staticlib/config.hpp"
+
+namespace staticlib {
+namespace winservice {
+
+// event ids
+
+const uint32_t event_start_failed = 1;
+const uint32_t event_stop_failed = 2;
+const uint32_t event_status_report_failed = 3;
+const uint32_t event_checkpoint_failed = 4;
+const uint32_t event_handler_registration_failed = 5;
+const uint32_t event_transition_completed = 6;
+
+// severities
+
+const uint32_t severity_info = 1;
+const uint32_t severity_warning = 2;
+const uint32_t severity_error = 3;
+const uint32_t severity_fatal = 4;
+
+/**
+ * Fixed-size record of the lifecycle event, does not own any heap memory
+ */
+struct lifecycle_event {
+    /**
+     * Event id, one of 'event_*' constants
+     */
+    uint32_t event_id = 0;
+    /**
+     * Severity, one of 'severity_*' constants
+     */
+    uint32_t severity = 0;
+    /**
+     * Pending state of the transition
+     */
+    uint32_t pending_state = 0;
+    /**
+     * Target state of the transition
+     */
+    uint32_t target_state = 0;
+    /**
+     * Win32 exit code reported to SCM
+     */
+    uint32_t error_code = 0;
+    /**
+     * Event time, milliseconds since epoch
+     */
+    uint64_t timestamp_millis = 0;
+    /**
+     * Service name, truncated if too long
+     */
+    char service_name[64];
+    /**
+     * Error message, truncated if too long
+     */
+    char message[256];
+
+    /**
+     * Constructor
+     */
+    lifecycle_event() STATICLIB_NOEXCEPT {
+        service_name[0] = '\0';
+        message[0] = '\0';
+    }
+};
+
+/**
+ * Creates the event with the current timestamp without allocating memory
+ *
+ * @param event_id event id
+ * @param severity event severity
+ * @param service_name service name
+ * @param pending_state pending state of the transition
+ * @param target_state target state of the transition
+ * @param error_code Win32 exit code
+ * @param message error message, may be 'nullptr'
+ * @return event
+ */
+lifecycle_event make_lifecycle_event(uint32_t event_id, uint32_t severity, const std::string& service_name,
+        uint32_t pending_state, uint32_t target_state, uint32_t error_code, const char* message) STATICLIB_NOEXCEPT;
+
+/**
+ * Formats the event into a log message
+ *
+ * @param event event
+ * @return log message
+ */
+std::string format_lifecycle_event(const lifecycle_event& event);
+
+/**
+ * Bounded lock-free multi-producer queue of lifecycle events with
+ * a consumer thread, buffer is preallocated and publishing never allocates,
+ * the lock is taken only briefly to wake the idle consumer, events are dropped
+ * when the buffer is full
+ */
+class lifecycle_event_channel {
+    class impl;
+    std::shared_ptr<impl> pimpl;
+
+public:
+    /**
+     * Constructor, starts consumer thread
+     *
+     * @param consumer called on the consumer thread for each event
+     * @param capacity buffer size, rounded up to the power of two
+     */
+    lifecycle_event_channel(std::function<void(const lifecycle_event&)> consumer, uint32_t capacity = 1024);
+
+    /**
+     * Destructor, delivers the remaining events
+     */
+    ~lifecycle_event_channel() STATICLIB_NOEXCEPT;
+
+    lifecycle_event_channel(const lifecycle_event_channel&) = delete;
+
+    lifecycle_event_channel& operator=(const lifecycle_event_channel&) = delete;
+
+    /**
+     * Enqueues event, can be called from multiple threads
+     *
+     * @param event event
+     * @return false if the buffer is full or the channel is closed
+     */
+    bool publish(const lifecycle_event& event) STATICLIB_NOEXCEPT;
+
+    /**
+     * Number of events dropped because the buffer was full
+     *
+     * @return dropped events count
+     */
+    uint64_t dropped_count() const STATICLIB_NOEXCEPT;
+
+    /**
+     * Delivers remaining events and stops the consumer thread,
+     * events published after this call are dropped
+     */
+    void close() STATICLIB_NOEXCEPT;
+
+    /**
+     * Creates channel that formats events with 'format_lifecycle_event'
+     * and passes them to the specified string logger, messages that
+     * do not fit into the event are logged truncated
+     *
+     * @param logger logger callback
+     * @return channel instance
+     */
+    static std::shared_ptr<lifecycle_event_channel> from_logger(std::function<void(const std::string&)> logger);
+};
+
+} // namespace
+}
+
+#endif /* STATICLIB_WINSERVICE_LIFECYCLE_EVENTS_HPP */
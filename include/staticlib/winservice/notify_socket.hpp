@@ -0,0 +1,93 @@
+/*
+ * Copyright 2026, alex at staticlibs.net
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * File:   notify_socket.hpp
+ * Author: alex
+ *
+ * Created on October 17, 2026, 1:40 PM
+ */
+
+#ifndef STATICLIB_WINSERVICE_NOTIFY_SOCKET_HPP
+#define STATICLIB_WINSERVICE_NOTIFY_SOCKET_HPP
+
+#include "staticlib/config.hpp"
+
+#ifndef STATICLIB_WINDOWS
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+namespace staticlib {
+namespace winservice {
+
+/**
+ * Client for the readiness notification protocol of the service manager
+ * (compatible with 'sd_notify'), messages like 'READY=1' are sent as datagrams
+ * to the unix socket specified in 'NOTIFY_SOCKET' environment variable.
+ * Used by 'posix_scm' to report status transitions.
+ */
+class notify_socket {
+    class impl;
+    std::shared_ptr<impl> pimpl;
+
+public:
+    /**
+     * Constructor, uses the socket specified in 'NOTIFY_SOCKET'
+     * environment variable, notifications are disabled if it is not set
+     */
+    notify_socket();
+
+    /**
+     * Constructor
+     *
+     * @param socket_path socket path, '@' prefix means abstract namespace,
+     *        empty path disables notifications
+     */
+    explicit notify_socket(const std::string& socket_path);
+
+    /**
+     * Checks whether notification socket is specified
+     *
+     * @return true if notifications are sent
+     */
+    bool is_enabled() const;
+
+    /**
+     * Sends newline-separated list of assignments, e.g. "READY=1\nSTATUS=Running",
+     * does nothing if notifications are disabled
+     *
+     * @param message message to send
+     * @throws winservice_exception on send error
+     */
+    void notify(const std::string& message);
+
+    /**
+     * Watchdog interval requested by the service manager with 'WATCHDOG_USEC'
+     * environment variable, 'WATCHDOG=1' must be sent at least this often
+     *
+     * @return interval in microseconds, '0' if watchdog is not enabled for this process
+     */
+    static uint64_t watchdog_interval_usec();
+};
+
+} // namespace
+}
+
+#endif // !STATICLIB_WINDOWS
+
+#endif /* STATICLIB_WINSERVICE_NOTIFY_SOCKET_HPP */
@@ -24,9 +24,16 @@
 #ifndef STATICLIB_WINSERVICE_OPERATIONS_HPP
 #define STATICLIB_WINSERVICE_OPERATIONS_HPP
 
+#include <cstdint>
 #include <functional>
+#include <future>
 #include <string>
+#include <utility>
+#include <vector>
 
+#include "staticlib/winservice/scm_session.hpp"
+#include "staticlib/winservice/service_lifecycle.hpp"
+#include "staticlib/winservice/service_status.hpp"
 #include "staticlib/winservice/winservice_exception.hpp"
 
 namespace staticlib {
@@ -39,12 +46,26 @@ namespace winservice {
  * @param display_name service name in services list
  * @param account windows account name, 'LocalService' by default
  * @param password windows account password
- * @param start_type service start type, 'SERVICE_AUTO_START' by default
+ * @param start_type service start type, 'SERVICE_AUTO_START' by default,
+ *        'SERVICE_DELAYED_AUTO_START' starts the service after other auto-start services
  * @param dependencies service dependencies
+ * @param service_type service type, 'SERVICE_WIN32_OWN_PROCESS' by default,
+ *        'SERVICE_WIN32_SHARE_PROCESS' should be used for services hosted
+ *        in the same process with 'start_services_and_wait'
  */
 void install_service(const std::string& service_name, const std::string& display_name,
         const std::string& account = "NT AUTHORITY\\LocalService", const std::string& password = "",
-        const std::string& start_type = "SERVICE_AUTO_START", const std::string& dependencies = "");
+        const std::string& start_type = "SERVICE_AUTO_START", const std::string& dependencies = "",
+        const std::string& service_type = "SERVICE_WIN32_OWN_PROCESS");
+
+/**
+ * Installs Windows Service with the specified configuration, optional settings
+ * (description, delayed auto-start, triggers, failure actions etc.) are applied
+ * after the service is created
+ *
+ * @param config service configuration, current executable is used if 'binary_path' is empty
+ */
+void install_service(const service_config& config);
 
 /**
  * Uninstalls Windows Service by name
@@ -54,6 +75,28 @@ void install_service(const std::string& service_name, const std::string& display
 
 void uninstall_service(const std::string& service_name);
 
+/**
+ * Stops the service hosted in this process from inside of the service,
+ * e.g. when in-process recovery of the failed subsystem is not possible,
+ * stop callback is called the same way as on 'STOP' control
+ *
+ * @param service_name service name
+ * @param service_specific_exit_code exit code reported to SCM with
+ *        'exit_code_service_specific', '0' for normal stop
+ * @throws winservice_exception if service is not running in this process
+ */
+void request_service_stop(const std::string& service_name, uint32_t service_specific_exit_code = 0);
+
+/**
+ * Installs the service or changes its configuration in place,
+ * only the fields that differ from the desired ones are changed,
+ * see 'scm_session::reconcile_service'
+ *
+ * @param desired desired configuration
+ * @return applied changes
+ */
+reconcile_result reconcile_service(const service_config& desired);
+
 /**
  * Starts specified service
  *
@@ -68,9 +111,66 @@ void start_service(const std::string& service_name);
 */
 void stop_service(const std::string& service_name);
 
+/**
+ * Starts specified service and waits for it to become 'RUNNING' on a separate thread,
+ * waiting is driven by the status change notifications from SCM
+ *
+ * @param service_name service name
+ * @param timeout_millis max time to wait for the 'RUNNING' state
+ * @return future that will contain the service status, or the exception
+ *         with last reported checkpoint and wait hint on timeout
+ * @throws winservice_exception if start request is rejected by SCM
+ */
+std::future<service_status> start_service_async(const std::string& service_name,
+        uint32_t timeout_millis = 30000);
+
+/**
+ * Starts specified service and calls specified callback on a separate thread
+ * when the service becomes 'RUNNING' or when the timeout expires
+ *
+ * @param service_name service name
+ * @param timeout_millis max time to wait for the 'RUNNING' state
+ * @param callback completion callback, receives last observed status and an error message,
+ *        error is empty if the service reached 'RUNNING' state
+ *        must not throw, exceptions thrown from it are ignored
+ * @throws winservice_exception if start request is rejected by SCM
+ */
+void start_service_async(const std::string& service_name, uint32_t timeout_millis,
+        std::function<void(const service_status&, const std::string&)> callback);
+
+/**
+ * Sends 'SERVICE_CONTROL_STOP' signal to specified service and waits for
+ * it to become 'STOPPED' on a separate thread, waiting is driven by the
+ * status change notifications from SCM
+ *
+ * @param service_name service name
+ * @param timeout_millis max time to wait for the 'STOPPED' state
+ * @return future that will contain the service status, or the exception
+ *         with last reported checkpoint and wait hint on timeout
+ * @throws winservice_exception if stop request is rejected by SCM
+ */
+std::future<service_status> stop_service_async(const std::string& service_name,
+        uint32_t timeout_millis = 30000);
+
+/**
+ * Sends 'SERVICE_CONTROL_STOP' signal to specified service and calls specified callback
+ * on a separate thread when the service becomes 'STOPPED' or when the timeout expires
+ *
+ * @param service_name service name
+ * @param timeout_millis max time to wait for the 'STOPPED' state
+ * @param callback completion callback, receives last observed status and an error message,
+ *        error is empty if the service reached 'STOPPED' state
+ *        must not throw, exceptions thrown from it are ignored
+ * @throws winservice_exception if stop request is rejected by SCM
+ */
+void stop_service_async(const std::string& service_name, uint32_t timeout_millis,
+        std::function<void(const service_status&, const std::string&)> callback);
+
 /**
  * Entry point for the application called by Service Manager,
- * this call will block until the service will be stopped
+ * this call will block until the service will be stopped.
+ * Callbacks are called from a dedicated lifecycle thread, controls received
+ * while a callback is running are enqueued and redundant ones are coalesced.
  * 
  * @param service_name service name
  * @param starter start callback, will be called on 'START' and 'CONTINUE' events
@@ -80,6 +180,28 @@ void stop_service(const std::string& service_name);
 void start_service_and_wait(const std::string& service_name, std::function<void()> starter,
         std::function<void()> stopper, std::function<void(const std::string&)> logger);
 
+/**
+ * Entry point for the application called by Service Manager,
+ * this call will block until the service will be stopped.
+ * While start and stop callbacks are running, increasing checkpoints
+ * are published to SCM automatically, callbacks can also report their
+ * progress using the specified 'service_transition'.
+ *
+ * @param service_name service name
+ * @param lifecycle service callbacks and options
+ */
+void start_service_and_wait(const std::string& service_name, service_lifecycle lifecycle);
+
+/**
+ * Entry point for the application that hosts multiple services in the same process,
+ * services are expected to be installed with 'SERVICE_WIN32_SHARE_PROCESS' type.
+ * Each service gets its own lifecycle thread, this call will block until
+ * all the services will be stopped.
+ *
+ * @param services list of service names and their callbacks
+ */
+void start_services_and_wait(std::vector<std::pair<std::string, service_lifecycle>> services);
+
 } // namespace
 }
 
@@ -0,0 +1,65 @@
+/*
+ * Copyright 2026, alex at staticlibs.net
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * File:   posix_scm.hpp
+ * Author: alex
+ *
+ * Created on October 17, 2026, 10:15 AM
+ */
+
+#ifndef STATICLIB_WINSERVICE_POSIX_SCM_HPP
+#define STATICLIB_WINSERVICE_POSIX_SCM_HPP
+
+#include "staticlib/config.hpp"
+
+#ifndef STATICLIB_WINDOWS
+
+#include "staticlib/winservice/scm_backend.hpp"
+
+namespace staticlib {
+namespace winservice {
+
+/**
+ * Daemon backend for POSIX systems, used by default on non-Windows platforms.
+ * Signals are mapped to controls: 'SIGTERM' and 'SIGINT' to 'STOP', 'SIGTSTP' to 'PAUSE',
+ * 'SIGCONT' to 'CONTINUE' and 'SIGHUP' to 'PARAMCHANGE'. Signal handlers only write the signal number into
+ * a self-pipe, controls are delivered from the dispatcher thread, so service
+ * callbacks never run in signal context. Status changes are reported to the
+ * service manager over 'NOTIFY_SOCKET' when it is set ('READY=1', 'STOPPING=1',
+ * 'EXTEND_TIMEOUT_USEC' on checkpoints and periodic 'WATCHDOG=1').
+ * Installing and starting services is left to the init system, 'connect()'
+ * is not supported.
+ */
+class posix_scm : public scm_backend {
+public:
+    virtual std::unique_ptr<scm_connection> connect() override;
+
+    virtual void run_dispatcher(const std::vector<std::string>& service_names,
+            std::function<void(const std::string&)> service_main) override;
+
+    virtual void register_control_handler(const std::string& service_name,
+            std::function<bool(uint32_t, uint32_t, uint32_t)> handler) override;
+
+    virtual void set_service_status(const std::string& service_name, const service_status& status) override;
+};
+
+} // namespace
+}
+
+#endif // !STATICLIB_WINDOWS
+
+#endif /* STATICLIB_WINSERVICE_POSIX_SCM_HPP */
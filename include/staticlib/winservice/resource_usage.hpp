@@ -0,0 +1,97 @@
+/*
+ * Copyright 2026, alex at staticlibs.net
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * File:   resource_usage.hpp
+ * Author: alex
+ *
+ * Created on October 17, 2026, 10:10 AM
+ */
+
+#ifndef STATICLIB_WINSERVICE_RESOURCE_USAGE_HPP
+#define STATICLIB_WINSERVICE_RESOURCE_USAGE_HPP
+
+#include <cstdint>
+#include <string>
+
+namespace staticlib {
+namespace winservice {
+
+/**
+ * Resources used by the current process, either a sample or a difference
+ * between two samples, counters not available on the platform are '0'
+ */
+struct resource_usage {
+    /**
+     * CPU time spent in user mode
+     */
+    int64_t cpu_user_micros = 0;
+    /**
+     * CPU time spent in kernel mode
+     */
+    int64_t cpu_system_micros = 0;
+    /**
+     * Resident set (working set) size
+     */
+    int64_t resident_bytes = 0;
+    /**
+     * Peak resident set (working set) size since the process start,
+     * in a difference: growth of the peak between the samples
+     */
+    int64_t peak_resident_bytes = 0;
+    /**
+     * Number of page faults, includes soft faults on Windows
+     */
+    int64_t page_faults = 0;
+    /**
+     * Number of page faults that required I/O, not available on Windows
+     */
+    int64_t major_page_faults = 0;
+    /**
+     * Number of open file descriptors on POSIX, open handles on Windows
+     */
+    int64_t open_handles = 0;
+};
+
+/**
+ * Samples resources used by the current process, uses 'getrusage'
+ * and '/proc/self' on POSIX, process information API on Windows
+ *
+ * @return resource usage sample
+ */
+resource_usage sample_resource_usage();
+
+/**
+ * Computes difference between two samples
+ *
+ * @param before earlier sample
+ * @param after later sample
+ * @return difference, may contain negative values, e.g. when handles were closed
+ */
+resource_usage resource_usage_delta(const resource_usage& before, const resource_usage& after);
+
+/**
+ * Formats resource usage into a log message
+ *
+ * @param usage resource usage sample or difference
+ * @return log message
+ */
+std::string format_resource_usage(const resource_usage& usage);
+
+} // namespace
+}
+
+#endif /* STATICLIB_WINSERVICE_RESOURCE_USAGE_HPP */
@@ -0,0 +1,211 @@
+/*
+ * Copyright 2026, alex at staticlibs.net
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * File:   scm_backend.hpp
+ * Author: alex
+ *
+ * Created on October 17, 2026, 10:20 AM
+ */
+
+#ifndef STATICLIB_WINSERVICE_SCM_BACKEND_HPP
+#define STATICLIB_WINSERVICE_SCM_BACKEND_HPP
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "staticlib/winservice/service_status.hpp"
+#include "staticlib/winservice/winservice_exception.hpp"
+
+namespace staticlib {
+namespace winservice {
+
+/**
+ * Connection to Service Control Manager, used for
+ * managing services from outside of the service process.
+ * Implementations may cache opened handles and must allow
+ * methods to be called from multiple threads concurrently.
+ * All methods throw 'winservice_exception' on error.
+ */
+class scm_connection {
+public:
+    /**
+     * Virtual destructor
+     */
+    virtual ~scm_connection() { }
+
+    /**
+     * Creates new service
+     *
+     * @param config service configuration
+     */
+    virtual void install_service(const service_config& config) = 0;
+
+    /**
+     * Deletes specified service
+     *
+     * @param service_name service name
+     */
+    virtual void uninstall_service(const std::string& service_name) = 0;
+
+    /**
+     * Requests the start of the specified service,
+     * returns without waiting for the service to start
+     *
+     * @param service_name service name
+     */
+    virtual void start_service(const std::string& service_name) = 0;
+
+    /**
+     * Sends control code to the specified service
+     *
+     * @param service_name service name
+     * @param control control code
+     * @return latest status reported by the service
+     */
+    virtual service_status control_service(const std::string& service_name, uint32_t control) = 0;
+
+    /**
+     * Queries current status of the specified service
+     *
+     * @param service_name service name
+     * @return current status
+     */
+    virtual service_status query_service_status(const std::string& service_name) = 0;
+
+    /**
+     * Lists all installed services with their current status and process ID,
+     * obtained from SCM in a single call, configuration is not filled
+     *
+     * @return services sorted by name
+     */
+    virtual std::vector<service_entry> enumerate_services() = 0;
+
+    /**
+     * Checks whether the specified service is installed
+     *
+     * @param service_name service name
+     * @return true if service exists
+     */
+    virtual bool is_service_installed(const std::string& service_name) = 0;
+
+    /**
+     * Queries current configuration of the specified service,
+     * password is not returned
+     *
+     * @param service_name service name
+     * @return current configuration
+     */
+    virtual service_config query_service_config(const std::string& service_name) = 0;
+
+    /**
+     * Changes configuration of the installed service in place,
+     * service does not need to be stopped
+     *
+     * @param config service configuration
+     * @param fields combination of 'config_*' flags, only specified fields are changed
+     */
+    virtual void change_service_config(const service_config& config, uint32_t fields) = 0;
+
+    /**
+     * Waits until the specified service reaches specified state,
+     * waiting is driven by the status change notifications from SCM.
+     * Returns early if the service is stopped while waiting for other state.
+     *
+     * @param service_name service name
+     * @param state state to wait for
+     * @param timeout_millis max time to wait
+     * @return last observed status, caller should check whether the state was reached
+     */
+    virtual service_status wait_for_status(const std::string& service_name, uint32_t state,
+            uint32_t timeout_millis) = 0;
+};
+
+/**
+ * Service Control Manager implementation used by all the operations of this library,
+ * 'connect()' is used from management code, other methods are used from
+ * inside of the service process
+ */
+class scm_backend {
+public:
+    /**
+     * Virtual destructor
+     */
+    virtual ~scm_backend() { }
+
+    /**
+     * Opens a new connection to SCM
+     *
+     * @return connection instance
+     */
+    virtual std::unique_ptr<scm_connection> connect() = 0;
+
+    /**
+     * Connects calling thread to SCM as a service control dispatcher,
+     * 'service_main' is called (on a separate thread) for each service
+     * started by SCM, this call blocks until all the services are stopped
+     *
+     * @param service_names names of the services hosted in this process
+     * @param service_main entry point called with the name of the started service
+     */
+    virtual void run_dispatcher(const std::vector<std::string>& service_names,
+            std::function<void(const std::string&)> service_main) = 0;
+
+    /**
+     * Registers control handler for the specified service,
+     * must be called from 'service_main'
+     *
+     * @param service_name service name
+     * @param handler handler that will be called on the dispatcher thread with the control code,
+     *        event type (for power and session events) and event data (session ID for session events),
+     *        returns false if the control is not handled by the service
+     */
+    virtual void register_control_handler(const std::string& service_name,
+            std::function<bool(uint32_t, uint32_t, uint32_t)> handler) = 0;
+
+    /**
+     * Reports service status to SCM
+     *
+     * @param service_name service name
+     * @param status current service status
+     */
+    virtual void set_service_status(const std::string& service_name, const service_status& status) = 0;
+};
+
+/**
+ * Sets SCM backend used by the operations of this library,
+ * by default native SCM is used on Windows, and signal-driven
+ * daemon backend is used on other platforms
+ *
+ * @param backend backend to use, 'nullptr' to reset to default one
+ */
+void set_scm_backend(std::shared_ptr<scm_backend> backend);
+
+/**
+ * Returns SCM backend used by the operations of this library
+ *
+ * @return current backend
+ * @throws winservice_exception if no backend is available
+ */
+std::shared_ptr<scm_backend> get_scm_backend();
+
+} // namespace
+}
+
+#endif /* STATICLIB_WINSERVICE_SCM_BACKEND_HPP */
+
@@ -0,0 +1,196 @@
+/*
+ * Copyright 2026, alex at staticlibs.net
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * File:   scm_session.hpp
+ * Author: alex
+ *
+ * Created on October 17, 2026, 9:30 AM
+ */
+
+#ifndef STATICLIB_WINSERVICE_SCM_SESSION_HPP
+#define STATICLIB_WINSERVICE_SCM_SESSION_HPP
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "staticlib/winservice/scm_backend.hpp"
+
+namespace staticlib {
+namespace winservice {
+
+/**
+ * Result of the operation on a single service in a batch
+ */
+struct service_operation_result {
+    /**
+     * Service name
+     */
+    std::string service_name;
+    /**
+     * Whether operation succeeded
+     */
+    bool success = false;
+    /**
+     * Error message if operation failed
+     */
+    std::string error;
+};
+
+/**
+ * Result of reconciling the service with the desired configuration
+ */
+struct reconcile_result {
+    /**
+     * Service name
+     */
+    std::string service_name;
+    /**
+     * Whether service was not installed and was created
+     */
+    bool installed = false;
+    /**
+     * Combination of 'config_*' flags for the fields changed in place,
+     * '0' if the service already had the desired configuration
+     */
+    uint32_t changed_fields = 0;
+};
+
+/**
+ * Reusable SCM connection, keeps SCM and service handles opened
+ * between the calls, can be used from multiple threads
+ */
+class scm_session {
+    std::shared_ptr<scm_backend> backend;
+    std::shared_ptr<scm_connection> connection;
+    uint32_t max_concurrency;
+
+public:
+    /**
+     * Constructor, opens connection using the current SCM backend
+     *
+     * @param max_concurrency max number of services processed concurrently in batch operations
+     */
+    scm_session(uint32_t max_concurrency = 16);
+
+    /**
+     * Constructor, opens connection using the specified SCM backend
+     *
+     * @param backend SCM backend
+     * @param max_concurrency max number of services processed concurrently in batch operations
+     */
+    scm_session(std::shared_ptr<scm_backend> backend, uint32_t max_concurrency = 16);
+
+    /**
+     * Installs service
+     *
+     * @param config service configuration
+     */
+    void install_service(const service_config& config);
+
+    /**
+     * Brings service configuration to the desired one: installs the service
+     * if it does not exist, otherwise applies only the fields that differ
+     * from the ones reported by SCM in place, without stopping the service.
+     * Empty 'display_name', 'binary_path' and 'account' keep current values,
+     * password is only applied when the account is changed.
+     *
+     * @param desired desired configuration
+     * @return applied changes
+     */
+    reconcile_result reconcile_service(const service_config& desired);
+
+    /**
+     * Uninstalls service, service must be stopped
+     *
+     * @param service_name service name
+     */
+    void uninstall_service(const std::string& service_name);
+
+    /**
+     * Starts specified service
+     *
+     * @param service_name service name
+     */
+    void start_service(const std::string& service_name);
+
+    /**
+     * Sends 'SERVICE_CONTROL_STOP' signal to specified service
+     *
+     * @param service_name service name
+     */
+    void stop_service(const std::string& service_name);
+
+    /**
+     * Sends control code to specified service
+     *
+     * @param service_name service name
+     * @param control control code
+     * @return latest status reported by the service
+     */
+    service_status control_service(const std::string& service_name, uint32_t control);
+
+    /**
+     * Queries current status of the specified service
+     *
+     * @param service_name service name
+     * @return current status
+     */
+    service_status query_service_status(const std::string& service_name);
+
+    /**
+     * Starts specified services concurrently, does not throw on failures
+     *
+     * @param service_names service names
+     * @return results in the same order as specified names
+     */
+    std::vector<service_operation_result> start_services(const std::vector<std::string>& service_names);
+
+    /**
+     * Stops specified services concurrently, does not throw on failures
+     *
+     * @param service_names service names
+     * @return results in the same order as specified names
+     */
+    std::vector<service_operation_result> stop_services(const std::vector<std::string>& service_names);
+
+    /**
+     * Uninstalls specified services concurrently, does not throw on failures
+     *
+     * @param service_names service names
+     * @return results in the same order as specified names
+     */
+    std::vector<service_operation_result> uninstall_services(const std::vector<std::string>& service_names);
+
+    /**
+     * Underlying connection
+     *
+     * @return connection
+     */
+    scm_connection& get_connection();
+
+private:
+    std::vector<service_operation_result> run_batch(const std::vector<std::string>& service_names,
+            std::function<void(const std::string&)> operation);
+};
+
+} // namespace
+}
+
+#endif /* STATICLIB_WINSERVICE_SCM_SESSION_HPP */
@@ -0,0 +1,167 @@
+/*
+ * Copyright 2026, alex at staticlibs.net
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * File:   service_event_bus.hpp
+ * Author: alex
+ *
+ * Created on October 17, 2026, 10:15 AM
+ */
+
+#ifndef STATICLIB_WINSERVICE_SERVICE_EVENT_BUS_HPP
+#define STATICLIB_WINSERVICE_SERVICE_EVENT_BUS_HPP
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+
+#include "staticlib/winservice/service_status.hpp"
+
+namespace staticlib {
+namespace winservice {
+
+// power event types, values match Win32 'PBT_*' constants
+const uint32_t power_suspend = 0x4;
+const uint32_t power_resume_suspend = 0x7;
+const uint32_t power_status_change = 0xa;
+const uint32_t power_resume_automatic = 0x12;
+const uint32_t power_setting_change = 0x8013;
+
+// session change types, values match Win32 'WTS_*' constants
+const uint32_t session_console_connect = 0x1;
+const uint32_t session_console_disconnect = 0x2;
+const uint32_t session_remote_connect = 0x3;
+const uint32_t session_remote_disconnect = 0x4;
+const uint32_t session_logon = 0x5;
+const uint32_t session_logoff = 0x6;
+const uint32_t session_lock = 0x7;
+const uint32_t session_unlock = 0x8;
+const uint32_t session_remote_control = 0x9;
+const uint32_t session_create = 0xa;
+const uint32_t session_terminate = 0xb;
+
+/**
+ * Control received by the service that does not change its state
+ */
+struct service_event {
+    /**
+     * Name of the service that received the control
+     */
+    std::string service_name;
+    /**
+     * Control code: 'control_paramchange', 'control_power_event',
+     * 'control_session_change' or user-defined code from '128' to '255'
+     */
+    uint32_t control = 0;
+    /**
+     * Event type, 'power_*' or 'session_*' constant, '0' for other controls
+     */
+    uint32_t event_type = 0;
+    /**
+     * ID of the session for session change events
+     */
+    uint32_t session_id = 0;
+};
+
+/**
+ * Delivers controls that do not change the service state to subscribers.
+ * Events are enqueued by the control handler and subscribers are called
+ * on the bus thread, so slow subscribers (e.g. configuration reload on
+ * 'PARAMCHANGE') do not block the dispatcher.
+ */
+class service_event_bus {
+    class impl;
+    std::shared_ptr<impl> pimpl;
+
+public:
+    /**
+     * Constructor, starts the bus thread
+     */
+    service_event_bus();
+
+    /**
+     * Destructor, delivers enqueued events and stops the bus thread
+     */
+    ~service_event_bus();
+
+    service_event_bus(const service_event_bus&) = delete;
+
+    service_event_bus& operator=(const service_event_bus&) = delete;
+
+    /**
+     * Subscribes to 'PARAMCHANGE' control, service is expected
+     * to reload its configuration in place
+     *
+     * @param subscriber subscriber
+     * @return subscription ID
+     */
+    uint64_t on_param_change(std::function<void(const service_event&)> subscriber);
+
+    /**
+     * Subscribes to user-defined controls ('128' to '255')
+     *
+     * @param subscriber subscriber
+     * @return subscription ID
+     */
+    uint64_t on_user_control(std::function<void(const service_event&)> subscriber);
+
+    /**
+     * Subscribes to power events
+     *
+     * @param subscriber subscriber
+     * @return subscription ID
+     */
+    uint64_t on_power_event(std::function<void(const service_event&)> subscriber);
+
+    /**
+     * Subscribes to session change events
+     *
+     * @param subscriber subscriber
+     * @return subscription ID
+     */
+    uint64_t on_session_change(std::function<void(const service_event&)> subscriber);
+
+    /**
+     * Removes subscription, subscriber may still be called once
+     * if the event is already being delivered
+     *
+     * @param subscription_id subscription ID
+     */
+    void unsubscribe(uint64_t subscription_id);
+
+    /**
+     * Controls that should be reported as accepted to SCM,
+     * depends on the subscriptions made before the service is started
+     *
+     * @return combination of 'accept_*' flags
+     */
+    uint32_t accepted_controls() const;
+
+    /**
+     * Enqueues the event, returns without waiting for subscribers,
+     * exceptions thrown by subscribers are ignored
+     *
+     * @param event event to deliver
+     * @return true if the event has subscribers and was enqueued
+     */
+    bool publish(const service_event& event);
+};
+
+} // namespace
+}
+
+#endif /* STATICLIB_WINSERVICE_SERVICE_EVENT_BUS_HPP */
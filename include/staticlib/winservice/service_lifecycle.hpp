@@ -0,0 +1,107 @@
+/*
+ * Copyright 2026, alex at staticlibs.net
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * File:   service_lifecycle.hpp
+ * Author: alex
+ *
+ * Created on October 17, 2026, 2:40 PM
+ */
+
+#ifndef STATICLIB_WINSERVICE_SERVICE_LIFECYCLE_HPP
+#define STATICLIB_WINSERVICE_SERVICE_LIFECYCLE_HPP
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+
+#include "staticlib/winservice/lifecycle_events.hpp"
+#include "staticlib/winservice/service_event_bus.hpp"
+#include "staticlib/winservice/service_transition.hpp"
+
+namespace staticlib {
+namespace winservice {
+
+/**
+ * Callbacks and options of the service run by 'start_service_and_wait'
+ */
+struct service_lifecycle {
+    /**
+     * Start callback, will be called on 'START' and 'CONTINUE' events
+     */
+    std::function<void(service_transition&)> starter;
+    /**
+     * Stop callback, will be called on 'STOP', 'PAUSE', 'SHUTDOWN' and 'PRESHUTDOWN' events,
+     * 'service_transition' specifies the reason, the deadline and the cancellation token
+     */
+    std::function<void(service_transition&)> stopper;
+    /**
+     * Optional pause callback, will be called on 'PAUSE' event instead of 'stopper',
+     * allows to quiesce the service without tearing it down
+     */
+    std::function<void(service_transition&)> pauser;
+    /**
+     * Optional resume callback, will be called on 'CONTINUE' event instead of 'starter'
+     */
+    std::function<void(service_transition&)> resumer;
+    /**
+     * Logger callback
+     */
+    std::function<void(const std::string&)> logger;
+    /**
+     * Optional structured event sink, lifecycle errors are published
+     * into it without allocating memory, if not set, events are formatted
+     * and passed to 'logger' from a separate thread
+     */
+    std::shared_ptr<lifecycle_event_channel> events;
+    /**
+     * Optional bus for the controls that do not change service state: 'PARAMCHANGE',
+     * power and session events and user-defined controls, only the controls
+     * subscribed to before the start are accepted
+     */
+    std::shared_ptr<service_event_bus> event_bus;
+    /**
+     * Wait hint reported to SCM with the checkpoints of pending states
+     */
+    uint32_t wait_hint_millis = 30000;
+    /**
+     * Interval for publishing checkpoints automatically while start
+     * and stop callbacks are running, '0' disables the heartbeat
+     */
+    uint32_t heartbeat_interval_millis = 1000;
+    /**
+     * Time budget of the stopper on 'SHUTDOWN', OS does not wait for services longer than that
+     */
+    uint32_t shutdown_timeout_millis = 5000;
+    /**
+     * If non-zero, 'PRESHUTDOWN' is accepted and the stopper gets this time budget
+     * on system shutdown, service should be installed with the same
+     * 'service_config::preshutdown_timeout_millis'
+     */
+    uint32_t preshutdown_timeout_millis = 0;
+    /**
+     * Whether to sample process resources (CPU time, memory, page faults, open handles)
+     * before and after each transition, differences are available in 'service_metrics'
+     * and are reported to the 'logger'
+     */
+    bool resource_accounting = true;
+};
+
+} // namespace
+}
+
+#endif /* STATICLIB_WINSERVICE_SERVICE_LIFECYCLE_HPP */
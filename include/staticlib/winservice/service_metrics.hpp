@@ -0,0 +1,162 @@
+/*
+ * Copyright 2026, alex at staticlibs.net
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * File:   service_metrics.hpp
+ * Author: alex
+ *
+ * Created on October 17, 2026, 11:05 AM
+ */
+
+#ifndef STATICLIB_WINSERVICE_SERVICE_METRICS_HPP
+#define STATICLIB_WINSERVICE_SERVICE_METRICS_HPP
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "staticlib/winservice/resource_usage.hpp"
+
+namespace staticlib {
+namespace winservice {
+
+/**
+ * Snapshot of the latency histogram with fixed buckets
+ */
+struct latency_histogram {
+    /**
+     * Inclusive upper bounds of the buckets in milliseconds
+     */
+    std::vector<uint64_t> bounds_millis;
+    /**
+     * Number of recorded values in each bucket, contains one more
+     * element than 'bounds_millis' for the values above the last bound
+     */
+    std::vector<uint64_t> counts;
+    /**
+     * Number of recorded values
+     */
+    uint64_t count = 0;
+    /**
+     * Sum of recorded values in milliseconds
+     */
+    uint64_t sum_millis = 0;
+    /**
+     * Max recorded value in milliseconds
+     */
+    uint64_t max_millis = 0;
+
+    /**
+     * Estimates the specified percentile as the upper bound
+     * of the bucket that contains it
+     *
+     * @param fraction percentile as a fraction, e.g. '0.99'
+     * @return percentile in milliseconds, '0' if no values were recorded
+     */
+    uint64_t percentile_millis(double fraction) const;
+};
+
+/**
+ * Counters of the single kind of the state transition
+ */
+struct transition_metrics {
+    /**
+     * Number of transitions completed successfully
+     */
+    uint64_t succeeded = 0;
+    /**
+     * Number of transitions failed with an error
+     */
+    uint64_t failed = 0;
+    /**
+     * Time spent from the pending state to the target state
+     */
+    latency_histogram latency;
+    /**
+     * Resources used by the process during the last transition,
+     * zero if resource accounting is disabled in 'service_lifecycle'
+     */
+    resource_usage last_resources;
+};
+
+/**
+ * Lifecycle metrics of the service hosted in this process,
+ * collected from the start of the process
+ */
+struct service_metrics {
+    /**
+     * Service name
+     */
+    std::string service_name;
+    /**
+     * 'START_PENDING' to 'RUNNING'
+     */
+    transition_metrics start;
+    /**
+     * 'STOP_PENDING' to 'STOPPED', includes the stops on 'SHUTDOWN'
+     */
+    transition_metrics stop;
+    /**
+     * 'PAUSE_PENDING' to 'PAUSED'
+     */
+    transition_metrics pause;
+    /**
+     * 'CONTINUE_PENDING' to 'RUNNING'
+     */
+    transition_metrics resume;
+    /**
+     * Number of controls received by the control handler
+     */
+    uint64_t controls_received = 0;
+    /**
+     * Number of received controls that are not supported by the service
+     */
+    uint64_t controls_ignored = 0;
+    /**
+     * Number of statuses reported to SCM, including the checkpoints
+     */
+    uint64_t status_updates = 0;
+    /**
+     * Number of failed status reports
+     */
+    uint64_t status_update_failures = 0;
+};
+
+/**
+ * Returns the snapshot of lifecycle metrics of the specified service,
+ * metrics are kept after the service is stopped
+ *
+ * @param service_name service name
+ * @return metrics snapshot, all counters are zero if the service was never run
+ */
+service_metrics get_service_metrics(const std::string& service_name);
+
+/**
+ * Returns the snapshot of lifecycle metrics of all the services run in this process
+ *
+ * @return metrics snapshots ordered by service name
+ */
+std::vector<service_metrics> get_all_service_metrics();
+
+/**
+ * Resets lifecycle metrics of all the services
+ */
+void reset_service_metrics();
+
+} // namespace
+}
+
+#endif /* STATICLIB_WINSERVICE_SERVICE_METRICS_HPP */
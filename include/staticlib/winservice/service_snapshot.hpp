@@ -0,0 +1,125 @@
+/*
+ * Copyright 2026, alex at staticlibs.net
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * File:   service_snapshot.hpp
+ * Author: alex
+ *
+ * Created on October 17, 2026, 9:50 AM
+ */
+
+#ifndef STATICLIB_WINSERVICE_SERVICE_SNAPSHOT_HPP
+#define STATICLIB_WINSERVICE_SERVICE_SNAPSHOT_HPP
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "staticlib/winservice/scm_backend.hpp"
+#include "staticlib/winservice/service_status.hpp"
+
+namespace staticlib {
+namespace winservice {
+
+// kinds of changes between snapshots
+const uint32_t change_added = 0x1;
+const uint32_t change_removed = 0x2;
+const uint32_t change_state = 0x4;
+const uint32_t change_process = 0x8;
+const uint32_t change_exit_code = 0x10;
+const uint32_t change_config = 0x20;
+
+/**
+ * Change of a single service since the previous snapshot
+ */
+struct service_change {
+    /**
+     * Service name
+     */
+    std::string service_name;
+    /**
+     * Combination of 'change_*' flags
+     */
+    uint32_t changes = 0;
+    /**
+     * Status in the previous snapshot, default one for added services
+     */
+    service_status previous;
+    /**
+     * Status in the current snapshot, default one for removed services
+     */
+    service_status current;
+};
+
+/**
+ * Statuses of all (or the specified) services, refreshed with a single
+ * enumeration call, changes since the previous refresh are reported.
+ * Checkpoint and wait hint updates are not reported as changes.
+ * Not thread-safe, each polling thread should use its own snapshot.
+ */
+class service_snapshot {
+    std::vector<std::string> names_filter;
+    bool include_config;
+    std::vector<service_entry> entries;
+    uint64_t version = 0;
+
+public:
+    /**
+     * Constructor, snapshot is empty until the first refresh
+     *
+     * @param service_names services to include, all services are included if empty
+     * @param include_config whether to query configuration of each service, requires
+     *        a call per service, handles are cached by the connection between refreshes
+     */
+    service_snapshot(std::vector<std::string> service_names = std::vector<std::string>(),
+            bool include_config = false);
+
+    /**
+     * Queries current statuses and replaces the contents of this snapshot
+     *
+     * @param connection SCM connection, e.g. 'scm_session::get_connection()'
+     * @return changes since the previous refresh, all services are reported
+     *         as added on the first refresh
+     */
+    std::vector<service_change> refresh(scm_connection& connection);
+
+    /**
+     * Services in this snapshot
+     *
+     * @return entries sorted by name
+     */
+    const std::vector<service_entry>& get_entries() const;
+
+    /**
+     * Looks up the service by name
+     *
+     * @param service_name service name
+     * @return entry, 'nullptr' if service is not in this snapshot
+     */
+    const service_entry* find(const std::string& service_name) const;
+
+    /**
+     * Number of refreshes done
+     *
+     * @return snapshot version, '0' before the first refresh
+     */
+    uint64_t get_version() const;
+};
+
+} // namespace
+}
+
+#endif /* STATICLIB_WINSERVICE_SERVICE_SNAPSHOT_HPP */
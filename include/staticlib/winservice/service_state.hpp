@@ -0,0 +1,148 @@
+/*
+ * Copyright 2026, alex at staticlibs.net
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * File:   service_state.hpp
+ * Author: alex
+ *
+ * Created on October 17, 2026, 1:10 PM
+ */
+
+#ifndef STATICLIB_WINSERVICE_SERVICE_STATE_HPP
+#define STATICLIB_WINSERVICE_SERVICE_STATE_HPP
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+
+#include "staticlib/winservice/service_status.hpp"
+
+namespace staticlib {
+namespace winservice {
+
+/**
+ * Consistent copy of the state last reported by the service hosted in this process
+ */
+struct service_state_snapshot {
+    /**
+     * Current state, 'state_stopped' if the service was never started
+     */
+    uint32_t current_state = state_stopped;
+    /**
+     * Checkpoint of the pending state
+     */
+    uint32_t check_point = 0;
+    /**
+     * Win32 exit code reported with the state
+     */
+    uint32_t win32_exit_code = 0;
+    /**
+     * Time when the service entered current state, milliseconds since epoch
+     */
+    uint64_t transition_time_millis = 0;
+    /**
+     * Incremented on each published status, '0' if no status was published yet
+     */
+    uint64_t version = 0;
+};
+
+/**
+ * Read-only view on the state of the service hosted in this process,
+ * intended for application threads (health checks, request handlers).
+ * Reads do not take locks and never contend with lifecycle callbacks.
+ */
+class service_state_view {
+    class impl;
+    std::shared_ptr<impl> pimpl;
+
+public:
+    /**
+     * Constructor, view is valid before the service is started and after it is stopped
+     *
+     * @param service_name service name
+     */
+    explicit service_state_view(const std::string& service_name);
+
+    /**
+     * Current state, single atomic load
+     *
+     * @return current state
+     */
+    uint32_t current_state() const;
+
+    /**
+     * Checks whether service is 'RUNNING', single atomic load
+     *
+     * @return true if service is running
+     */
+    bool is_running() const;
+
+    /**
+     * Checks whether service is stopping or stopped, intended for
+     * "are we draining?" checks, single atomic load
+     *
+     * @return true if service is in 'STOP_PENDING' or 'STOPPED' state
+     */
+    bool is_stopping() const;
+
+    /**
+     * Consistent snapshot of all the state fields, does not take locks
+     *
+     * @return state snapshot
+     */
+    service_state_snapshot snapshot() const;
+
+    /**
+     * Waits until the service reaches specified state
+     *
+     * @param state state to wait for
+     * @param timeout_millis max time to wait
+     * @return latest snapshot, caller should check whether the state was reached
+     */
+    service_state_snapshot wait_for_state(uint32_t state, uint32_t timeout_millis) const;
+
+    /**
+     * Waits until the status newer than the specified version is published
+     *
+     * @param version version of the previously seen snapshot
+     * @param timeout_millis max time to wait
+     * @return latest snapshot
+     */
+    service_state_snapshot wait_for_change(uint64_t version, uint32_t timeout_millis) const;
+
+    /**
+     * Registers the listener called on each change of the state (checkpoints
+     * are not reported), listener is called from the lifecycle thread and must not block,
+     * exceptions thrown from the listener are ignored
+     *
+     * @param listener state change listener
+     * @return subscription id
+     */
+    uint64_t subscribe(std::function<void(const service_state_snapshot&)> listener);
+
+    /**
+     * Removes previously registered listener
+     *
+     * @param subscription_id id returned from 'subscribe'
+     */
+    void unsubscribe(uint64_t subscription_id);
+};
+
+} // namespace
+}
+
+#endif /* STATICLIB_WINSERVICE_SERVICE_STATE_HPP */
@@ -0,0 +1,343 @@
+/*
+ * Copyright 2026, alex at staticlibs.net
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * File:   service_status.hpp
+ * Author: alex
+ *
+ * Created on October 17, 2026, 10:12 AM
+ */
+
+#ifndef STATICLIB_WINSERVICE_SERVICE_STATUS_HPP
+#define STATICLIB_WINSERVICE_SERVICE_STATUS_HPP
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace staticlib {
+namespace winservice {
+
+// Values below match the corresponding Win32 constants,
+// so they can be passed to and from SCM API unchanged
+
+// service types
+const uint32_t service_type_own_process = 0x10;
+const uint32_t service_type_share_process = 0x20;
+
+// start types
+const uint32_t start_type_boot = 0x0;
+const uint32_t start_type_system = 0x1;
+const uint32_t start_type_auto = 0x2;
+const uint32_t start_type_demand = 0x3;
+const uint32_t start_type_disabled = 0x4;
+
+// service states
+const uint32_t state_stopped = 0x1;
+const uint32_t state_start_pending = 0x2;
+const uint32_t state_stop_pending = 0x3;
+const uint32_t state_running = 0x4;
+const uint32_t state_continue_pending = 0x5;
+const uint32_t state_pause_pending = 0x6;
+const uint32_t state_paused = 0x7;
+
+// control codes
+const uint32_t control_stop = 0x1;
+const uint32_t control_pause = 0x2;
+const uint32_t control_continue = 0x3;
+const uint32_t control_interrogate = 0x4;
+const uint32_t control_shutdown = 0x5;
+const uint32_t control_paramchange = 0x6;
+const uint32_t control_power_event = 0xd;
+const uint32_t control_session_change = 0xe;
+const uint32_t control_preshutdown = 0xf;
+// user-defined control codes
+const uint32_t control_user_min = 128;
+const uint32_t control_user_max = 255;
+
+// accepted controls flags
+const uint32_t accept_stop = 0x1;
+const uint32_t accept_pause_continue = 0x2;
+const uint32_t accept_shutdown = 0x4;
+const uint32_t accept_paramchange = 0x8;
+const uint32_t accept_power_event = 0x40;
+const uint32_t accept_session_change = 0x80;
+const uint32_t accept_preshutdown = 0x100;
+
+// Win32 exit code telling SCM to check 'service_specific_exit_code'
+const uint32_t exit_code_service_specific = 1066;
+
+// failure action types
+const uint32_t failure_action_none = 0x0;
+const uint32_t failure_action_restart = 0x1;
+const uint32_t failure_action_reboot = 0x2;
+const uint32_t failure_action_run_command = 0x3;
+
+// trigger types, values match Win32 'SERVICE_TRIGGER_TYPE_*' constants
+const uint32_t trigger_type_device_interface_arrival = 1;
+const uint32_t trigger_type_ip_address_availability = 2;
+const uint32_t trigger_type_domain_join = 3;
+const uint32_t trigger_type_firewall_port_event = 4;
+const uint32_t trigger_type_group_policy = 5;
+const uint32_t trigger_type_network_endpoint = 6;
+const uint32_t trigger_type_custom = 20;
+
+// trigger actions
+const uint32_t trigger_action_start = 1;
+const uint32_t trigger_action_stop = 2;
+
+// well-known trigger subtypes, GUIDs match Win32 '*_GUID' constants
+const char* const trigger_subtype_first_ip_address_arrival = "4f27f2de-14e2-430b-a549-7cd48cbc8245";
+const char* const trigger_subtype_last_ip_address_removal = "cc4ba62a-162e-4648-847a-b6bdf993e335";
+const char* const trigger_subtype_domain_join = "1ce20aba-9851-4421-9430-1ddeb766e809";
+const char* const trigger_subtype_domain_leave = "ddaf516e-58c2-4866-9574-c3b615d42ea1";
+const char* const trigger_subtype_firewall_port_open = "b7569e07-8421-4ee0-ad10-86915afdad09";
+const char* const trigger_subtype_firewall_port_close = "a144ed38-8e12-4de4-9d96-e64740b1a524";
+const char* const trigger_subtype_machine_policy_present = "659fcae6-5bdb-4da9-b1ff-ca2a178d46e0";
+const char* const trigger_subtype_user_policy_present = "54fb46c8-f089-464c-b1fd-59d1b62c3b50";
+
+// service configuration fields, used to report and apply config changes
+const uint32_t config_display_name = 0x1;
+const uint32_t config_binary_path = 0x2;
+const uint32_t config_account = 0x4;
+const uint32_t config_service_type = 0x8;
+const uint32_t config_start_type = 0x10;
+const uint32_t config_dependencies = 0x20;
+const uint32_t config_description = 0x40;
+const uint32_t config_failure_actions = 0x80;
+const uint32_t config_preshutdown_timeout = 0x100;
+const uint32_t config_load_order_group = 0x200;
+const uint32_t config_triggers = 0x400;
+
+/**
+ * Platform-neutral counterpart of Win32 'SERVICE_STATUS' structure
+ */
+struct service_status {
+    /**
+     * Service type, 'service_type_own_process' by default
+     */
+    uint32_t service_type = service_type_own_process;
+    /**
+     * Current state of the service
+     */
+    uint32_t current_state = state_stopped;
+    /**
+     * Control codes the service accepts
+     */
+    uint32_t controls_accepted = 0;
+    /**
+     * Win32 exit code
+     */
+    uint32_t win32_exit_code = 0;
+    /**
+     * Service-specific exit code
+     */
+    uint32_t service_specific_exit_code = 0;
+    /**
+     * Progress counter for lengthy operations
+     */
+    uint32_t check_point = 0;
+    /**
+     * Estimated time (in milliseconds) required for a pending operation
+     */
+    uint32_t wait_hint = 0;
+    /**
+     * ID of the service process, '0' if the service is not running
+     * or the status was reported without the process information
+     */
+    uint32_t process_id = 0;
+};
+
+/**
+ * Action taken by SCM when the service process terminates unexpectedly
+ */
+struct service_failure_action {
+    /**
+     * Action type, 'failure_action_restart' etc.
+     */
+    uint32_t type = failure_action_none;
+    /**
+     * Delay before performing the action
+     */
+    uint32_t delay_millis = 0;
+};
+
+/**
+ * Actions taken by SCM on the subsequent failures of the service
+ */
+struct service_failure_actions {
+    /**
+     * Time without failures after which the failure count is reset to zero
+     */
+    uint32_t reset_period_secs = 0;
+    /**
+     * Command line of the program run on 'failure_action_run_command'
+     */
+    std::string command;
+    /**
+     * Actions for the first, second etc. failures, the last one is
+     * used for all the subsequent failures, empty list means no actions
+     */
+    std::vector<service_failure_action> actions;
+};
+
+/**
+ * Event that starts or stops the service, allows to keep the service
+ * out of the boot sequence and to start it only when it is needed
+ */
+struct service_trigger {
+    /**
+     * Trigger type, 'trigger_type_*' constant
+     */
+    uint32_t type = trigger_type_custom;
+    /**
+     * Action taken when the event occurs
+     */
+    uint32_t action = trigger_action_start;
+    /**
+     * Event subtype GUID, 'trigger_subtype_*' constant, device interface class
+     * or ETW provider GUID, braces are optional
+     */
+    std::string subtype;
+    /**
+     * Trigger-specific string data, e.g. hardware IDs of the devices
+     * or "port;protocol" for firewall port events
+     */
+    std::vector<std::string> data;
+};
+
+/**
+ * Service configuration used for installing services
+ */
+struct service_config {
+    /**
+     * Service name
+     */
+    std::string name;
+    /**
+     * Service name in services list
+     */
+    std::string display_name;
+    /**
+     * Path to service executable
+     */
+    std::string binary_path;
+    /**
+     * Arguments passed to service executable
+     */
+    std::vector<std::string> arguments;
+    /**
+     * Service description shown in services list
+     */
+    std::string description;
+    /**
+     * Windows account name
+     */
+    std::string account;
+    /**
+     * Windows account password
+     */
+    std::string password;
+    /**
+     * Service type
+     */
+    uint32_t service_type = service_type_own_process;
+    /**
+     * Service start type
+     */
+    uint32_t start_type = start_type_auto;
+    /**
+     * Whether service with 'start_type_auto' is started shortly after other auto-start services
+     */
+    bool delayed_auto_start = false;
+    /**
+     * Names of the services this service depends on
+     */
+    std::vector<std::string> dependencies;
+    /**
+     * Load ordering group, services of the same group are started together
+     * in the order specified in the 'ServiceGroupOrder' registry key
+     */
+    std::string load_order_group;
+    /**
+     * Events that start or stop the service, usually combined with
+     * 'start_type_demand' to take the service off the boot critical path
+     */
+    std::vector<service_trigger> triggers;
+    /**
+     * Actions taken on service failures
+     */
+    service_failure_actions failure_actions;
+    /**
+     * Time SCM waits for the service on 'PRESHUTDOWN', '0' keeps the system default
+     */
+    uint32_t preshutdown_timeout_millis = 0;
+};
+
+/**
+ * Service listed by the enumeration of installed services
+ */
+struct service_entry {
+    /**
+     * Service name
+     */
+    std::string name;
+    /**
+     * Service name in services list
+     */
+    std::string display_name;
+    /**
+     * Current status including the process ID
+     */
+    service_status status;
+    /**
+     * Configuration, only filled if requested
+     */
+    service_config config;
+};
+
+/**
+ * Returns a name of the specified service state
+ *
+ * @param state service state
+ * @return state name, 'SERVICE_STOPPED' etc.
+ */
+std::string state_to_string(uint32_t state);
+
+/**
+ * Compares service configurations, empty 'display_name', 'binary_path'
+ * and 'account' and zero 'preshutdown_timeout_millis' of the desired config
+ * mean "keep current value", password cannot be queried and is not compared
+ *
+ * @param current configuration reported by SCM
+ * @param desired desired configuration
+ * @return combination of 'config_*' flags for the fields that differ
+ */
+uint32_t diff_service_config(const service_config& current, const service_config& desired);
+
+/**
+ * Returns names of the specified configuration fields
+ *
+ * @param fields combination of 'config_*' flags
+ * @return comma-separated field names, e.g. 'account, start_type'
+ */
+std::string config_fields_to_string(uint32_t fields);
+
+} // namespace
+}
+
+#endif /* STATICLIB_WINSERVICE_SERVICE_STATUS_HPP */
+
@@ -0,0 +1,153 @@
+/*
+ * Copyright 2026, alex at staticlibs.net
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * File:   service_supervisor.hpp
+ * Author: alex
+ *
+ * Created on October 17, 2026, 2:30 PM
+ */
+
+#ifndef STATICLIB_WINSERVICE_SERVICE_SUPERVISOR_HPP
+#define STATICLIB_WINSERVICE_SERVICE_SUPERVISOR_HPP
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+
+#include "staticlib/winservice/service_lifecycle.hpp"
+#include "staticlib/winservice/winservice_exception.hpp"
+
+namespace staticlib {
+namespace winservice {
+
+/**
+ * Restart policy of the supervised component
+ */
+struct restart_policy {
+    /**
+     * Max number of restarts within the window, service is stopped
+     * when the component fails after that
+     */
+    uint32_t max_restarts = 3;
+    /**
+     * Length of the window, restarts older than that are not counted
+     */
+    uint32_t window_millis = 60000;
+    /**
+     * Delay before the first restart within the window
+     */
+    uint32_t initial_backoff_millis = 100;
+    /**
+     * Max delay before the restart
+     */
+    uint32_t max_backoff_millis = 10000;
+    /**
+     * Delay is multiplied by this value on each subsequent restart within the window
+     */
+    double backoff_multiplier = 2.0;
+};
+
+/**
+ * Runs the components of the service and restarts the failed ones
+ * in place without restarting the service process.
+ *
+ * Components are started in the order they were added and stopped
+ * in reverse order. Component reports its own failure with 'report_failure',
+ * it is then stopped and started again on the supervisor thread after
+ * the backoff delay. When the restart policy is exhausted, or the restart
+ * fails, the service is stopped reporting the service-specific exit code to SCM,
+ * so SCM failure actions are applied only when in-process recovery fails.
+ *
+ * Start and stop phases are watched with timeouts, hung callback is abandoned
+ * (its thread is detached) and the service is stopped with the exit code.
+ */
+class service_supervisor {
+    class impl;
+    std::shared_ptr<impl> pimpl;
+
+public:
+    /**
+     * Constructor
+     *
+     * @param service_name name of the service hosted in this process
+     * @param start_timeout_millis max duration of the start of all components
+     *        and of the start of a single component on restart, '0' disables the watchdog
+     * @param stop_timeout_millis max duration of the stop of all components
+     *        and of the stop of a single component on restart, '0' disables the watchdog
+     * @param escalation_exit_code service-specific exit code reported
+     *        to SCM when in-process recovery fails
+     */
+    service_supervisor(const std::string& service_name, uint32_t start_timeout_millis = 0,
+            uint32_t stop_timeout_millis = 0, uint32_t escalation_exit_code = 1);
+
+    /**
+     * Destructor, stops the supervisor thread, components are not stopped
+     */
+    ~service_supervisor();
+
+    service_supervisor(const service_supervisor&) = delete;
+
+    service_supervisor& operator=(const service_supervisor&) = delete;
+
+    /**
+     * Registers component, must be called before the service is started
+     *
+     * @param name component name
+     * @param starter start callback
+     * @param stopper stop callback, is also called before the restart
+     * @param policy restart policy
+     * @return this instance
+     * @throws winservice_exception on duplicate name
+     */
+    service_supervisor& add_component(const std::string& name, std::function<void()> starter,
+            std::function<void()> stopper, restart_policy policy = restart_policy());
+
+    /**
+     * Reports the failure of the running component, can be called from any thread,
+     * returns without waiting for the restart, repeated reports before
+     * the restart are ignored, as are reports while the service is not running
+     *
+     * @param name component name
+     * @param message failure description, passed to the logger
+     * @throws winservice_exception on unknown name
+     */
+    void report_failure(const std::string& name, const std::string& message);
+
+    /**
+     * Number of restarts of the component since the service start
+     *
+     * @param name component name
+     * @return number of restarts
+     * @throws winservice_exception on unknown name
+     */
+    uint32_t restart_count(const std::string& name) const;
+
+    /**
+     * Creates service lifecycle that starts and stops supervised components,
+     * returned lifecycle keeps the components alive
+     *
+     * @param logger logger callback, restarts are reported to it
+     * @return service lifecycle
+     */
+    service_lifecycle create_lifecycle(std::function<void(const std::string&)> logger);
+};
+
+} // namespace
+}
+
+#endif /* STATICLIB_WINSERVICE_SERVICE_SUPERVISOR_HPP */
@@ -0,0 +1,109 @@
+/*
+ * Copyright 2026, alex at staticlibs.net
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * File:   service_tracer.hpp
+ * Author: alex
+ *
+ * Created on October 17, 2026, 10:05 AM
+ */
+
+#ifndef STATICLIB_WINSERVICE_SERVICE_TRACER_HPP
+#define STATICLIB_WINSERVICE_SERVICE_TRACER_HPP
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+namespace staticlib {
+namespace winservice {
+
+/**
+ * Enables or disables recording of trace spans in this process,
+ * tracing is disabled by default, disabled span costs a single atomic load
+ *
+ * @param enabled whether spans should be recorded
+ */
+void enable_tracing(bool enabled = true);
+
+/**
+ * Checks whether tracing is enabled
+ *
+ * @return true if spans are recorded
+ */
+bool is_tracing_enabled();
+
+/**
+ * Formats all the recorded spans as Chrome trace JSON ('chrome://tracing',
+ * Perfetto UI), spans are written as complete ('X') events with thread IDs
+ *
+ * @return JSON object with 'traceEvents' array
+ */
+std::string dump_trace_json();
+
+/**
+ * Drops all the recorded spans
+ */
+void clear_trace();
+
+/**
+ * Scoped span, recorded into the buffer of the current thread when
+ * it ends, can be used by the lifecycle callbacks to trace their own steps:
+ *
+ * sl::winservice::trace_span span("load_config");
+ */
+class trace_span {
+    std::string name;
+    const char* category;
+    std::chrono::steady_clock::time_point begin;
+    bool active;
+
+public:
+    /**
+     * Constructor, starts the span if tracing is enabled
+     *
+     * @param name span name, copied only if tracing is enabled
+     * @param category span category, must be a literal
+     */
+    trace_span(const char* name, const char* category = "user");
+
+    /**
+     * Constructor, starts the span if tracing is enabled
+     *
+     * @param name span name
+     * @param category span category, must be a literal
+     */
+    trace_span(const std::string& name, const char* category = "user");
+
+    /**
+     * Destructor, ends the span if it was not ended explicitly
+     */
+    ~trace_span();
+
+    trace_span(const trace_span&) = delete;
+
+    trace_span& operator=(const trace_span&) = delete;
+
+    /**
+     * Ends the span before the end of the scope, subsequent calls have no effect
+     */
+    void end();
+};
+
+} // namespace
+}
+
+#endif /* STATICLIB_WINSERVICE_SERVICE_TRACER_HPP */
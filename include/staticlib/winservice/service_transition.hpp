@@ -0,0 +1,160 @@
+/*
+ * Copyright 2026, alex at staticlibs.net
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * File:   service_transition.hpp
+ * Author: alex
+ *
+ * Created on October 17, 2026, 2:20 PM
+ */
+
+#ifndef STATICLIB_WINSERVICE_SERVICE_TRANSITION_HPP
+#define STATICLIB_WINSERVICE_SERVICE_TRANSITION_HPP
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+
+#include "staticlib/winservice/cancellation_token.hpp"
+
+namespace staticlib {
+namespace winservice {
+
+/**
+ * State transition in progress, passed to lifecycle callbacks,
+ * allows callbacks to report their progress to SCM, carries the control
+ * that initiated the transition, the time budget and the cancellation token
+ */
+class service_transition {
+    uint32_t pending;
+    uint32_t target;
+    uint32_t wait_hint_millis;
+    uint32_t reason_control;
+    std::chrono::steady_clock::time_point started_at;
+    std::chrono::steady_clock::time_point deadline_at;
+    cancellation_token token;
+    std::function<void(uint32_t)> reporter;
+    double progress_fraction = 0;
+
+public:
+    /**
+     * Constructor
+     *
+     * @param pending_state pending state reported for this transition
+     * @param target_state state that will be reported when transition is finished
+     * @param wait_hint_millis min wait hint reported with checkpoints
+     * @param reporter function that publishes next checkpoint with the specified wait hint
+     */
+    service_transition(uint32_t pending_state, uint32_t target_state, uint32_t wait_hint_millis,
+            std::function<void(uint32_t)> reporter);
+
+    /**
+     * Constructor
+     *
+     * @param pending_state pending state reported for this transition
+     * @param target_state state that will be reported when transition is finished
+     * @param wait_hint_millis min wait hint reported with checkpoints
+     * @param reason control that initiated the transition, '0' for initial start
+     * @param budget_millis time available for the transition before the process may be killed
+     * @param token token cancelled when the transition is superseded by another control
+     * @param reporter function that publishes next checkpoint with the specified wait hint
+     */
+    service_transition(uint32_t pending_state, uint32_t target_state, uint32_t wait_hint_millis,
+            uint32_t reason, uint32_t budget_millis, cancellation_token token,
+            std::function<void(uint32_t)> reporter);
+
+    service_transition(const service_transition&) = delete;
+
+    service_transition& operator=(const service_transition&) = delete;
+
+    /**
+     * Pending state of this transition, 'state_start_pending' etc.
+     *
+     * @return pending state
+     */
+    uint32_t pending_state() const;
+
+    /**
+     * Target state of this transition, 'state_running' etc.
+     *
+     * @return target state
+     */
+    uint32_t target_state() const;
+
+    /**
+     * Control that initiated this transition: 'control_stop', 'control_shutdown',
+     * 'control_preshutdown', 'control_pause' or 'control_continue',
+     * '0' for the initial start
+     *
+     * @return control code
+     */
+    uint32_t reason() const;
+
+    /**
+     * Point in time after which SCM or OS may kill the process,
+     * callbacks should finish (or flush as much as fits) before it
+     *
+     * @return deadline of this transition
+     */
+    std::chrono::steady_clock::time_point deadline() const;
+
+    /**
+     * Time left until the deadline
+     *
+     * @return remaining time in milliseconds, '0' if deadline has passed
+     */
+    uint32_t remaining_millis() const;
+
+    /**
+     * Token that is cancelled when another control supersedes this transition,
+     * e.g. 'STOP' received during start or 'SHUTDOWN' received during stop
+     *
+     * @return cancellation token
+     */
+    const cancellation_token& cancellation() const;
+
+    /**
+     * Shortcut for 'cancellation().is_cancelled()'
+     *
+     * @return true if this transition was superseded
+     */
+    bool is_cancelled() const;
+
+    /**
+     * Publishes next checkpoint to SCM
+     */
+    void checkpoint();
+
+    /**
+     * Publishes next checkpoint to SCM with the wait hint
+     * estimated from the specified progress
+     *
+     * @param fraction progress of the transition, from '0.0' to '1.0'
+     */
+    void report_progress(double fraction);
+
+    /**
+     * Last reported progress
+     *
+     * @return progress of the transition, from '0.0' to '1.0'
+     */
+    double progress() const;
+};
+
+} // namespace
+}
+
+#endif /* STATICLIB_WINSERVICE_SERVICE_TRANSITION_HPP */
@@ -0,0 +1,127 @@
+/*
+ * Copyright 2026, alex at staticlibs.net
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * File:   simulated_scm.hpp
+ * Author: alex
+ *
+ * Created on October 17, 2026, 10:41 AM
+ */
+
+#ifndef STATICLIB_WINSERVICE_SIMULATED_SCM_HPP
+#define STATICLIB_WINSERVICE_SIMULATED_SCM_HPP
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "staticlib/winservice/scm_backend.hpp"
+
+namespace staticlib {
+namespace winservice {
+
+/**
+ * In-process Service Control Manager, models service records,
+ * state transitions and control delivery the same way as the native SCM does.
+ * Service process is simulated by calling 'start_service_and_wait' from
+ * a separate thread after the start of the service was requested.
+ * Can be used for testing and benchmarking of the lifecycle code
+ * on any platform.
+ */
+class simulated_scm : public scm_backend {
+    class impl;
+    std::shared_ptr<impl> pimpl;
+
+public:
+    /**
+     * Constructor
+     */
+    simulated_scm();
+
+    /**
+     * Destructor
+     */
+    ~simulated_scm();
+
+    simulated_scm(const simulated_scm&) = delete;
+
+    simulated_scm& operator=(const simulated_scm&) = delete;
+
+    virtual std::unique_ptr<scm_connection> connect() override;
+
+    virtual void run_dispatcher(const std::vector<std::string>& service_names,
+            std::function<void(const std::string&)> service_main) override;
+
+    virtual void register_control_handler(const std::string& service_name,
+            std::function<bool(uint32_t, uint32_t, uint32_t)> handler) override;
+
+    virtual void set_service_status(const std::string& service_name, const service_status& status) override;
+
+    /**
+     * Delivers control code to the service bypassing the checks
+     * done by 'control_service', used to simulate system events
+     * like 'control_shutdown' or 'control_session_change'
+     *
+     * @param service_name service name
+     * @param control control code
+     * @param event_type event type for power and session events
+     * @param event_data event data, session ID for session events
+     */
+    void send_control(const std::string& service_name, uint32_t control, uint32_t event_type = 0,
+            uint32_t event_data = 0);
+
+    /**
+     * Waits until the specified service reaches specified state
+     *
+     * @param service_name service name
+     * @param state state to wait for
+     * @param timeout_millis max time to wait
+     * @return service status
+     * @throws winservice_exception on timeout
+     */
+    service_status wait_for_state(const std::string& service_name, uint32_t state, uint32_t timeout_millis);
+
+    /**
+     * Returns all the statuses reported for the specified service
+     *
+     * @param service_name service name
+     * @return status history
+     */
+    std::vector<service_status> status_history(const std::string& service_name);
+
+    /**
+     * Returns the number of in-place configuration changes
+     * applied to the specified service
+     *
+     * @param service_name service name
+     * @return number of 'change_service_config' calls
+     */
+    uint32_t config_change_count(const std::string& service_name);
+
+    /**
+     * Sets max time 'control_service' waits for the control handler
+     * to return, 30 seconds by default (same as native SCM)
+     *
+     * @param millis timeout in milliseconds
+     */
+    void set_control_timeout_millis(uint32_t millis);
+};
+
+} // namespace
+}
+
+#endif /* STATICLIB_WINSERVICE_SIMULATED_SCM_HPP */
+
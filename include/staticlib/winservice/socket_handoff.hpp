@@ -0,0 +1,144 @@
+/*
+ * Copyright 2026, alex at staticlibs.net
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * File:   socket_handoff.hpp
+ * Author: alex
+ *
+ * Created on October 17, 2026, 3:10 PM
+ */
+
+#ifndef STATICLIB_WINSERVICE_SOCKET_HANDOFF_HPP
+#define STATICLIB_WINSERVICE_SOCKET_HANDOFF_HPP
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace staticlib {
+namespace winservice {
+
+/**
+ * Maximum number of sockets passed in a single handoff
+ */
+const uint32_t max_handoff_sockets = 64;
+
+/**
+ * Listening sockets and application state passed from the running
+ * instance of the service to the new one
+ */
+struct handoff_state {
+    /**
+     * Socket handles, file descriptors on POSIX, 'SOCKET' values on Windows;
+     * in the received state these are new handles owned by the receiver
+     */
+    std::vector<int64_t> sockets;
+    /**
+     * Opaque application state, e.g. serialized list of the bound addresses
+     */
+    std::string state;
+};
+
+/**
+ * Handoff endpoint of the running (old) instance, listens on the local IPC channel
+ * (unix socket on POSIX, named pipe on Windows) in a background thread.
+ * On each connection of the new instance the state returned by 'provider' is sent
+ * (sockets are passed with 'SCM_RIGHTS' on POSIX and duplicated with 'WSADuplicateSocket'
+ * on Windows), the old instance keeps accepting on its sockets until the new one
+ * confirms the takeover with 'handoff_client::release_previous', then 'on_released'
+ * is called, it is expected to drain the connections and stop the service,
+ * e.g. with 'request_service_stop'. If the new instance disconnects without
+ * the confirmation, the old instance continues to serve and to wait for the next one.
+ * Only processes running as the same user can connect: peer credentials are checked
+ * on POSIX, pipe access is restricted to the current user on Windows.
+ */
+class handoff_server {
+    class impl;
+    std::shared_ptr<impl> pimpl;
+
+public:
+    /**
+     * Constructor, starts listening
+     *
+     * @param endpoint unix socket path ('@' prefix means abstract namespace)
+     *        on POSIX, pipe name on Windows
+     * @param provider called on each handoff request to collect sockets and state,
+     *        sockets stay open in this process
+     * @param on_released called once from the background thread after the new instance
+     *        has taken over
+     * @param timeout_millis max time to wait for each message of the new instance,
+     *        including the confirmation, silent connection is dropped after it
+     * @throws winservice_exception if endpoint cannot be opened
+     */
+    handoff_server(const std::string& endpoint, std::function<handoff_state()> provider,
+            std::function<void()> on_released, uint32_t timeout_millis = 60000);
+
+    /**
+     * Checks whether the new instance has taken over
+     *
+     * @return true if 'on_released' was called
+     */
+    bool is_released() const;
+
+    /**
+     * Stops listening, removes the endpoint, called automatically on destruction
+     */
+    void close();
+};
+
+/**
+ * Handoff endpoint of the new instance, is used from the start callback
+ * while the service is reported as 'START_PENDING' ("standby" phase):
+ * sockets are received and put into use first, the previous instance
+ * is released only after that, so there is no gap in accepting connections.
+ */
+class handoff_client {
+    class impl;
+    std::shared_ptr<impl> pimpl;
+
+public:
+    /**
+     * Constructor
+     *
+     * @param endpoint endpoint specified to 'handoff_server' of the running instance
+     */
+    explicit handoff_client(const std::string& endpoint);
+
+    /**
+     * Receives sockets and state from the running instance
+     *
+     * @param timeout_millis max time to wait for the running instance
+     * @param out received sockets and state
+     * @return false if there is no running instance listening on the endpoint (cold start)
+     * @throws winservice_exception on IPC error or timeout
+     */
+    bool receive(uint32_t timeout_millis, handoff_state& out);
+
+    /**
+     * Tells the previous instance to drain and stop, closes the IPC channel,
+     * must be called after successful 'receive'
+     *
+     * @throws winservice_exception on IPC error
+     */
+    void release_previous();
+};
+
+} // namespace
+}
+
+#endif /* STATICLIB_WINSERVICE_SOCKET_HANDOFF_HPP */
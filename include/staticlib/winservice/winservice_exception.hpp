@@ -24,6 +24,9 @@
 #ifndef STATICLIB_WINSERVICE_WINSERVICEEXCEPTION_HPP
 #define STATICLIB_WINSERVICE_WINSERVICEEXCEPTION_HPP
 
+#include <cstdint>
+#include <string>
+
 #include "staticlib/support/exception.hpp"
 
 namespace staticlib {
@@ -49,6 +52,34 @@ public:
 
 };
 
+/**
+ * Thrown from lifecycle callbacks to stop the service reporting
+ * the service-specific exit code to SCM
+ */
+class service_specific_error : public winservice_exception {
+    uint32_t code;
+
+public:
+    /**
+     * Constructor
+     *
+     * @param exit_code service-specific exit code
+     * @param msg error message
+     */
+    service_specific_error(uint32_t exit_code, const std::string& msg) :
+    winservice_exception(msg),
+    code(exit_code) { }
+
+    /**
+     * Service-specific exit code
+     *
+     * @return exit code
+     */
+    uint32_t exit_code() const {
+        return code;
+    }
+};
+
 } // namespace
 } 
 
@@ -0,0 +1,185 @@
+/*
+ * Copyright 2026, alex at staticlibs.net
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * File:   async_lifecycle.cpp
+ * Author: alex
+ *
+ * Created on October 17, 2026, 10:50 AM
+ */
+
+#include "staticlib/winservice/async_lifecycle.hpp"
+
+#include <condition_variable>
+#include <mutex>
+#include <utility>
+
+#include "staticlib/config.hpp"
+#include "staticlib/support.hpp"
+
+#include "staticlib/winservice/winservice_exception.hpp"
+
+namespace staticlib {
+namespace winservice {
+
+namespace { // anonymous
+
+// waited on by the lifecycle thread
+class completion_state {
+public:
+    std::mutex mutex;
+    std::condition_variable cv;
+    bool finished = false;
+    std::exception_ptr error;
+
+    bool finish(std::exception_ptr err) {
+        std::lock_guard<std::mutex> guard{mutex};
+        if (finished) {
+            return false;
+        }
+        finished = true;
+        error = std::move(err);
+        cv.notify_all();
+        return true;
+    }
+
+    void wait() {
+        std::unique_lock<std::mutex> lock{mutex};
+        cv.wait(lock, [this] {
+            return finished;
+        });
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+};
+
+std::exception_ptr make_error(const std::string& message) {
+    try {
+        throw winservice_exception(message);
+    } catch (...) {
+        return std::current_exception();
+    }
+}
+
+} // namespace
+
+class transition_completion::impl {
+    std::shared_ptr<completion_state> state;
+
+public:
+    explicit impl(std::shared_ptr<completion_state> state) :
+    state(std::move(state)) { }
+
+    impl(const impl&) = delete;
+
+    impl& operator=(const impl&) = delete;
+
+    // last copy of the handle is dropped by the callback without completing
+    ~impl() STATICLIB_NOEXCEPT {
+        try {
+            state->finish(make_error(TRACEMSG("Transition was abandoned without completion")));
+        } catch (...) {
+            // cannot be reported
+        }
+    }
+
+    void finish(std::exception_ptr error) {
+        state->finish(std::move(error));
+    }
+
+    bool is_finished() const {
+        std::lock_guard<std::mutex> guard{state->mutex};
+        return state->finished;
+    }
+};
+
+transition_completion::transition_completion(std::shared_ptr<impl> pimpl) :
+pimpl(std::move(pimpl)) { }
+
+void transition_completion::complete() {
+    pimpl->finish(std::exception_ptr());
+}
+
+void transition_completion::fail(const std::string& message) {
+    pimpl->finish(make_error(message));
+}
+
+void transition_completion::fail(std::exception_ptr error) {
+    if (!error) {
+        error = make_error(TRACEMSG("Transition failed with unspecified error"));
+    }
+    pimpl->finish(std::move(error));
+}
+
+bool transition_completion::is_finished() const {
+    return pimpl->is_finished();
+}
+
+namespace { // anonymous
+
+// lifecycle thread waits while the operation runs on the executor
+void run_async(const std::function<void(std::function<void()>)>& executor,
+        const async_lifecycle_callback& callback, service_transition& tr) {
+    auto state = std::make_shared<completion_state>();
+    {
+        auto completion = transition_completion(std::make_shared<transition_completion::impl>(state));
+        auto task = [callback, &tr, completion]() mutable {
+            try {
+                callback(tr, completion);
+            } catch (...) {
+                completion.fail(std::current_exception());
+            }
+        };
+        if (executor) {
+            try {
+                executor(std::move(task));
+            } catch (...) {
+                state->finish(std::current_exception());
+            }
+        } else {
+            task();
+        }
+    }
+    state->wait();
+}
+
+} // namespace
+
+service_lifecycle make_async_lifecycle(async_service_lifecycle lifecycle) {
+    auto alc = std::make_shared<async_service_lifecycle>(std::move(lifecycle));
+    service_lifecycle res;
+    res.starter = [alc](service_transition& tr) {
+        run_async(alc->executor, alc->starter, tr);
+    };
+    res.stopper = [alc](service_transition& tr) {
+        run_async(alc->executor, alc->stopper, tr);
+    };
+    if (alc->pauser) {
+        res.pauser = [alc](service_transition& tr) {
+            run_async(alc->executor, alc->pauser, tr);
+        };
+    }
+    if (alc->resumer) {
+        res.resumer = [alc](service_transition& tr) {
+            run_async(alc->executor, alc->resumer, tr);
+        };
+    }
+    return res;
+}
+
+} // namespace
+}
@@ -0,0 +1,74 @@
+/*
+ * Copyright 2026, alex at staticlibs.net
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * File:   cancellation_token.cpp
+ * Author: alex
+ *
+ * Created on October 17, 2026, 3:18 PM
+ */
+
+#include "staticlib/winservice/cancellation_token.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+
+namespace staticlib {
+namespace winservice {
+
+class cancellation_token::impl {
+    std::atomic<bool> cancelled{false};
+    mutable std::mutex mutex;
+    mutable std::condition_variable cv;
+
+public:
+    void cancel() {
+        std::lock_guard<std::mutex> guard{mutex};
+        cancelled.store(true, std::memory_order_release);
+        cv.notify_all();
+    }
+
+    bool is_cancelled() const {
+        return cancelled.load(std::memory_order_acquire);
+    }
+
+    bool wait_for(uint32_t timeout_millis) const {
+        std::unique_lock<std::mutex> lock{mutex};
+        return cv.wait_for(lock, std::chrono::milliseconds(timeout_millis), [this] {
+            return cancelled.load(std::memory_order_acquire);
+        });
+    }
+};
+
+cancellation_token::cancellation_token() :
+pimpl(std::make_shared<impl>()) { }
+
+void cancellation_token::cancel() {
+    pimpl->cancel();
+}
+
+bool cancellation_token::is_cancelled() const {
+    return pimpl->is_cancelled();
+}
+
+bool cancellation_token::wait_for(uint32_t timeout_millis) const {
+    return pimpl->wait_for(timeout_millis);
+}
+
+} // namespace
+}
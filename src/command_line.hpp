@@ -0,0 +1,138 @@
+/*
+ * Copyright 2026, alex at staticlibs.net
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * File:   command_line.hpp
+ * Author: alex
+ *
+ * Created on October 17, 2026, 2:05 PM
+ */
+
+#ifndef STATICLIB_WINSERVICE_COMMAND_LINE_HPP
+#define STATICLIB_WINSERVICE_COMMAND_LINE_HPP
+
+#include <string>
+#include <vector>
+
+namespace staticlib {
+namespace winservice {
+
+/**
+ * Quotes argument the way it is parsed back by 'CommandLineToArgvW'
+ *
+ * @param arg argument
+ * @return argument with quotes and escapes added if necessary
+ */
+inline std::string quote_argument(const std::string& arg) {
+    if (!arg.empty() && std::string::npos == arg.find_first_of(" \t\n\v\"")) {
+        return arg;
+    }
+    auto res = std::string("\"");
+    size_t backslashes = 0;
+    for (char ch : arg) {
+        if ('\\' == ch) {
+            backslashes += 1;
+            continue;
+        }
+        // backslashes are only special before the quote
+        auto count = '"' == ch ? backslashes * 2 + 1 : backslashes;
+        res.append(count, '\\');
+        res.push_back(ch);
+        backslashes = 0;
+    }
+    res.append(backslashes * 2, '\\');
+    res.push_back('"');
+    return res;
+}
+
+/**
+ * Composes service command line from the executable path and arguments
+ *
+ * @param binary_path path to executable
+ * @param arguments arguments
+ * @return command line
+ */
+inline std::string compose_command_line(const std::string& binary_path, const std::vector<std::string>& arguments) {
+    auto res = quote_argument(binary_path);
+    for (auto& arg : arguments) {
+        res.push_back(' ');
+        res.append(quote_argument(arg));
+    }
+    return res;
+}
+
+/**
+ * Splits command line into the executable path and arguments,
+ * inverse of 'compose_command_line'
+ *
+ * @param command_line command line
+ * @return executable path followed by arguments
+ */
+inline std::vector<std::string> split_command_line(const std::string& command_line) {
+    auto res = std::vector<std::string>();
+    auto cur = std::string();
+    bool in_quotes = false;
+    bool has_token = false;
+    for (size_t i = 0; i < command_line.length(); i++) {
+        char ch = command_line[i];
+        if ('\\' == ch) {
+            size_t count = 0;
+            while (i < command_line.length() && '\\' == command_line[i]) {
+                count += 1;
+                i += 1;
+            }
+            if (i < command_line.length() && '"' == command_line[i]) {
+                cur.append(count / 2, '\\');
+                if (1 == count % 2) {
+                    cur.push_back('"');
+                } else {
+                    // quote is processed on the next iteration
+                    i -= 1;
+                }
+            } else {
+                cur.append(count, '\\');
+                i -= 1;
+            }
+            has_token = true;
+        } else if ('"' == ch) {
+            if (in_quotes && i + 1 < command_line.length() && '"' == command_line[i + 1]) {
+                cur.push_back('"');
+                i += 1;
+            } else {
+                in_quotes = !in_quotes;
+            }
+            has_token = true;
+        } else if ((' ' == ch || '\t' == ch) && !in_quotes) {
+            if (has_token) {
+                res.push_back(cur);
+                cur.clear();
+                has_token = false;
+            }
+        } else {
+            cur.push_back(ch);
+            has_token = true;
+        }
+    }
+    if (has_token) {
+        res.push_back(cur);
+    }
+    return res;
+}
+
+} // namespace
+}
+
+#endif /* STATICLIB_WINSERVICE_COMMAND_LINE_HPP */
@@ -0,0 +1,343 @@
+/*
+ * Copyright 2026, alex at staticlibs.net
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * File:   component_graph.cpp
+ * Author: alex
+ *
+ * Created on October 17, 2026, 4:18 PM
+ */
+
+#include "staticlib/winservice/component_graph.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <thread>
+
+#include "staticlib/config.hpp"
+#include "staticlib/support.hpp"
+
+#include "staticlib/winservice/service_tracer.hpp"
+
+namespace staticlib {
+namespace winservice {
+
+namespace { // anonymous
+
+class component {
+public:
+    std::string name;
+    std::vector<std::string> dependencies;
+    std::function<void()> starter;
+    std::function<void()> stopper;
+    bool started = false;
+};
+
+// state of a single parallel start or stop run
+class graph_run {
+public:
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::deque<size_t> ready;
+    std::vector<size_t> pending;
+    std::vector<std::vector<size_t>> successors;
+    std::vector<bool> done;
+    size_t remaining = 0;
+    size_t total = 0;
+    size_t running = 0;
+    bool failed = false;
+    std::vector<std::string> errors;
+};
+
+long long millis_since(std::chrono::steady_clock::time_point start) {
+    auto diff = std::chrono::steady_clock::now() - start;
+    return std::chrono::duration_cast<std::chrono::milliseconds>(diff).count();
+}
+
+} // namespace
+
+class component_graph::impl {
+    uint32_t threads_count;
+    std::mutex mutex;
+    std::vector<component> components;
+
+public:
+    impl(uint32_t threads_count) :
+    threads_count(threads_count > 0 ? threads_count : std::max(std::thread::hardware_concurrency(), 1u)) { }
+
+    void add_component(const std::string& name, const std::vector<std::string>& dependencies,
+            std::function<void()> starter, std::function<void()> stopper) {
+        std::lock_guard<std::mutex> guard{mutex};
+        for (auto& co : components) {
+            if (name == co.name) throw winservice_exception(TRACEMSG(
+                    "Duplicate component name specified: [" + name + "]"));
+        }
+        component co;
+        co.name = name;
+        co.dependencies = dependencies;
+        co.starter = starter ? std::move(starter) : [] {};
+        co.stopper = stopper ? std::move(stopper) : [] {};
+        components.emplace_back(std::move(co));
+    }
+
+    void start(std::function<void(const std::string&)> logger, std::function<void(double)> progress) {
+        std::lock_guard<std::mutex> guard{mutex};
+        auto deps = resolve_dependencies();
+        auto selected = std::vector<bool>();
+        for (auto& co : components) {
+            selected.push_back(!co.started);
+        }
+        auto begin = std::chrono::steady_clock::now();
+        auto errors = run(deps, selected, true, logger, progress, [this](size_t idx) {
+            trace_span span(components[idx].name, "component");
+            components[idx].starter();
+            components[idx].started = true;
+        }, "started");
+        if (!errors.empty()) {
+            logger("Error starting components, stopping the started ones");
+            auto stop_errors = stop_started(logger, nullptr);
+            std::string msg = errors.front();
+            for (auto& err : stop_errors) {
+                msg += "\n" + err;
+            }
+            throw winservice_exception(TRACEMSG(msg));
+        }
+        logger("Components started, count: [" + sl::support::to_string(components.size()) + "]," +
+                " elapsed millis: [" + sl::support::to_string(millis_since(begin)) + "]");
+    }
+
+    void stop(std::function<void(const std::string&)> logger, std::function<void(double)> progress) {
+        std::lock_guard<std::mutex> guard{mutex};
+        auto begin = std::chrono::steady_clock::now();
+        auto errors = stop_started(logger, progress);
+        if (!errors.empty()) throw winservice_exception(TRACEMSG(errors.front()));
+        logger("Components stopped, count: [" + sl::support::to_string(components.size()) + "]," +
+                " elapsed millis: [" + sl::support::to_string(millis_since(begin)) + "]");
+    }
+
+private:
+    std::vector<std::vector<size_t>> resolve_dependencies() {
+        auto indices = std::map<std::string, size_t>();
+        for (size_t i = 0; i < components.size(); i++) {
+            indices[components[i].name] = i;
+        }
+        auto res = std::vector<std::vector<size_t>>();
+        for (auto& co : components) {
+            auto vec = std::vector<size_t>();
+            for (auto& dep : co.dependencies) {
+                auto it = indices.find(dep);
+                if (indices.end() == it) throw winservice_exception(TRACEMSG(
+                        "Unknown dependency: [" + dep + "] specified for component: [" + co.name + "]"));
+                vec.push_back(it->second);
+            }
+            res.emplace_back(std::move(vec));
+        }
+        // Kahn's algorithm, all nodes are visited if there are no cycles
+        auto pending = std::vector<size_t>();
+        auto dependents = std::vector<std::vector<size_t>>(res.size());
+        for (size_t i = 0; i < res.size(); i++) {
+            pending.push_back(res[i].size());
+            for (size_t dep : res[i]) {
+                dependents[dep].push_back(i);
+            }
+        }
+        auto queue = std::deque<size_t>();
+        for (size_t i = 0; i < pending.size(); i++) {
+            if (0 == pending[i]) queue.push_back(i);
+        }
+        size_t visited = 0;
+        while (!queue.empty()) {
+            auto idx = queue.front();
+            queue.pop_front();
+            visited += 1;
+            for (size_t de : dependents[idx]) {
+                pending[de] -= 1;
+                if (0 == pending[de]) queue.push_back(de);
+            }
+        }
+        if (visited != res.size()) throw winservice_exception(TRACEMSG(
+                "Dependency cycle detected between components"));
+        return res;
+    }
+
+    std::vector<std::string> stop_started(std::function<void(const std::string&)> logger,
+            std::function<void(double)> progress) {
+        auto deps = resolve_dependencies();
+        // component can be stopped when all its dependents are stopped
+        auto reversed = std::vector<std::vector<size_t>>(deps.size());
+        for (size_t i = 0; i < deps.size(); i++) {
+            for (size_t dep : deps[i]) {
+                reversed[dep].push_back(i);
+            }
+        }
+        auto selected = std::vector<bool>();
+        for (auto& co : components) {
+            selected.push_back(co.started);
+        }
+        return run(reversed, selected, false, logger, progress, [this](size_t idx) {
+            components[idx].started = false;
+            trace_span span(components[idx].name, "component");
+            components[idx].stopper();
+        }, "stopped");
+    }
+
+    std::vector<std::string> run(const std::vector<std::vector<size_t>>& prerequisites,
+            const std::vector<bool>& selected, bool stop_on_error, std::function<void(const std::string&)>& logger,
+            std::function<void(double)>& progress, std::function<void(size_t)> action, const std::string& verb) {
+        graph_run gr;
+        gr.successors.resize(prerequisites.size());
+        gr.done.resize(prerequisites.size());
+        for (size_t i = 0; i < prerequisites.size(); i++) {
+            size_t count = 0;
+            if (selected[i]) {
+                for (size_t pre : prerequisites[i]) {
+                    // not selected prerequisites are already in the required state
+                    if (selected[pre]) {
+                        gr.successors[pre].push_back(i);
+                        count += 1;
+                    }
+                }
+                gr.remaining += 1;
+            }
+            gr.pending.push_back(count);
+        }
+        for (size_t i = 0; i < prerequisites.size(); i++) {
+            if (selected[i] && 0 == gr.pending[i]) {
+                gr.ready.push_back(i);
+            }
+        }
+        gr.total = gr.remaining;
+        if (0 == gr.total) {
+            return std::vector<std::string>();
+        }
+
+        auto worker = [&] {
+            std::unique_lock<std::mutex> lock{gr.mutex};
+            for (;;) {
+                gr.cv.wait(lock, [&] {
+                    return !gr.ready.empty() || 0 == gr.remaining || (gr.failed && 0 == gr.running);
+                });
+                if (gr.ready.empty()) break;
+                if (gr.failed && stop_on_error) {
+                    gr.ready.clear();
+                    gr.cv.notify_all();
+                    continue;
+                }
+                auto idx = gr.ready.front();
+                gr.ready.pop_front();
+                gr.running += 1;
+                lock.unlock();
+                auto begin = std::chrono::steady_clock::now();
+                std::string error;
+                try {
+                    action(idx);
+                } catch (const std::exception& e) {
+                    error = TRACEMSG(e.what() + "\nError in component: [" + components[idx].name + "]");
+                } catch (...) {
+                    error = TRACEMSG("Error in component: [" + components[idx].name + "]");
+                }
+                auto elapsed = millis_since(begin);
+                lock.lock();
+                gr.running -= 1;
+                if (error.empty()) {
+                    logger("Component " + verb + ", name: [" + components[idx].name + "]," +
+                            " elapsed millis: [" + sl::support::to_string(elapsed) + "]");
+                } else {
+                    logger(error);
+                    gr.errors.push_back(error);
+                    gr.failed = true;
+                }
+                if (error.empty() || !stop_on_error) {
+                    gr.done[idx] = true;
+                    gr.remaining -= 1;
+                    for (size_t su : gr.successors[idx]) {
+                        gr.pending[su] -= 1;
+                        if (0 == gr.pending[su]) gr.ready.push_back(su);
+                    }
+                    if (progress) {
+                        progress(static_cast<double>(gr.total - gr.remaining) / static_cast<double>(gr.total));
+                    }
+                }
+                gr.cv.notify_all();
+            }
+        };
+
+        auto count = std::min(static_cast<size_t>(threads_count), gr.total);
+        auto threads = std::vector<std::thread>();
+        for (size_t i = 1; i < count; i++) {
+            threads.emplace_back(worker);
+        }
+        // calling thread is used as one of the workers
+        worker();
+        for (auto& th : threads) {
+            th.join();
+        }
+        return gr.errors;
+    }
+};
+
+component_graph::component_graph(uint32_t threads_count) :
+pimpl(std::make_shared<impl>(threads_count)) { }
+
+component_graph& component_graph::add_component(const std::string& name,
+        const std::vector<std::string>& dependencies, std::function<void()> starter,
+        std::function<void()> stopper) {
+    pimpl->add_component(name, dependencies, std::move(starter), std::move(stopper));
+    return *this;
+}
+
+void component_graph::start(std::function<void(const std::string&)> logger,
+        std::function<void(double)> progress) {
+    if (!logger) {
+        logger = [](const std::string&) {};
+    }
+    pimpl->start(std::move(logger), std::move(progress));
+}
+
+void component_graph::stop(std::function<void(const std::string&)> logger,
+        std::function<void(double)> progress) {
+    if (!logger) {
+        logger = [](const std::string&) {};
+    }
+    pimpl->stop(std::move(logger), std::move(progress));
+}
+
+service_lifecycle component_graph::create_lifecycle(std::function<void(const std::string&)> logger) {
+    if (!logger) {
+        logger = [](const std::string&) {};
+    }
+    auto graph = pimpl;
+    service_lifecycle lc;
+    lc.starter = [graph, logger](service_transition& tr) {
+        graph->start(logger, [&tr](double fraction) {
+            tr.report_progress(fraction);
+        });
+    };
+    lc.stopper = [graph, logger](service_transition& tr) {
+        graph->stop(logger, [&tr](double fraction) {
+            tr.report_progress(fraction);
+        });
+    };
+    lc.logger = logger;
+    return lc;
+}
+
+} // namespace
+}
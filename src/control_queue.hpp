@@ -0,0 +1,123 @@
+/*
+ * Copyright 2026, alex at staticlibs.net
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * File:   control_queue.hpp
+ * Author: alex
+ *
+ * Created on October 17, 2026, 1:15 PM
+ */
+
+#ifndef STATICLIB_WINSERVICE_CONTROL_QUEUE_HPP
+#define STATICLIB_WINSERVICE_CONTROL_QUEUE_HPP
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+
+#include "staticlib/winservice/service_status.hpp"
+
+namespace staticlib {
+namespace winservice {
+
+/**
+ * Queue of control codes received by the control handler,
+ * controls are consumed by the lifecycle worker thread,
+ * redundant controls are coalesced on consumption
+ */
+class control_queue {
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::deque<uint32_t> queue;
+
+public:
+    /**
+     * Enqueues control, never blocks on lifecycle callbacks
+     *
+     * @param control control code
+     */
+    void put(uint32_t control) {
+        std::lock_guard<std::mutex> guard{mutex};
+        queue.push_back(control);
+        cv.notify_all();
+    }
+
+    /**
+     * Checks whether 'STOP', 'SHUTDOWN' or 'PRESHUTDOWN' different
+     * from the specified control is enqueued
+     *
+     * @param control control that initiated current transition
+     * @return true if current transition is superseded
+     */
+    bool has_stop_other_than(uint32_t control) {
+        std::lock_guard<std::mutex> guard{mutex};
+        for (uint32_t co : queue) {
+            if (co != control && (control_stop == co || control_shutdown == co || control_preshutdown == co)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /**
+     * Drops all enqueued controls
+     */
+    void clear() {
+        std::lock_guard<std::mutex> guard{mutex};
+        queue.clear();
+    }
+
+    /**
+     * Waits for controls and coalesces all the enqueued ones into a single control:
+     * 'STOP', 'SHUTDOWN' and 'PRESHUTDOWN' take over all other controls, otherwise the last of
+     * 'PAUSE'/'CONTINUE' wins and is dropped if service is already in the target state
+     *
+     * @param current_state current state of the service
+     * @return control to apply, '0' if all the enqueued controls were no-op
+     */
+    uint32_t take(uint32_t current_state) {
+        std::unique_lock<std::mutex> lock{mutex};
+        cv.wait(lock, [this] {
+            return !queue.empty();
+        });
+        bool stop = false;
+        bool shutdown = false;
+        bool preshutdown = false;
+        uint32_t last = 0;
+        for (uint32_t control : queue) {
+            switch (control) {
+            case control_stop: stop = true; break;
+            case control_shutdown: shutdown = true; break;
+            case control_preshutdown: preshutdown = true; break;
+            case control_pause: last = control; break;
+            case control_continue: last = control; break;
+            default: break;
+            }
+        }
+        queue.clear();
+        if (shutdown) return control_shutdown;
+        if (preshutdown) return control_preshutdown;
+        if (stop) return control_stop;
+        if (control_pause == last && state_paused == current_state) return 0;
+        if (control_continue == last && state_running == current_state) return 0;
+        return last;
+    }
+};
+
+} // namespace
+}
+
+#endif /* STATICLIB_WINSERVICE_CONTROL_QUEUE_HPP */
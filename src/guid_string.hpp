@@ -0,0 +1,129 @@
+/*
+ * Copyright 2026, alex at staticlibs.net
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * File:   guid_string.hpp
+ * Author: alex
+ *
+ * Created on October 17, 2026, 2:15 PM
+ */
+
+#ifndef STATICLIB_WINSERVICE_GUID_STRING_HPP
+#define STATICLIB_WINSERVICE_GUID_STRING_HPP
+
+#include <cstdint>
+#include <string>
+
+namespace staticlib {
+namespace winservice {
+
+/**
+ * GUID fields in the same layout as Win32 'GUID' struct
+ */
+struct guid_parts {
+    uint32_t data1 = 0;
+    uint16_t data2 = 0;
+    uint16_t data3 = 0;
+    uint8_t data4[8];
+};
+
+/**
+ * Parses GUID in registry format, braces are optional:
+ * '{4f27f2de-14e2-430b-a549-7cd48cbc8245}'
+ *
+ * @param str GUID string
+ * @param out parsed fields
+ * @return false if the string is not a valid GUID
+ */
+inline bool parse_guid_string(const std::string& str, guid_parts& out) {
+    auto st = str;
+    if (st.length() > 2 && '{' == st.front() && '}' == st.back()) {
+        st = st.substr(1, st.length() - 2);
+    }
+    if (36 != st.length()) {
+        return false;
+    }
+    auto hex = std::string();
+    for (size_t i = 0; i < st.length(); i++) {
+        char ch = st[i];
+        if (8 == i || 13 == i || 18 == i || 23 == i) {
+            if ('-' != ch) return false;
+            continue;
+        }
+        bool is_hex = (ch >= '0' && ch <= '9') || (ch >= 'a' && ch <= 'f') || (ch >= 'A' && ch <= 'F');
+        if (!is_hex) return false;
+        hex.push_back(ch);
+    }
+    auto field = [&hex](size_t offset, size_t len) {
+        return std::stoul(hex.substr(offset, len), nullptr, 16);
+    };
+    out.data1 = static_cast<uint32_t>(field(0, 8));
+    out.data2 = static_cast<uint16_t>(field(8, 4));
+    out.data3 = static_cast<uint16_t>(field(12, 4));
+    for (size_t i = 0; i < 8; i++) {
+        out.data4[i] = static_cast<uint8_t>(field(16 + i * 2, 2));
+    }
+    return true;
+}
+
+/**
+ * Formats GUID in lower case without braces
+ *
+ * @param guid GUID fields
+ * @return GUID string
+ */
+inline std::string format_guid_string(const guid_parts& guid) {
+    static const char* hex = "0123456789abcdef";
+    auto res = std::string();
+    auto append = [&res](uint64_t value, size_t digits) {
+        for (size_t i = digits; i > 0; i--) {
+            res.push_back(hex[(value >> ((i - 1) * 4)) & 0xf]);
+        }
+    };
+    append(guid.data1, 8);
+    res.push_back('-');
+    append(guid.data2, 4);
+    res.push_back('-');
+    append(guid.data3, 4);
+    res.push_back('-');
+    for (size_t i = 0; i < 8; i++) {
+        if (2 == i) {
+            res.push_back('-');
+        }
+        append(guid.data4[i], 2);
+    }
+    return res;
+}
+
+/**
+ * Brings GUID string to the form returned by 'format_guid_string',
+ * so GUIDs can be compared as strings
+ *
+ * @param str GUID string
+ * @return normalized GUID, input string if it is not a valid GUID
+ */
+inline std::string normalize_guid_string(const std::string& str) {
+    guid_parts guid;
+    if (!parse_guid_string(str, guid)) {
+        return str;
+    }
+    return format_guid_string(guid);
+}
+
+} // namespace
+}
+
+#endif /* STATICLIB_WINSERVICE_GUID_STRING_HPP */
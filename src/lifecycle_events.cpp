@@ -0,0 +1,273 @@
+/*
+ * Copyright 2026, alex at staticlibs.net
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * File:   lifecycle_events.cpp
+ * Author: alex
+ *
+ * Created on October 17, 2026, 3:40 PM
+ */
+
+#include "staticlib/winservice/lifecycle_events.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
+#include <mutex>
+#include <thread>
+
+#include "staticlib/support.hpp"
+
+#include "staticlib/winservice/service_status.hpp"
+
+namespace staticlib {
+namespace winservice {
+
+namespace { // anonymous
+
+void copy_truncated(char* dest, size_t dest_size, const char* src) STATICLIB_NOEXCEPT {
+    if (nullptr == src) {
+        dest[0] = '\0';
+        return;
+    }
+    std::strncpy(dest, src, dest_size - 1);
+    dest[dest_size - 1] = '\0';
+}
+
+std::string event_description(uint32_t event_id) {
+    switch (event_id) {
+    case event_start_failed: return "Error starting service";
+    case event_stop_failed: return "Error stopping service";
+    case event_status_report_failed: return "Error reporting service status";
+    case event_checkpoint_failed: return "Error publishing checkpoint";
+    case event_handler_registration_failed: return "Fatal error registering control handler";
+    case event_transition_completed: return "Service transition completed";
+    default: return "Service event, id: [" + sl::support::to_string(event_id) + "]";
+    }
+}
+
+class cell {
+public:
+    std::atomic<size_t> sequence;
+    lifecycle_event event;
+};
+
+} // namespace
+
+// bounded MPMC queue (D. Vyukov), single consumer is used here
+class lifecycle_event_channel::impl {
+    std::function<void(const lifecycle_event&)> consumer;
+    size_t mask;
+    std::unique_ptr<cell[]> cells;
+    std::atomic<size_t> enqueue_pos;
+    std::atomic<size_t> dequeue_pos;
+    std::atomic<uint64_t> dropped;
+    std::atomic<bool> closed;
+    // set by the consumer before it blocks on the condition variable
+    std::atomic<bool> consumer_waiting;
+
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::thread worker;
+
+public:
+    impl(std::function<void(const lifecycle_event&)> consumer, uint32_t capacity) :
+    consumer(std::move(consumer)) {
+        size_t size = 2;
+        while (size < capacity) {
+            size <<= 1;
+        }
+        mask = size - 1;
+        cells = std::unique_ptr<cell[]>(new cell[size]);
+        for (size_t i = 0; i < size; i++) {
+            cells[i].sequence.store(i, std::memory_order_relaxed);
+        }
+        enqueue_pos.store(0, std::memory_order_relaxed);
+        dequeue_pos.store(0, std::memory_order_relaxed);
+        dropped.store(0, std::memory_order_relaxed);
+        closed.store(false, std::memory_order_relaxed);
+        consumer_waiting.store(false, std::memory_order_relaxed);
+        worker = std::thread([this] {
+            run_consumer();
+        });
+    }
+
+    bool publish(const lifecycle_event& event) STATICLIB_NOEXCEPT {
+        if (closed.load(std::memory_order_acquire)) {
+            dropped.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        auto pos = enqueue_pos.load(std::memory_order_relaxed);
+        for (;;) {
+            auto& ce = cells[pos & mask];
+            auto seq = ce.sequence.load(std::memory_order_acquire);
+            auto diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+            if (0 == diff) {
+                if (enqueue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    ce.event = event;
+                    ce.sequence.store(pos + 1, std::memory_order_release);
+                    // lock is taken only when the consumer is idle, both sides use
+                    // seq_cst, so either the consumer sees the event before blocking,
+                    // or this thread sees the flag and signals it
+                    std::atomic_thread_fence(std::memory_order_seq_cst);
+                    if (consumer_waiting.load(std::memory_order_seq_cst)) {
+                        std::lock_guard<std::mutex> guard{mutex};
+                        cv.notify_one();
+                    }
+                    return true;
+                }
+            } else if (diff < 0) {
+                dropped.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            } else {
+                pos = enqueue_pos.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    uint64_t dropped_count() const STATICLIB_NOEXCEPT {
+        return dropped.load(std::memory_order_relaxed);
+    }
+
+    void close() STATICLIB_NOEXCEPT {
+        {
+            std::lock_guard<std::mutex> guard{mutex};
+            closed.store(true, std::memory_order_release);
+            cv.notify_all();
+        }
+        if (worker.joinable() && std::this_thread::get_id() != worker.get_id()) {
+            worker.join();
+        }
+    }
+
+private:
+    bool pop(lifecycle_event& out) STATICLIB_NOEXCEPT {
+        auto pos = dequeue_pos.load(std::memory_order_relaxed);
+        auto& ce = cells[pos & mask];
+        auto seq = ce.sequence.load(std::memory_order_acquire);
+        if (static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos + 1) < 0) {
+            return false;
+        }
+        out = ce.event;
+        dequeue_pos.store(pos + 1, std::memory_order_relaxed);
+        ce.sequence.store(pos + mask + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool has_event() STATICLIB_NOEXCEPT {
+        auto pos = dequeue_pos.load(std::memory_order_relaxed);
+        auto seq = cells[pos & mask].sequence.load(std::memory_order_acquire);
+        return static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos + 1) >= 0;
+    }
+
+    void run_consumer() STATICLIB_NOEXCEPT {
+        lifecycle_event ev;
+        for (;;) {
+            while (pop(ev)) {
+                try {
+                    consumer(ev);
+                } catch (...) {
+                    // consumer errors must not stop the delivery
+                }
+            }
+            std::unique_lock<std::mutex> lock{mutex};
+            consumer_waiting.store(true, std::memory_order_seq_cst);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            cv.wait(lock, [this] {
+                return closed.load(std::memory_order_acquire) || has_event();
+            });
+            consumer_waiting.store(false, std::memory_order_relaxed);
+            if (closed.load(std::memory_order_acquire)) {
+                lock.unlock();
+                // events published concurrently with closing
+                while (pop(ev)) {
+                    try {
+                        consumer(ev);
+                    } catch (...) { }
+                }
+                break;
+            }
+        }
+    }
+};
+
+lifecycle_event make_lifecycle_event(uint32_t event_id, uint32_t severity, const std::string& service_name,
+        uint32_t pending_state, uint32_t target_state, uint32_t error_code, const char* message) STATICLIB_NOEXCEPT {
+    lifecycle_event ev;
+    ev.event_id = event_id;
+    ev.severity = severity;
+    ev.pending_state = pending_state;
+    ev.target_state = target_state;
+    ev.error_code = error_code;
+    auto since_epoch = std::chrono::system_clock::now().time_since_epoch();
+    ev.timestamp_millis = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(since_epoch).count());
+    copy_truncated(ev.service_name, sizeof(ev.service_name), service_name.c_str());
+    copy_truncated(ev.message, sizeof(ev.message), message);
+    return ev;
+}
+
+std::string format_lifecycle_event(const lifecycle_event& event) {
+    auto res = std::string();
+    if ('\0' != event.message[0]) {
+        res += std::string(event.message) + "\n";
+    }
+    res += event_description(event.event_id) + ", name: [" + std::string(event.service_name) + "]";
+    if (0 != event.pending_state) {
+        res += ", pending: [" + state_to_string(event.pending_state) + "]";
+    }
+    if (0 != event.target_state) {
+        res += ", target: [" + state_to_string(event.target_state) + "]";
+    }
+    if (0 != event.error_code) {
+        res += ", exit code: [" + sl::support::to_string(event.error_code) + "]";
+    }
+    return res;
+}
+
+lifecycle_event_channel::lifecycle_event_channel(std::function<void(const lifecycle_event&)> consumer,
+        uint32_t capacity) :
+pimpl(std::make_shared<impl>(std::move(consumer), capacity)) { }
+
+lifecycle_event_channel::~lifecycle_event_channel() STATICLIB_NOEXCEPT {
+    pimpl->close();
+}
+
+bool lifecycle_event_channel::publish(const lifecycle_event& event) STATICLIB_NOEXCEPT {
+    return pimpl->publish(event);
+}
+
+uint64_t lifecycle_event_channel::dropped_count() const STATICLIB_NOEXCEPT {
+    return pimpl->dropped_count();
+}
+
+void lifecycle_event_channel::close() STATICLIB_NOEXCEPT {
+    pimpl->close();
+}
+
+std::shared_ptr<lifecycle_event_channel> lifecycle_event_channel::from_logger(
+        std::function<void(const std::string&)> logger) {
+    if (!logger) {
+        logger = [](const std::string&) {};
+    }
+    return std::make_shared<lifecycle_event_channel>([logger](const lifecycle_event& ev) {
+        logger(format_lifecycle_event(ev));
+    });
+}
+
+} // namespace
+}
@@ -0,0 +1,231 @@
+/*
+ * Copyright 2026, alex at staticlibs.net
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * File:   metrics_recorder.hpp
+ * Author: alex
+ *
+ * Created on October 17, 2026, 11:20 AM
+ */
+
+#ifndef STATICLIB_WINSERVICE_METRICS_RECORDER_HPP
+#define STATICLIB_WINSERVICE_METRICS_RECORDER_HPP
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <string>
+
+#include "staticlib/winservice/service_metrics.hpp"
+#include "staticlib/winservice/service_status.hpp"
+
+namespace staticlib {
+namespace winservice {
+
+/**
+ * Lock-free latency histogram, values are recorded with relaxed
+ * atomic increments and can be snapshotted concurrently
+ */
+class latency_recorder {
+    static const size_t buckets_count = 15;
+
+    std::array<std::atomic<uint64_t>, buckets_count + 1> counts;
+    std::atomic<uint64_t> count;
+    std::atomic<uint64_t> sum_millis;
+    std::atomic<uint64_t> max_millis;
+
+public:
+    latency_recorder() {
+        reset();
+    }
+
+    latency_recorder(const latency_recorder&) = delete;
+
+    latency_recorder& operator=(const latency_recorder&) = delete;
+
+    void record(uint64_t millis) {
+        auto& bounds = bucket_bounds();
+        size_t idx = 0;
+        while (idx < bounds.size() && millis > bounds[idx]) {
+            idx += 1;
+        }
+        counts[idx].fetch_add(1, std::memory_order_relaxed);
+        count.fetch_add(1, std::memory_order_relaxed);
+        sum_millis.fetch_add(millis, std::memory_order_relaxed);
+        auto prev = max_millis.load(std::memory_order_relaxed);
+        while (prev < millis && !max_millis.compare_exchange_weak(prev, millis, std::memory_order_relaxed)) { }
+    }
+
+    latency_histogram snapshot() const {
+        latency_histogram res;
+        auto& bounds = bucket_bounds();
+        res.bounds_millis.assign(bounds.begin(), bounds.end());
+        for (auto& co : counts) {
+            res.counts.push_back(co.load(std::memory_order_relaxed));
+        }
+        res.count = count.load(std::memory_order_relaxed);
+        res.sum_millis = sum_millis.load(std::memory_order_relaxed);
+        res.max_millis = max_millis.load(std::memory_order_relaxed);
+        return res;
+    }
+
+    void reset() {
+        for (auto& co : counts) {
+            co.store(0, std::memory_order_relaxed);
+        }
+        count.store(0, std::memory_order_relaxed);
+        sum_millis.store(0, std::memory_order_relaxed);
+        max_millis.store(0, std::memory_order_relaxed);
+    }
+
+private:
+    static const std::array<uint64_t, buckets_count>& bucket_bounds() {
+        static const std::array<uint64_t, buckets_count> bounds = {{
+            1, 5, 10, 25, 50, 100, 250, 500, 1000, 2500, 5000, 10000, 30000, 60000, 120000
+        }};
+        return bounds;
+    }
+};
+
+/**
+ * Counters of the single kind of the state transition
+ */
+class transition_recorder {
+    std::atomic<uint64_t> succeeded;
+    std::atomic<uint64_t> failed;
+    latency_recorder latency;
+    mutable std::mutex resources_mutex;
+    resource_usage last_resources;
+
+public:
+    transition_recorder() {
+        reset();
+    }
+
+    void record(bool success, std::chrono::steady_clock::time_point start) {
+        if (success) {
+            succeeded.fetch_add(1, std::memory_order_relaxed);
+        } else {
+            failed.fetch_add(1, std::memory_order_relaxed);
+        }
+        auto elapsed = std::chrono::steady_clock::now() - start;
+        latency.record(static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(elapsed).count()));
+    }
+
+    void record_resources(const resource_usage& delta) {
+        std::lock_guard<std::mutex> guard{resources_mutex};
+        last_resources = delta;
+    }
+
+    transition_metrics snapshot() const {
+        transition_metrics res;
+        res.succeeded = succeeded.load(std::memory_order_relaxed);
+        res.failed = failed.load(std::memory_order_relaxed);
+        res.latency = latency.snapshot();
+        std::lock_guard<std::mutex> guard{resources_mutex};
+        res.last_resources = last_resources;
+        return res;
+    }
+
+    void reset() {
+        succeeded.store(0, std::memory_order_relaxed);
+        failed.store(0, std::memory_order_relaxed);
+        latency.reset();
+        std::lock_guard<std::mutex> guard{resources_mutex};
+        last_resources = resource_usage();
+    }
+};
+
+/**
+ * Lifecycle metrics of a single service, shared between
+ * the lifecycle worker, the control handler and the status reporter
+ */
+class metrics_recorder {
+public:
+    transition_recorder start;
+    transition_recorder stop;
+    transition_recorder pause;
+    transition_recorder resume;
+    std::atomic<uint64_t> controls_received;
+    std::atomic<uint64_t> controls_ignored;
+    std::atomic<uint64_t> status_updates;
+    std::atomic<uint64_t> status_update_failures;
+
+    metrics_recorder() {
+        reset();
+    }
+
+    metrics_recorder(const metrics_recorder&) = delete;
+
+    metrics_recorder& operator=(const metrics_recorder&) = delete;
+
+    transition_recorder& transition(uint32_t pending_state) {
+        switch (pending_state) {
+        case state_stop_pending: return stop;
+        case state_pause_pending: return pause;
+        case state_continue_pending: return resume;
+        default: return start;
+        }
+    }
+
+    void record_status_update(bool success) {
+        status_updates.fetch_add(1, std::memory_order_relaxed);
+        if (!success) {
+            status_update_failures.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    service_metrics snapshot(const std::string& service_name) const {
+        service_metrics res;
+        res.service_name = service_name;
+        res.start = start.snapshot();
+        res.stop = stop.snapshot();
+        res.pause = pause.snapshot();
+        res.resume = resume.snapshot();
+        res.controls_received = controls_received.load(std::memory_order_relaxed);
+        res.controls_ignored = controls_ignored.load(std::memory_order_relaxed);
+        res.status_updates = status_updates.load(std::memory_order_relaxed);
+        res.status_update_failures = status_update_failures.load(std::memory_order_relaxed);
+        return res;
+    }
+
+    void reset() {
+        start.reset();
+        stop.reset();
+        pause.reset();
+        resume.reset();
+        controls_received.store(0, std::memory_order_relaxed);
+        controls_ignored.store(0, std::memory_order_relaxed);
+        status_updates.store(0, std::memory_order_relaxed);
+        status_update_failures.store(0, std::memory_order_relaxed);
+    }
+};
+
+/**
+ * Returns metrics of the specified service, creates
+ * them on the first call, metrics are never removed
+ *
+ * @param service_name service name
+ * @return service metrics
+ */
+std::shared_ptr<metrics_recorder> find_metrics_recorder(const std::string& service_name);
+
+} // namespace
+}
+
+#endif /* STATICLIB_WINSERVICE_METRICS_RECORDER_HPP */
@@ -0,0 +1,139 @@
+/*
+ * Copyright 2026, alex at staticlibs.net
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * File:   notify_socket.cpp
+ * Author: alex
+ *
+ * Created on October 17, 2026, 1:58 PM
+ */
+
+#include "staticlib/winservice/notify_socket.hpp"
+#ifndef STATICLIB_WINDOWS
+
+#include <cerrno>
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <sys/types.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "staticlib/support.hpp"
+
+#include "staticlib/winservice/winservice_exception.hpp"
+
+namespace staticlib {
+namespace winservice {
+
+namespace { // anonymous
+
+std::string env_var(const char* name) {
+    auto val = std::getenv(name);
+    return nullptr != val ? std::string(val) : std::string();
+}
+
+} // namespace
+
+class notify_socket::impl {
+    std::string path;
+    int fd = -1;
+    struct sockaddr_un addr;
+    socklen_t addr_len = 0;
+
+public:
+    impl(const std::string& socket_path) :
+    path(socket_path.data(), socket_path.length()) {
+        if (path.empty()) {
+            return;
+        }
+        std::memset(std::addressof(addr), '\0', sizeof(addr));
+        addr.sun_family = AF_UNIX;
+        if (path.length() >= sizeof(addr.sun_path)) throw winservice_exception(TRACEMSG(
+                "Invalid notification socket path: [" + path + "]"));
+        std::memcpy(addr.sun_path, path.data(), path.length());
+        if ('@' == path[0]) {
+            // abstract namespace
+            addr.sun_path[0] = '\0';
+        }
+        addr_len = static_cast<socklen_t>(offsetof(struct sockaddr_un, sun_path) + path.length());
+        fd = ::socket(AF_UNIX, SOCK_DGRAM, 0);
+        if (-1 == fd) throw winservice_exception(TRACEMSG(
+                "Error creating notification socket, error: [" + std::string(std::strerror(errno)) + "]"));
+        ::fcntl(fd, F_SETFD, FD_CLOEXEC);
+    }
+
+    ~impl() STATICLIB_NOEXCEPT {
+        if (-1 != fd) {
+            ::close(fd);
+        }
+    }
+
+    impl(const impl&) = delete;
+
+    impl& operator=(const impl&) = delete;
+
+    bool is_enabled() const {
+        return -1 != fd;
+    }
+
+    void notify(const std::string& message) {
+        if (-1 == fd) {
+            return;
+        }
+        auto sent = ::sendto(fd, message.data(), message.length(), MSG_NOSIGNAL,
+                reinterpret_cast<const struct sockaddr*>(std::addressof(addr)), addr_len);
+        if (sent < 0) throw winservice_exception(TRACEMSG(
+                "Error sending notification, socket: [" + path + "]," +
+                " message: [" + message + "]," +
+                " error: [" + std::string(std::strerror(errno)) + "]"));
+    }
+};
+
+notify_socket::notify_socket() :
+notify_socket(env_var("NOTIFY_SOCKET")) { }
+
+notify_socket::notify_socket(const std::string& socket_path) :
+pimpl(std::make_shared<impl>(socket_path)) { }
+
+bool notify_socket::is_enabled() const {
+    return pimpl->is_enabled();
+}
+
+void notify_socket::notify(const std::string& message) {
+    pimpl->notify(message);
+}
+
+uint64_t notify_socket::watchdog_interval_usec() {
+    auto usec = env_var("WATCHDOG_USEC");
+    if (usec.empty()) {
+        return 0;
+    }
+    // watchdog may be requested for other process
+    auto pid = env_var("WATCHDOG_PID");
+    if (!pid.empty() && std::strtoull(pid.c_str(), nullptr, 10) != static_cast<unsigned long long>(::getpid())) {
+        return 0;
+    }
+    return static_cast<uint64_t>(std::strtoull(usec.c_str(), nullptr, 10));
+}
+
+} // namespace
+}
+
+#endif // !STATICLIB_WINDOWS
@@ -22,328 +22,647 @@
 */
 
 #include "staticlib/winservice.hpp"
-#ifdef STATICLIB_WINDOWS
 
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <future>
+#include <map>
 #include <memory>
 #include <mutex>
-
-#include "staticlib/support/windows.hpp"
+#include <thread>
+#include <utility>
+#include <vector>
 
 #include "staticlib/config.hpp"
 #include "staticlib/support.hpp"
 #include "staticlib/utils.hpp"
 
+#include "control_queue.hpp"
+#include "metrics_recorder.hpp"
+#include "state_publisher.hpp"
+#include "status_reporter.hpp"
+
 namespace staticlib {
 namespace winservice {
 
 namespace { // anonymous
 
-class service_handle_deleter {
-public:
-    void operator()(SC_HANDLE handle) {
-        CloseServiceHandle(handle);
-    }
-};
-
 class service_ctx {
     std::string name;
-    std::wstring wname;
-    std::function<void()> starter = []{};
-    std::function<void()> stopper = []{};
-    std::function<void(const std::string&)> logger = [](const std::string&){};
-    SERVICE_STATUS status;
-    SERVICE_STATUS_HANDLE status_handle = nullptr;
-    bool initialized = false;
+    std::shared_ptr<scm_backend> backend;
+    service_lifecycle lifecycle;
+    uint32_t service_type;
+    std::shared_ptr<metrics_recorder> metrics;
+    std::shared_ptr<state_publisher> publisher;
+    std::shared_ptr<lifecycle_event_channel> events;
+    bool owns_events;
+    control_queue controls;
+    std::shared_ptr<status_reporter> reporter;
+    std::thread worker;
+    std::atomic<uint32_t> requested_exit_code{0};
+    std::mutex transition_mutex;
+    bool transition_active = false;
+    uint32_t transition_reason = 0;
+    cancellation_token transition_token;
 
 public:
+    service_ctx(const std::string& name, std::shared_ptr<scm_backend> backend, service_lifecycle lifecycle,
+            uint32_t service_type) :
+    name(name.data(), name.length()),
+    backend(std::move(backend)),
+    lifecycle(std::move(lifecycle)),
+    service_type(service_type),
+    metrics(find_metrics_recorder(name)),
+    publisher(find_state_publisher(name)),
+    events(this->lifecycle.events),
+    owns_events(nullptr == events.get()) {
+        if (!this->lifecycle.starter) {
+            this->lifecycle.starter = [](service_transition&) {};
+        }
+        if (!this->lifecycle.stopper) {
+            this->lifecycle.stopper = [](service_transition&) {};
+        }
+        if (owns_events) {
+            // string logger is an adapter over the event channel
+            events = lifecycle_event_channel::from_logger(this->lifecycle.logger);
+        }
+    }
+
+    ~service_ctx() STATICLIB_NOEXCEPT {
+        join_worker();
+        close_events();
+    }
 
     service_ctx(const service_ctx&) = delete;
 
     service_ctx& operator=(const service_ctx&) = delete;
 
-    service_ctx(service_ctx&& other) = delete;
+    // does not allocate, message is copied into a preallocated buffer
+    void emit(uint32_t event_id, uint32_t severity, uint32_t pending, uint32_t target, uint32_t error,
+            const char* message) STATICLIB_NOEXCEPT {
+        events->publish(make_lifecycle_event(event_id, severity, name, pending, target, error, message));
+    }
+
+    // delivers remaining events to the logger
+    void close_events() STATICLIB_NOEXCEPT {
+        if (owns_events) {
+            events->close();
+        }
+    }
 
-    service_ctx& operator=(service_ctx&& other) {
-        name = std::move(other.name);
-        wname = std::move(other.wname);
-        starter = std::move(other.starter);
-        stopper = std::move(other.stopper);
-        logger = std::move(other.logger);
-        status = std::move(other.status);
-        status_handle = std::move(other.status_handle);
-        initialized = other.initialized;
-        return *this;
+    std::string& get_name() {
+        return name;
     }
 
-    service_ctx() { }
+    scm_backend& get_backend() {
+        return *backend;
+    }
 
-    service_ctx(const std::string& name, std::function<void()> starter, 
-            std::function<void()> stopper, std::function<void(const std::string&)> logger) :
-    name(name.data(), name.length()),
-    wname(sl::utils::widen(name)),
-    starter(starter),
-    stopper(stopper),
-    logger(logger) {
-        status.dwServiceType = SERVICE_WIN32_OWN_PROCESS;
-        status.dwCurrentState = SERVICE_START_PENDING;
-        status.dwControlsAccepted = SERVICE_ACCEPT_STOP | SERVICE_ACCEPT_SHUTDOWN | SERVICE_ACCEPT_PAUSE_CONTINUE;
-        status.dwWin32ExitCode = NO_ERROR;
-        status.dwServiceSpecificExitCode = 0;
-        status.dwCheckPoint = 0;
-        status.dwWaitHint = 0;
+    status_reporter& get_reporter() {
+        return *reporter;
+    }
 
-        initialized = true;
+    metrics_recorder& get_metrics() {
+        return *metrics;
     }
 
-    void log(const std::string& msg) {
-        logger(msg);
+    bool is_resource_accounting_enabled() {
+        return lifecycle.resource_accounting;
     }
 
-    bool is_initialized() {
-        return initialized;
+    control_queue& get_controls() {
+        return controls;
     }
 
-    std::string& get_name() {
-        return name;
+    // service may be started again by SCM after it was stopped
+    void prepare_launch() {
+        join_worker();
+        controls.clear();
+        requested_exit_code.store(0, std::memory_order_relaxed);
+        service_status status;
+        status.service_type = service_type;
+        status.current_state = state_start_pending;
+        status.controls_accepted = accept_stop | accept_shutdown | accept_pause_continue;
+        if (lifecycle.preshutdown_timeout_millis > 0) {
+            status.controls_accepted |= accept_preshutdown;
+        }
+        if (nullptr != lifecycle.event_bus.get()) {
+            status.controls_accepted |= lifecycle.event_bus->accepted_controls();
+        }
+        status.win32_exit_code = 0;
+        status.service_specific_exit_code = 0;
+        status.check_point = 0;
+        status.wait_hint = 0;
+        reporter = std::make_shared<status_reporter>(name, backend, events,
+                status, lifecycle.wait_hint_millis, lifecycle.heartbeat_interval_millis, metrics, publisher);
     }
 
-    std::wstring& get_wname() {
-        return wname;
+    void start_worker(std::function<void()> fun) {
+        worker = std::thread(std::move(fun));
     }
 
-    SERVICE_STATUS& get_status() {
-        return status;
+    void join_worker() {
+        if (worker.joinable()) {
+            worker.join();
+        }
     }
 
-    SERVICE_STATUS_HANDLE get_status_handle() {
-        return status_handle;
+    void start(uint32_t pending, uint32_t target, uint32_t reason) {
+        service_transition tr(pending, target, lifecycle.wait_hint_millis, reason, budget_millis(reason),
+                begin_transition(reason), checkpoint_fun());
+        auto deferred = sl::support::defer([this]() STATICLIB_NOEXCEPT {
+            end_transition();
+        });
+        if (state_continue_pending == pending && lifecycle.resumer) {
+            trace_span span("resumer", "callback");
+            lifecycle.resumer(tr);
+        } else {
+            trace_span span("starter", "callback");
+            lifecycle.starter(tr);
+        }
     }
 
-    void set_status_handle(SERVICE_STATUS_HANDLE ha) {
-       this->status_handle = ha;
+    void stop(uint32_t pending, uint32_t target, uint32_t reason) {
+        service_transition tr(pending, target, lifecycle.wait_hint_millis, reason, budget_millis(reason),
+                begin_transition(reason), checkpoint_fun());
+        auto deferred = sl::support::defer([this]() STATICLIB_NOEXCEPT {
+            end_transition();
+        });
+        if (state_pause_pending == pending && lifecycle.pauser) {
+            trace_span span("pauser", "callback");
+            lifecycle.pauser(tr);
+        } else {
+            trace_span span("stopper", "callback");
+            lifecycle.stopper(tr);
+        }
     }
 
-    void start() {
-        starter();
+    // enqueued as a regular stop control
+    void request_stop(uint32_t exit_code) {
+        requested_exit_code.store(exit_code, std::memory_order_relaxed);
+        controls.put(control_stop);
+        cancel_transition(control_stop);
     }
 
-    void stop() {
-        stopper();
+    uint32_t take_requested_exit_code() {
+        return requested_exit_code.exchange(0, std::memory_order_relaxed);
+    }
+
+    // subscribers are called on the bus thread
+    bool publish_event(uint32_t control, uint32_t event_type, uint32_t event_data) {
+        if (nullptr == lifecycle.event_bus.get()) {
+            return false;
+        }
+        service_event ev;
+        ev.service_name = name;
+        ev.control = control;
+        ev.event_type = event_type;
+        ev.session_id = control_session_change == control ? event_data : 0;
+        return lifecycle.event_bus->publish(ev);
+    }
+
+    // called from the control handler after the control is enqueued,
+    // running callback is notified when it is superseded by a different control
+    void cancel_transition(uint32_t control) {
+        std::lock_guard<std::mutex> guard{transition_mutex};
+        if (transition_active && control != transition_reason) {
+            transition_token.cancel();
+        }
+    }
+
+private:
+    uint32_t budget_millis(uint32_t reason) {
+        switch (reason) {
+        case control_shutdown: return lifecycle.shutdown_timeout_millis;
+        case control_preshutdown: return lifecycle.preshutdown_timeout_millis;
+        default: return lifecycle.wait_hint_millis;
+        }
+    }
+
+    cancellation_token begin_transition(uint32_t reason) {
+        std::lock_guard<std::mutex> guard{transition_mutex};
+        transition_active = true;
+        transition_reason = reason;
+        transition_token = cancellation_token();
+        // control may be received before the transition has begun
+        if (controls.has_stop_other_than(reason)) {
+            transition_token.cancel();
+        }
+        return transition_token;
+    }
+
+    void end_transition() {
+        std::lock_guard<std::mutex> guard{transition_mutex};
+        transition_active = false;
+    }
+
+    std::function<void(uint32_t)> checkpoint_fun() {
+        auto rep = reporter;
+        return [rep](uint32_t wait_hint) {
+            rep->checkpoint(wait_hint);
+        };
     }
 
 };
 
-DWORD resolve_start_type(const std::string& str) {
-    if ("SERVICE_BOOT_START" == str) return SERVICE_BOOT_START;
-    else if ("SERVICE_AUTO_START" == str) return SERVICE_AUTO_START;
-    else if ("SERVICE_DEMAND_START" == str) return SERVICE_DEMAND_START;
-    else if ("SERVICE_DISABLED" == str) return SERVICE_DISABLED;
+uint32_t resolve_start_type(const std::string& str) {
+    if ("SERVICE_BOOT_START" == str) return start_type_boot;
+    else if ("SERVICE_SYSTEM_START" == str) return start_type_system;
+    else if ("SERVICE_AUTO_START" == str) return start_type_auto;
+    else if ("SERVICE_DELAYED_AUTO_START" == str) return start_type_auto;
+    else if ("SERVICE_DEMAND_START" == str) return start_type_demand;
+    else if ("SERVICE_DISABLED" == str) return start_type_disabled;
     else throw winservice_exception(TRACEMSG("Invalid 'start_type' specified: [" + str + "]"));
 }
 
+uint32_t resolve_service_type(const std::string& str) {
+    if ("SERVICE_WIN32_OWN_PROCESS" == str) return service_type_own_process;
+    else if ("SERVICE_WIN32_SHARE_PROCESS" == str) return service_type_share_process;
+    else throw winservice_exception(TRACEMSG("Invalid 'service_type' specified: [" + str + "]"));
+}
+
 std::mutex& static_mutex() {
     static std::mutex mutex{};
     return mutex;
 }
 
-service_ctx& static_ctx() {
-    static service_ctx ctx{};
-    return ctx;
+std::map<std::string, std::shared_ptr<service_ctx>>& static_registry() {
+    static std::map<std::string, std::shared_ptr<service_ctx>> registry{};
+    return registry;
 }
 
-void set_static_context(const std::string& service_name, std::function<void()> starter, 
-        std::function<void()> stopper, std::function<void(const std::string&)> logger) {
+void register_services(const std::vector<std::shared_ptr<service_ctx>>& services) {
     std::lock_guard<std::mutex> guard{static_mutex()};
-    if (static_ctx().is_initialized()) throw winservice_exception(TRACEMSG(
-            "Windows service start attempt was already done in this process"));
-    static_ctx() = service_ctx(service_name, starter, stopper, logger);
+    auto& registry = static_registry();
+    for (auto& ctx : services) {
+        if (registry.end() != registry.find(ctx->get_name())) throw winservice_exception(TRACEMSG(
+                "Service is already running in this process, name: [" + ctx->get_name() + "]"));
+    }
+    for (auto& ctx : services) {
+        registry.insert(std::make_pair(ctx->get_name(), ctx));
+    }
 }
 
-void set_service_status(DWORD status, DWORD error = 0) {
-    auto& st = static_ctx().get_status();
-    st.dwCurrentState = status;
-    st.dwWin32ExitCode = error;
-    if (SERVICE_RUNNING == status || SERVICE_STOPPED == status) {
-        st.dwCheckPoint = 0;
-    } else {
-        st.dwCheckPoint += 1;
+void unregister_services(const std::vector<std::shared_ptr<service_ctx>>& services) STATICLIB_NOEXCEPT {
+    std::lock_guard<std::mutex> guard{static_mutex()};
+    for (auto& ctx : services) {
+        static_registry().erase(ctx->get_name());
     }
-    auto success = SetServiceStatus(static_ctx().get_status_handle(), std::addressof(st));
-    // do not throw if error reporting is in progress
-    if (!success && 0 == error) throw winservice_exception(TRACEMSG(
-            "Error changing status to: [" + sl::support::to_string(status) + "]," +
-            " error: [" + sl::utils::errcode_to_string(GetLastError()) + "]"));
 }
 
-void start_service(DWORD pending, DWORD target) STATICLIB_NOEXCEPT{
+std::shared_ptr<service_ctx> find_service(const std::string& service_name) {
+    std::lock_guard<std::mutex> guard{static_mutex()};
+    auto& registry = static_registry();
+    auto it = registry.find(service_name);
+    if (registry.end() != it) {
+        return it->second;
+    }
+    return std::shared_ptr<service_ctx>();
+}
+
+void set_service_status(service_ctx& ctx, uint32_t status, uint32_t error = 0,
+        uint32_t service_specific_error = 0) {
+    trace_span span("set_service_status", "lifecycle");
+    ctx.get_reporter().set_status(status, error, service_specific_error);
+}
+
+// attaches resources used by the process during the transition to its metrics and reports them
+void record_resources(service_ctx& ctx, uint32_t pending, uint32_t target, const resource_usage& before,
+        std::chrono::steady_clock::time_point begin) STATICLIB_NOEXCEPT {
     try {
-        set_service_status(pending);
-        static_ctx().start();
-        set_service_status(target);
+        auto delta = resource_usage_delta(before, sample_resource_usage());
+        ctx.get_metrics().transition(pending).record_resources(delta);
+        auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+                std::chrono::steady_clock::now() - begin).count();
+        auto msg = "elapsed millis: [" + sl::support::to_string(elapsed) + "], " + format_resource_usage(delta);
+        ctx.emit(event_transition_completed, severity_info, pending, target, 0, msg.c_str());
+    } catch (...) {
+        // accounting must not affect the transition
+    }
+}
+
+void start_service(service_ctx& ctx, uint32_t pending, uint32_t target, uint32_t reason) STATICLIB_NOEXCEPT {
+    trace_span span("start_service", "lifecycle");
+    auto begin = std::chrono::steady_clock::now();
+    auto accounting = ctx.is_resource_accounting_enabled();
+    auto before = accounting ? sample_resource_usage() : resource_usage();
+    bool success = false;
+    try {
+        set_service_status(ctx, pending);
+        ctx.start(pending, target, reason);
+        set_service_status(ctx, target);
+        success = true;
+    } catch (const service_specific_error& e) {
+        ctx.emit(event_start_failed, severity_error, pending, target, e.exit_code(), e.what());
+        set_service_status(ctx, state_stopped, exit_code_service_specific, e.exit_code());
     } catch (const std::exception& e) {
-        static_ctx().log(TRACEMSG(e.what() + "\nError starting service," +
-                " pending: [" + sl::support::to_string(pending) + "], target: [" + sl::support::to_string(target) + "]"));
-        set_service_status(SERVICE_STOPPED, 1);
+        ctx.emit(event_start_failed, severity_error, pending, target, 1, e.what());
+        set_service_status(ctx, state_stopped, 1);
     } catch (...) {
-        static_ctx().log(TRACEMSG("Error starting service," +
-            " pending: [" + sl::support::to_string(pending) + "], target: [" + sl::support::to_string(target) + "]"));
-        set_service_status(SERVICE_STOPPED, 2);
+        ctx.emit(event_start_failed, severity_error, pending, target, 2, nullptr);
+        set_service_status(ctx, state_stopped, 2);
+    }
+    ctx.get_metrics().transition(pending).record(success, begin);
+    if (accounting) {
+        record_resources(ctx, pending, target, before, begin);
     }
 }
 
-void stop_service(DWORD pending, DWORD target) STATICLIB_NOEXCEPT{
+void stop_service(service_ctx& ctx, uint32_t pending, uint32_t target, uint32_t reason) STATICLIB_NOEXCEPT {
+    trace_span span("stop_service", "lifecycle");
+    auto begin = std::chrono::steady_clock::now();
+    auto accounting = ctx.is_resource_accounting_enabled();
+    auto before = accounting ? sample_resource_usage() : resource_usage();
+    bool success = false;
     try {
-        set_service_status(pending);
-        static_ctx().stop();
-        set_service_status(target);
+        set_service_status(ctx, pending);
+        ctx.stop(pending, target, reason);
+        // stop may be requested by the service itself with the exit code
+        auto code = state_stopped == target ? ctx.take_requested_exit_code() : 0;
+        if (0 != code) {
+            set_service_status(ctx, target, exit_code_service_specific, code);
+        } else {
+            set_service_status(ctx, target);
+        }
+        success = true;
+    } catch (const service_specific_error& e) {
+        ctx.emit(event_stop_failed, severity_error, pending, target, e.exit_code(), e.what());
+        set_service_status(ctx, state_stopped, exit_code_service_specific, e.exit_code());
     } catch (const std::exception& e) {
-        static_ctx().log(TRACEMSG(e.what() + "\nError stopping service," +
-            " pending: [" + sl::support::to_string(pending) + "], target: [" + sl::support::to_string(target) + "]"));
-        set_service_status(SERVICE_STOPPED, 1);
+        ctx.emit(event_stop_failed, severity_error, pending, target, 1, e.what());
+        set_service_status(ctx, state_stopped, 1);
     } catch (...) {
-        static_ctx().log(TRACEMSG("Error stopping service," +
-            " pending: [" + sl::support::to_string(pending) + "], target: [" + sl::support::to_string(target) + "]"));
-        set_service_status(SERVICE_STOPPED, 2);
+        ctx.emit(event_stop_failed, severity_error, pending, target, 2, nullptr);
+        set_service_status(ctx, state_stopped, 2);
+    }
+    ctx.get_metrics().transition(pending).record(success, begin);
+    if (accounting) {
+        record_resources(ctx, pending, target, before, begin);
     }
 }
 
-void WINAPI service_control_handler(DWORD control_step) STATICLIB_NOEXCEPT {
-    std::lock_guard<std::mutex> guard{ static_mutex() };
+// returns false if the control is neither enqueued nor published
+bool service_control_handler(service_ctx& ctx, uint32_t control_step, uint32_t event_type,
+        uint32_t event_data) STATICLIB_NOEXCEPT {
+    trace_span span("service_control_handler", "scm");
+    ctx.get_metrics().controls_received.fetch_add(1, std::memory_order_relaxed);
+    // controls are applied by the lifecycle worker,
+    // handler returns without waiting for callbacks
     switch (control_step) {
-    case SERVICE_CONTROL_STOP: stop_service(SERVICE_STOP_PENDING, SERVICE_STOPPED); break;
-    case SERVICE_CONTROL_PAUSE: stop_service(SERVICE_PAUSE_PENDING, SERVICE_PAUSED); break;
-    case SERVICE_CONTROL_CONTINUE: start_service(SERVICE_CONTINUE_PENDING, SERVICE_RUNNING); break;
-    case SERVICE_CONTROL_SHUTDOWN: stop_service(SERVICE_STOP_PENDING, SERVICE_STOPPED); break;
-    default: break;
+    case control_stop:
+    case control_shutdown:
+    case control_preshutdown:
+        ctx.get_controls().put(control_step);
+        ctx.cancel_transition(control_step);
+        return true;
+    case control_pause:
+    case control_continue:
+        ctx.get_controls().put(control_step);
+        return true;
+    case control_interrogate: return true;
+    default:
+        // paramchange, power, session and user-defined controls
+        bool published = false;
+        try {
+            published = ctx.publish_event(control_step, event_type, event_data);
+        } catch (...) {
+            // handler must return to SCM
+        }
+        if (!published) {
+            ctx.get_metrics().controls_ignored.fetch_add(1, std::memory_order_relaxed);
+        }
+        return published;
     }
 }
 
-void WINAPI service_main(DWORD, LPWSTR*) STATICLIB_NOEXCEPT {
-    std::lock_guard<std::mutex> guard{static_mutex()};
+void lifecycle_worker(service_ctx& ctx) STATICLIB_NOEXCEPT {
+    start_service(ctx, state_start_pending, state_running, 0);
+    auto& reporter = ctx.get_reporter();
+    while (state_stopped != reporter.current_state()) {
+        auto control_step = ctx.get_controls().take(reporter.current_state());
+        switch (control_step) {
+        case control_stop:
+        case control_shutdown:
+        case control_preshutdown:
+            stop_service(ctx, state_stop_pending, state_stopped, control_step);
+            break;
+        case control_pause: stop_service(ctx, state_pause_pending, state_paused, control_step); break;
+        case control_continue: start_service(ctx, state_continue_pending, state_running, control_step); break;
+        default: break;
+        }
+    }
+}
+
+void service_main(const std::string& service_name) STATICLIB_NOEXCEPT {
+    trace_span span("service_main", "scm");
+    auto ctx = find_service(service_name);
+    if (nullptr == ctx.get()) {
+        // not hosted in this process
+        return;
+    }
+    ctx->prepare_launch();
     // Register the handler function for the service
-    auto ha = RegisterServiceCtrlHandlerW(static_ctx().get_wname().c_str(), service_control_handler);
-    if (nullptr == ha) {
-        static_ctx().log(TRACEMSG(
-                "Fatal error on RegisterServiceCtrlHandlerW: [" + sl::utils::errcode_to_string(GetLastError()) + "]"));
+    try {
+        ctx->get_backend().register_control_handler(service_name, [ctx](uint32_t control_step,
+                uint32_t event_type, uint32_t event_data) {
+            return service_control_handler(*ctx, control_step, event_type, event_data);
+        });
+    } catch (const std::exception& e) {
+        ctx->emit(event_handler_registration_failed, severity_fatal, 0, 0, 0, e.what());
+        ctx->close_events();
         ::exit(-1);
     }
-    static_ctx().set_status_handle(ha);
-    start_service(SERVICE_START_PENDING, SERVICE_RUNNING);
+    ctx->start_worker([ctx] {
+        lifecycle_worker(*ctx);
+    });
+}
+
+// empty string is returned if the state was reached
+std::string describe_wait_failure(const std::string& service_name, uint32_t state, uint32_t timeout_millis,
+        const service_status& st) {
+    if (state == st.current_state) {
+        return std::string();
+    }
+    if (state_stopped == st.current_state) {
+        return TRACEMSG("Service stopped before reaching state: [" + state_to_string(state) + "]," +
+                " name: [" + service_name + "]," +
+                " exit code: [" + sl::support::to_string(st.win32_exit_code) + "]," +
+                " service specific exit code: [" + sl::support::to_string(st.service_specific_exit_code) + "]");
+    }
+    return TRACEMSG("Timeout waiting for service state: [" + state_to_string(state) + "]," +
+            " name: [" + service_name + "]," +
+            " timeout: [" + sl::support::to_string(timeout_millis) + "]," +
+            " current state: [" + state_to_string(st.current_state) + "]," +
+            " checkpoint: [" + sl::support::to_string(st.check_point) + "]," +
+            " wait hint: [" + sl::support::to_string(st.wait_hint) + "]");
+}
+
+std::future<service_status> await_state(std::shared_ptr<scm_connection> scm, const std::string& service_name,
+        uint32_t state, uint32_t timeout_millis) {
+    return std::async(std::launch::async, [scm, service_name, state, timeout_millis] {
+        auto st = scm->wait_for_status(service_name, state, timeout_millis);
+        auto err = describe_wait_failure(service_name, state, timeout_millis, st);
+        if (!err.empty()) throw winservice_exception(err);
+        return st;
+    });
+}
+
+void await_state(std::shared_ptr<scm_connection> scm, const std::string& service_name,
+        uint32_t state, uint32_t timeout_millis,
+        std::function<void(const service_status&, const std::string&)> callback) {
+    auto th = std::thread([scm, service_name, state, timeout_millis, callback] {
+        service_status st;
+        std::string err;
+        try {
+            st = scm->wait_for_status(service_name, state, timeout_millis);
+            err = describe_wait_failure(service_name, state, timeout_millis, st);
+        } catch (const std::exception& e) {
+            err = TRACEMSG(e.what() + "\nError waiting for service state: [" + state_to_string(state) + "]");
+        }
+        try {
+            callback(st, err);
+        } catch (...) {
+            // detached thread, cannot be reported
+        }
+    });
+    th.detach();
 }
 
 } // namespace
 
 void install_service(const std::string& service_name, const std::string& display_name,
     const std::string& account, const std::string& password,
-    const std::string& start_type, const std::string& dependencies) {
-    auto scm = std::unique_ptr<SC_HANDLE__, service_handle_deleter>(
-            OpenSCManagerW(NULL, NULL, SC_MANAGER_CONNECT | SC_MANAGER_CREATE_SERVICE),
-            service_handle_deleter());
-    if (nullptr == scm.get()) throw winservice_exception(TRACEMSG(
-            "Cannot open SCM, error: [" + sl::utils::errcode_to_string(GetLastError()) + "]"));
-    std::string exec_path = sl::utils::current_executable_path();
-    auto stype = resolve_start_type(start_type);
-    auto service = std::unique_ptr<SC_HANDLE__, service_handle_deleter>(
-            CreateServiceW(
-                scm.get(),                          // SCManager database
-                sl::utils::widen(service_name).c_str(),    // Name of service
-                sl::utils::widen(display_name).c_str(),    // Name to display
-                SERVICE_QUERY_STATUS,               // Desired access
-                SERVICE_WIN32_OWN_PROCESS,          // Service type
-                stype,                              // Service start type
-                SERVICE_ERROR_NORMAL,               // Error control type
-                sl::utils::widen(exec_path).c_str(),       // Service's binary
-                nullptr,                            // No load ordering group
-                nullptr,                            // No tag identifier
-                dependencies.empty() ? nullptr :
-                sl::utils::widen(dependencies).c_str(),   // Dependencies
-                sl::utils::widen(account).c_str(),         // Service running account
-                password.empty() ? nullptr :
-                sl::utils::widen(password).c_str()        // Password of the account
-            ), service_handle_deleter());
-    if (nullptr == service.get()) throw winservice_exception(TRACEMSG(
-            "Cannot create service, error: [" + sl::utils::errcode_to_string(GetLastError()) + "]"));
+    const std::string& start_type, const std::string& dependencies,
+    const std::string& service_type) {
+    service_config conf;
+    conf.name = service_name;
+    conf.display_name = display_name;
+    conf.binary_path = sl::utils::current_executable_path();
+    conf.account = account;
+    conf.password = password;
+    conf.service_type = resolve_service_type(service_type);
+    conf.start_type = resolve_start_type(start_type);
+    conf.delayed_auto_start = "SERVICE_DELAYED_AUTO_START" == start_type;
+    if (!dependencies.empty()) {
+        conf.dependencies.push_back(dependencies);
+    }
+    get_scm_backend()->connect()->install_service(conf);
+}
+
+void install_service(const service_config& config) {
+    if (!config.binary_path.empty()) {
+        get_scm_backend()->connect()->install_service(config);
+        return;
+    }
+    auto conf = config;
+    conf.binary_path = sl::utils::current_executable_path();
+    get_scm_backend()->connect()->install_service(conf);
 }
 
 void uninstall_service(const std::string& service_name) {
-    auto scm = std::unique_ptr<SC_HANDLE__, service_handle_deleter>(
-            OpenSCManagerW(NULL, NULL, SC_MANAGER_CONNECT),
-            service_handle_deleter());
-    if (nullptr == scm.get()) throw winservice_exception(TRACEMSG(
-            "Cannot open SCM, error: [" + sl::utils::errcode_to_string(GetLastError()) + "]"));
-    auto service = std::unique_ptr<SC_HANDLE__, service_handle_deleter>(
-            OpenServiceW(scm.get(), sl::utils::widen(service_name).c_str(), SERVICE_QUERY_STATUS | DELETE), service_handle_deleter());
-    if (nullptr == service.get()) throw winservice_exception(TRACEMSG(
-            "Cannot open service, name: [" + service_name + "], error: [" + sl::utils::errcode_to_string(GetLastError()) + "]"));
-    SERVICE_STATUS_PROCESS ssp;
-    DWORD len;
-    auto err_query = QueryServiceStatusEx(service.get(), SC_STATUS_PROCESS_INFO,
-            reinterpret_cast<BYTE*> (std::addressof(ssp)), sizeof(SERVICE_STATUS_PROCESS), std::addressof(len));
-    if (!err_query) throw winservice_exception(TRACEMSG(
-            "Error querying service status, name: [" + service_name + "]," +
-            " error: [" + sl::utils::errcode_to_string(GetLastError()) + "]"));
-    if (SERVICE_STOPPED != ssp.dwCurrentState) throw winservice_exception(TRACEMSG(
+    auto scm = get_scm_backend()->connect();
+    auto st = scm->query_service_status(service_name);
+    if (state_stopped != st.current_state) throw winservice_exception(TRACEMSG(
             "Error uninstalling service, name: [" + service_name + "],"
             " service must be stopped before the uninstallation"));
-    auto success = DeleteService(service.get());
-    if (!success) throw winservice_exception(TRACEMSG(
-            "Error uninstalling service, name: [" + service_name + "]," +
-            " error: [" + sl::utils::errcode_to_string(GetLastError()) + "]"));
+    scm->uninstall_service(service_name);
+}
+
+void request_service_stop(const std::string& service_name, uint32_t service_specific_exit_code) {
+    auto ctx = find_service(service_name);
+    if (nullptr == ctx.get()) throw winservice_exception(TRACEMSG(
+            "Service is not running in this process, name: [" + service_name + "]"));
+    ctx->request_stop(service_specific_exit_code);
+}
+
+reconcile_result reconcile_service(const service_config& desired) {
+    return scm_session(get_scm_backend(), 1).reconcile_service(desired);
 }
 
 void start_service(const std::string& service_name) {
-    auto scm = std::unique_ptr<SC_HANDLE__, service_handle_deleter>(
-        OpenSCManagerW(NULL, NULL, SC_MANAGER_CONNECT),
-        service_handle_deleter());
-    if (nullptr == scm.get()) throw winservice_exception(TRACEMSG(
-        "Cannot open SCM, error: [" + sl::utils::errcode_to_string(GetLastError()) + "]"));
-    auto service = std::unique_ptr<SC_HANDLE__, service_handle_deleter>(
-        OpenServiceW(scm.get(), sl::utils::widen(service_name).c_str(), SERVICE_START), service_handle_deleter());
-    if (nullptr == service.get()) throw winservice_exception(TRACEMSG(
-        "Cannot open service, name: [" + service_name + "], error: [" + sl::utils::errcode_to_string(GetLastError()) + "]"));
-    auto success = StartService(service.get(), 0, nullptr);
-    if (!success) throw winservice_exception(TRACEMSG(
-            "Error starting service, name: [" + service_name + "]," +
-            " error: [" + sl::utils::errcode_to_string(GetLastError()) + "]"));
+    get_scm_backend()->connect()->start_service(service_name);
 }
 
 void stop_service(const std::string& service_name) {
-    auto scm = std::unique_ptr<SC_HANDLE__, service_handle_deleter>(
-        OpenSCManagerW(NULL, NULL, SC_MANAGER_CONNECT),
-        service_handle_deleter());
-    if (nullptr == scm.get()) throw winservice_exception(TRACEMSG(
-        "Cannot open SCM, error: [" + sl::utils::errcode_to_string(GetLastError()) + "]"));
-    auto service = std::unique_ptr<SC_HANDLE__, service_handle_deleter>(
-        OpenServiceW(scm.get(), sl::utils::widen(service_name).c_str(), SERVICE_STOP), service_handle_deleter());
-    if (nullptr == service.get()) throw winservice_exception(TRACEMSG(
-        "Cannot open service, name: [" + service_name + "], error: [" + sl::utils::errcode_to_string(GetLastError()) + "]"));
-    SERVICE_STATUS ss;
-    auto success = ControlService(service.get(), SERVICE_CONTROL_STOP, std::addressof(ss));
-    if (!success) throw winservice_exception(TRACEMSG(
-            "Error stopping service, name: [" + service_name + "]," +
-            " error: [" + sl::utils::errcode_to_string(GetLastError()) + "]"));
+    get_scm_backend()->connect()->control_service(service_name, control_stop);
+}
+
+std::future<service_status> start_service_async(const std::string& service_name, uint32_t timeout_millis) {
+    auto scm = std::shared_ptr<scm_connection>(get_scm_backend()->connect());
+    scm->start_service(service_name);
+    return await_state(std::move(scm), service_name, state_running, timeout_millis);
+}
+
+void start_service_async(const std::string& service_name, uint32_t timeout_millis,
+        std::function<void(const service_status&, const std::string&)> callback) {
+    if (!callback) throw winservice_exception(TRACEMSG(
+            "Invalid empty completion callback specified"));
+    auto scm = std::shared_ptr<scm_connection>(get_scm_backend()->connect());
+    scm->start_service(service_name);
+    await_state(std::move(scm), service_name, state_running, timeout_millis, std::move(callback));
+}
+
+std::future<service_status> stop_service_async(const std::string& service_name, uint32_t timeout_millis) {
+    auto scm = std::shared_ptr<scm_connection>(get_scm_backend()->connect());
+    scm->control_service(service_name, control_stop);
+    return await_state(std::move(scm), service_name, state_stopped, timeout_millis);
+}
+
+void stop_service_async(const std::string& service_name, uint32_t timeout_millis,
+        std::function<void(const service_status&, const std::string&)> callback) {
+    if (!callback) throw winservice_exception(TRACEMSG(
+            "Invalid empty completion callback specified"));
+    auto scm = std::shared_ptr<scm_connection>(get_scm_backend()->connect());
+    scm->control_service(service_name, control_stop);
+    await_state(std::move(scm), service_name, state_stopped, timeout_millis, std::move(callback));
 }
 
 void start_service_and_wait(const std::string& service_name, std::function<void()> starter,
         std::function<void()> stopper, std::function<void(const std::string&)> logger) {
-    set_static_context(service_name, std::move(starter), std::move(stopper), std::move(logger));
-    std::wstring name = sl::utils::widen(service_name);
-    SERVICE_TABLE_ENTRYW st[] = {
-        { std::addressof(name.front()), service_main },
-        { nullptr, nullptr }
+    service_lifecycle lifecycle;
+    lifecycle.starter = [starter](service_transition&) {
+        starter();
     };
+    lifecycle.stopper = [stopper](service_transition&) {
+        stopper();
+    };
+    lifecycle.logger = std::move(logger);
+    start_service_and_wait(service_name, std::move(lifecycle));
+}
 
-    // Connects the main thread of a service process to the service control 
-    // manager, which causes the thread to be the service control dispatcher 
-    // thread for the calling process. This call returns when the service has 
-    // stopped. The process should simply terminate when the call returns.
-    auto success = StartServiceCtrlDispatcherW(st);
-    if (!success) throw winservice_exception(TRACEMSG(
-        "Error starting service, name: [" + service_name + "]," +
-        " error: [" + sl::utils::errcode_to_string(GetLastError()) + "]"));
+void start_service_and_wait(const std::string& service_name, service_lifecycle lifecycle) {
+    auto services = std::vector<std::pair<std::string, service_lifecycle>>();
+    services.emplace_back(service_name, std::move(lifecycle));
+    start_services_and_wait(std::move(services));
 }
 
-} // namespace
+void start_services_and_wait(std::vector<std::pair<std::string, service_lifecycle>> services) {
+    if (services.empty()) throw winservice_exception(TRACEMSG(
+            "Invalid empty list of services specified"));
+    auto backend = get_scm_backend();
+    auto type = 1 == services.size() ? service_type_own_process : service_type_share_process;
+    auto ctxs = std::vector<std::shared_ptr<service_ctx>>();
+    auto names = std::vector<std::string>();
+    for (auto& pa : services) {
+        for (auto& name : names) {
+            if (pa.first == name) throw winservice_exception(TRACEMSG(
+                    "Duplicate service name specified: [" + name + "]"));
+        }
+        names.push_back(pa.first);
+        ctxs.emplace_back(std::make_shared<service_ctx>(pa.first, backend, std::move(pa.second), type));
+    }
+    register_services(ctxs);
+    // allows to run the services again after they were stopped
+    auto deferred = sl::support::defer([&ctxs]() STATICLIB_NOEXCEPT {
+        unregister_services(ctxs);
+    });
+    backend->run_dispatcher(names, service_main);
+    for (auto& ctx : ctxs) {
+        ctx->join_worker();
+        ctx->close_events();
+    }
 }
 
-#endif // STATICLIB_WINDOWS
+} // namespace
+}
@@ -0,0 +1,387 @@
+/*
+ * Copyright 2026, alex at staticlibs.net
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * File:   posix_scm.cpp
+ * Author: alex
+ *
+ * Created on October 17, 2026, 10:32 AM
+ */
+
+#include "staticlib/winservice/posix_scm.hpp"
+#ifndef STATICLIB_WINDOWS
+
+#include <cerrno>
+#include <chrono>
+#include <condition_variable>
+#include <csignal>
+#include <cstring>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <fcntl.h>
+#include <signal.h>
+#include <unistd.h>
+
+#include "staticlib/support.hpp"
+
+#include "staticlib/winservice/notify_socket.hpp"
+
+namespace staticlib {
+namespace winservice {
+
+namespace { // anonymous
+
+// used from the signal handler, must not require initialization
+volatile sig_atomic_t static_pipe_write_fd = -1;
+
+// control code, event type, event data
+typedef std::function<bool(uint32_t, uint32_t, uint32_t)> handler_fun;
+
+// written into the pipe to wake up the dispatcher
+const unsigned char wakeup_byte = 0;
+
+// written into the pipe by the watchdog timer, not a signal number
+const unsigned char watchdog_byte = 0xff;
+
+class dispatcher_state {
+public:
+    bool running = false;
+    std::vector<std::string> service_names;
+    std::map<std::string, handler_fun> handlers;
+    std::map<std::string, std::vector<uint32_t>> pending_controls;
+    std::map<std::string, service_status> statuses;
+    std::map<std::string, std::chrono::steady_clock::time_point> pending_since;
+    std::shared_ptr<notify_socket> notifier;
+    bool ready_sent = false;
+};
+
+std::mutex& static_mutex() {
+    static std::mutex mutex{};
+    return mutex;
+}
+
+dispatcher_state& static_state() {
+    static dispatcher_state state{};
+    return state;
+}
+
+const std::vector<int>& handled_signals() {
+    static std::vector<int> vec = {SIGTERM, SIGINT, SIGTSTP, SIGCONT, SIGHUP};
+    return vec;
+}
+
+void signal_trampoline(int signo) {
+    // only async-signal-safe calls here
+    auto saved_errno = errno;
+    int fd = static_pipe_write_fd;
+    if (fd >= 0) {
+        unsigned char byte = static_cast<unsigned char>(signo);
+        auto written = ::write(fd, &byte, 1);
+        (void) written;
+    }
+    errno = saved_errno;
+}
+
+uint32_t signal_to_control(int signo) {
+    switch (signo) {
+    case SIGTERM: return control_stop;
+    case SIGINT: return control_stop;
+    case SIGTSTP: return control_pause;
+    case SIGCONT: return control_continue;
+    case SIGHUP: return control_paramchange;
+    default: return 0;
+    }
+}
+
+void wakeup_dispatcher() {
+    int fd = static_pipe_write_fd;
+    if (fd >= 0) {
+        auto written = ::write(fd, &wakeup_byte, 1);
+        (void) written;
+    }
+}
+
+// must be called under lock
+bool all_stopped(dispatcher_state& st) {
+    for (auto& name : st.service_names) {
+        auto it = st.statuses.find(name);
+        if (st.statuses.end() == it || state_stopped != it->second.current_state) return false;
+    }
+    return true;
+}
+
+// must be called under lock
+bool all_running(dispatcher_state& st) {
+    for (auto& name : st.service_names) {
+        auto it = st.statuses.find(name);
+        if (st.statuses.end() == it || state_running != it->second.current_state) return false;
+    }
+    return true;
+}
+
+bool is_pending(uint32_t state) {
+    switch (state) {
+    case state_start_pending:
+    case state_stop_pending:
+    case state_pause_pending:
+    case state_continue_pending:
+        return true;
+    default:
+        return false;
+    }
+}
+
+// process is alive if the dispatcher loop is running and no transition
+// is pending longer than its wait hint, heartbeat checkpoints are published
+// even when the callback is stuck, so they are not used here,
+// must be called under lock
+bool is_alive(dispatcher_state& st) {
+    auto now = std::chrono::steady_clock::now();
+    for (auto& en : st.pending_since) {
+        auto wait_hint = std::chrono::milliseconds(st.statuses[en.first].wait_hint);
+        if (wait_hint.count() > 0 && now - en.second > wait_hint) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// maps status transition onto notification protocol assignments,
+// must be called under lock
+std::string notify_message(dispatcher_state& st, const std::string& service_name,
+        const service_status& prev, const service_status& status) {
+    auto res = std::string();
+    if (prev.current_state != status.current_state) {
+        if (state_running == status.current_state && !st.ready_sent && all_running(st)) {
+            // process is ready only when all hosted services are running
+            res.append("READY=1\n");
+            st.ready_sent = true;
+        }
+        if (state_stop_pending == status.current_state) {
+            res.append("STOPPING=1\n");
+        }
+        res.append("STATUS=").append(service_name).append(": ")
+                .append(state_to_string(status.current_state));
+        // exit codes are Win32 ones, 'ERRNO=' is reserved for errno values
+        if (state_stopped == status.current_state && 0 != status.win32_exit_code) {
+            res.append(", exit code: ").append(sl::support::to_string(status.win32_exit_code));
+            if (exit_code_service_specific == status.win32_exit_code) {
+                res.append(", service-specific exit code: ")
+                        .append(sl::support::to_string(status.service_specific_exit_code));
+            }
+        }
+        res.append("\n");
+    }
+    // each checkpoint of the pending operation extends the timeout by the wait hint
+    if (is_pending(status.current_state) && status.wait_hint > 0 &&
+            (prev.current_state != status.current_state || prev.check_point != status.check_point)) {
+        res.append("EXTEND_TIMEOUT_USEC=")
+                .append(sl::support::to_string(static_cast<uint64_t>(status.wait_hint) * 1000))
+                .append("\n");
+    }
+    return res;
+}
+
+// controls received before the handler registration are kept until then
+std::vector<std::pair<handler_fun, uint32_t>> take_deliveries(dispatcher_state& st, uint32_t control) {
+    auto res = std::vector<std::pair<handler_fun, uint32_t>>();
+    for (auto& name : st.service_names) {
+        if (0 != control) {
+            st.pending_controls[name].push_back(control);
+        }
+        auto it = st.handlers.find(name);
+        if (st.handlers.end() == it) continue;
+        for (auto co : st.pending_controls[name]) {
+            res.emplace_back(it->second, co);
+        }
+        st.pending_controls[name].clear();
+    }
+    return res;
+}
+
+void send_watchdog_ping(notify_socket& notifier) {
+    {
+        std::lock_guard<std::mutex> guard{static_mutex()};
+        if (!is_alive(static_state())) return;
+    }
+    try {
+        notifier.notify("WATCHDOG=1");
+    } catch (const std::exception&) {
+        // service manager will restart the process if pings are lost
+    }
+}
+
+} // namespace
+
+std::unique_ptr<scm_connection> posix_scm::connect() {
+    throw winservice_exception(TRACEMSG(
+            "Service management is not supported by POSIX backend, use init system tools instead"));
+}
+
+void posix_scm::run_dispatcher(const std::vector<std::string>& service_names,
+        std::function<void(const std::string&)> service_main) {
+    // 'NOTIFY_SOCKET' is checked before taking over the signals
+    auto notifier = std::make_shared<notify_socket>();
+    int fds[2];
+    {
+        std::lock_guard<std::mutex> guard{static_mutex()};
+        auto& st = static_state();
+        if (st.running) throw winservice_exception(TRACEMSG(
+                "Service dispatcher is already running in this process"));
+        if (0 != ::pipe(fds)) throw winservice_exception(TRACEMSG(
+                "Error creating signal pipe, error: [" + std::string(std::strerror(errno)) + "]"));
+        ::fcntl(fds[0], F_SETFD, FD_CLOEXEC);
+        ::fcntl(fds[1], F_SETFD, FD_CLOEXEC);
+        // signal handler must never block
+        ::fcntl(fds[1], F_SETFL, ::fcntl(fds[1], F_GETFL) | O_NONBLOCK);
+        st = dispatcher_state();
+        st.running = true;
+        st.service_names = service_names;
+        st.notifier = notifier;
+        static_pipe_write_fd = fds[1];
+    }
+    auto old_actions = std::vector<struct sigaction>(handled_signals().size());
+    for (size_t i = 0; i < handled_signals().size(); i++) {
+        struct sigaction sa;
+        std::memset(std::addressof(sa), '\0', sizeof(sa));
+        sa.sa_handler = signal_trampoline;
+        sigemptyset(std::addressof(sa.sa_mask));
+        sa.sa_flags = SA_RESTART;
+        ::sigaction(handled_signals()[i], std::addressof(sa), std::addressof(old_actions[i]));
+    }
+    auto threads = std::vector<std::thread>();
+    std::mutex watchdog_mutex;
+    std::condition_variable watchdog_cv;
+    bool watchdog_stop = false;
+    std::thread watchdog;
+    auto deferred = sl::support::defer([&]() STATICLIB_NOEXCEPT {
+        for (size_t i = 0; i < handled_signals().size(); i++) {
+            ::sigaction(handled_signals()[i], std::addressof(old_actions[i]), nullptr);
+        }
+        for (auto& th : threads) {
+            th.join();
+        }
+        if (watchdog.joinable()) {
+            {
+                std::lock_guard<std::mutex> guard{watchdog_mutex};
+                watchdog_stop = true;
+            }
+            watchdog_cv.notify_all();
+            watchdog.join();
+        }
+        std::lock_guard<std::mutex> guard{static_mutex()};
+        static_pipe_write_fd = -1;
+        ::close(fds[0]);
+        ::close(fds[1]);
+        static_state() = dispatcher_state();
+    });
+
+    // keep-alive pings are requested twice per interval specified by the service manager,
+    // they are sent by the dispatcher loop, so a stuck control handler stops them
+    auto watchdog_usec = notify_socket::watchdog_interval_usec();
+    if (notifier->is_enabled() && watchdog_usec > 0) {
+        watchdog = std::thread([&, watchdog_usec] {
+            auto period = std::chrono::microseconds(watchdog_usec / 2);
+            std::unique_lock<std::mutex> lock{watchdog_mutex};
+            while (!watchdog_cv.wait_for(lock, period, [&] { return watchdog_stop; })) {
+                int fd = static_pipe_write_fd;
+                if (fd >= 0) {
+                    auto written = ::write(fd, &watchdog_byte, 1);
+                    (void) written;
+                }
+            }
+        });
+    }
+
+    // services are started by the "init system" right away
+    for (auto& name : service_names) {
+        threads.emplace_back([service_main, name] {
+            service_main(name);
+        });
+    }
+
+    unsigned char buf[64];
+    for (;;) {
+        auto count = ::read(fds[0], buf, sizeof(buf));
+        if (count < 0 && EINTR == errno) continue;
+        if (count <= 0) throw winservice_exception(TRACEMSG(
+                "Error reading signal pipe, error: [" + std::string(std::strerror(errno)) + "]"));
+        for (ssize_t i = 0; i < count; i++) {
+            if (watchdog_byte == buf[i]) {
+                send_watchdog_ping(*notifier);
+                continue;
+            }
+            auto deliveries = std::vector<std::pair<handler_fun, uint32_t>>();
+            {
+                std::lock_guard<std::mutex> guard{static_mutex()};
+                deliveries = take_deliveries(static_state(), signal_to_control(buf[i]));
+            }
+            // handlers are called on the dispatcher thread
+            for (auto& pa : deliveries) {
+                pa.first(pa.second, 0, 0);
+            }
+        }
+        std::lock_guard<std::mutex> guard{static_mutex()};
+        if (all_stopped(static_state())) break;
+    }
+}
+
+void posix_scm::register_control_handler(const std::string& service_name,
+        std::function<bool(uint32_t, uint32_t, uint32_t)> handler) {
+    std::lock_guard<std::mutex> guard{static_mutex()};
+    auto& st = static_state();
+    if (!st.running) throw winservice_exception(TRACEMSG(
+            "Error registering control handler, dispatcher is not running, name: [" + service_name + "]"));
+    st.handlers[service_name] = std::move(handler);
+    // delivers controls received before the registration
+    wakeup_dispatcher();
+}
+
+void posix_scm::set_service_status(const std::string& service_name, const service_status& status) {
+    std::lock_guard<std::mutex> guard{static_mutex()};
+    auto& st = static_state();
+    if (0 == st.handlers.count(service_name)) throw winservice_exception(TRACEMSG(
+            "Error changing status to: [" + sl::support::to_string(status.current_state) + "]," +
+            " control handler is not registered, name: [" + service_name + "]"));
+    auto prev = st.statuses[service_name];
+    st.statuses[service_name] = status;
+    if (!is_pending(status.current_state)) {
+        st.pending_since.erase(service_name);
+    } else if (prev.current_state != status.current_state) {
+        st.pending_since[service_name] = std::chrono::steady_clock::now();
+    }
+    if (state_stopped == status.current_state) {
+        wakeup_dispatcher();
+    }
+    auto msg = notify_message(st, service_name, prev, status);
+    if (!msg.empty()) {
+        try {
+            st.notifier->notify(msg);
+        } catch (const std::exception&) {
+            // notifications are best-effort, the same as with 'sd_notify',
+            // service manager applies its own timeouts if they are lost
+        }
+    }
+}
+
+} // namespace
+}
+
+#endif // !STATICLIB_WINDOWS
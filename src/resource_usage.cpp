@@ -0,0 +1,164 @@
+/*
+ * Copyright 2026, alex at staticlibs.net
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * File:   resource_usage.cpp
+ * Author: alex
+ *
+ * Created on October 17, 2026, 10:35 AM
+ */
+
+#include "staticlib/winservice/resource_usage.hpp"
+
+#include <algorithm>
+#include <fstream>
+
+#include "staticlib/config.hpp"
+#include "staticlib/support.hpp"
+
+#ifdef STATICLIB_WINDOWS
+#include "staticlib/support/windows.hpp"
+#include <psapi.h>
+#else // !STATICLIB_WINDOWS
+#include <dirent.h>
+#include <sys/resource.h>
+#include <sys/time.h>
+#include <unistd.h>
+#endif // STATICLIB_WINDOWS
+
+namespace staticlib {
+namespace winservice {
+
+namespace { // anonymous
+
+#ifdef STATICLIB_WINDOWS
+
+int64_t filetime_to_micros(const FILETIME& ft) {
+    ULARGE_INTEGER ul;
+    ul.LowPart = ft.dwLowDateTime;
+    ul.HighPart = ft.dwHighDateTime;
+    // 100-nanosecond intervals
+    return static_cast<int64_t>(ul.QuadPart / 10);
+}
+
+#else // !STATICLIB_WINDOWS
+
+int64_t timeval_to_micros(const struct timeval& tv) {
+    return static_cast<int64_t>(tv.tv_sec) * 1000000 + static_cast<int64_t>(tv.tv_usec);
+}
+
+int64_t count_open_fds() {
+    auto dir = opendir("/proc/self/fd");
+    if (nullptr == dir) {
+        dir = opendir("/dev/fd");
+    }
+    if (nullptr == dir) {
+        return 0;
+    }
+    int64_t count = 0;
+    while (auto en = readdir(dir)) {
+        if ('.' != en->d_name[0]) {
+            count += 1;
+        }
+    }
+    closedir(dir);
+    // descriptor of the directory itself
+    return std::max(count - 1, static_cast<int64_t>(0));
+}
+
+int64_t read_resident_bytes() {
+    // second field is resident pages, absent on non-Linux systems
+    std::ifstream statm("/proc/self/statm");
+    long long size = 0;
+    long long resident = 0;
+    if (!(statm >> size >> resident)) {
+        return 0;
+    }
+    return static_cast<int64_t>(resident) * static_cast<int64_t>(sysconf(_SC_PAGESIZE));
+}
+
+#endif // STATICLIB_WINDOWS
+
+} // namespace
+
+resource_usage sample_resource_usage() {
+    resource_usage res;
+#ifdef STATICLIB_WINDOWS
+    auto process = GetCurrentProcess();
+    FILETIME creation;
+    FILETIME exit;
+    FILETIME kernel;
+    FILETIME user;
+    if (0 != GetProcessTimes(process, std::addressof(creation), std::addressof(exit),
+            std::addressof(kernel), std::addressof(user))) {
+        res.cpu_user_micros = filetime_to_micros(user);
+        res.cpu_system_micros = filetime_to_micros(kernel);
+    }
+    PROCESS_MEMORY_COUNTERS pmc;
+    if (0 != K32GetProcessMemoryInfo(process, std::addressof(pmc), sizeof(pmc))) {
+        res.resident_bytes = static_cast<int64_t>(pmc.WorkingSetSize);
+        res.peak_resident_bytes = static_cast<int64_t>(pmc.PeakWorkingSetSize);
+        res.page_faults = static_cast<int64_t>(pmc.PageFaultCount);
+    }
+    DWORD handles = 0;
+    if (0 != GetProcessHandleCount(process, std::addressof(handles))) {
+        res.open_handles = static_cast<int64_t>(handles);
+    }
+#else // !STATICLIB_WINDOWS
+    struct rusage ru;
+    if (0 == getrusage(RUSAGE_SELF, std::addressof(ru))) {
+        res.cpu_user_micros = timeval_to_micros(ru.ru_utime);
+        res.cpu_system_micros = timeval_to_micros(ru.ru_stime);
+#ifdef __APPLE__
+        res.peak_resident_bytes = static_cast<int64_t>(ru.ru_maxrss);
+#else
+        // kilobytes on Linux and BSDs
+        res.peak_resident_bytes = static_cast<int64_t>(ru.ru_maxrss) * 1024;
+#endif
+        res.page_faults = static_cast<int64_t>(ru.ru_minflt + ru.ru_majflt);
+        res.major_page_faults = static_cast<int64_t>(ru.ru_majflt);
+    }
+    res.resident_bytes = read_resident_bytes();
+    res.open_handles = count_open_fds();
+#endif // STATICLIB_WINDOWS
+    return res;
+}
+
+resource_usage resource_usage_delta(const resource_usage& before, const resource_usage& after) {
+    resource_usage res;
+    res.cpu_user_micros = after.cpu_user_micros - before.cpu_user_micros;
+    res.cpu_system_micros = after.cpu_system_micros - before.cpu_system_micros;
+    res.resident_bytes = after.resident_bytes - before.resident_bytes;
+    res.peak_resident_bytes = after.peak_resident_bytes - before.peak_resident_bytes;
+    res.page_faults = after.page_faults - before.page_faults;
+    res.major_page_faults = after.major_page_faults - before.major_page_faults;
+    res.open_handles = after.open_handles - before.open_handles;
+    return res;
+}
+
+std::string format_resource_usage(const resource_usage& usage) {
+    return std::string() +
+            "cpu user millis: [" + sl::support::to_string(usage.cpu_user_micros / 1000) + "]," +
+            " cpu system millis: [" + sl::support::to_string(usage.cpu_system_micros / 1000) + "]," +
+            " resident KB: [" + sl::support::to_string(usage.resident_bytes / 1024) + "]," +
+            " peak resident KB: [" + sl::support::to_string(usage.peak_resident_bytes / 1024) + "]," +
+            " page faults: [" + sl::support::to_string(usage.page_faults) + "]," +
+            " major page faults: [" + sl::support::to_string(usage.major_page_faults) + "]," +
+            " open handles: [" + sl::support::to_string(usage.open_handles) + "]";
+}
+
+} // namespace
+}
@@ -0,0 +1,76 @@
+/*
+ * Copyright 2026, alex at staticlibs.net
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * File:   scm_backend.cpp
+ * Author: alex
+ *
+ * Created on October 17, 2026, 11:32 AM
+ */
+
+#include "staticlib/winservice/scm_backend.hpp"
+
+#include <mutex>
+
+#include "staticlib/config.hpp"
+#include "staticlib/support.hpp"
+
+#include "staticlib/winservice/posix_scm.hpp"
+#include "staticlib/winservice/windows_scm.hpp"
+
+namespace staticlib {
+namespace winservice {
+
+namespace { // anonymous
+
+std::mutex& static_backend_mutex() {
+    static std::mutex mutex{};
+    return mutex;
+}
+
+std::shared_ptr<scm_backend>& static_backend() {
+    static std::shared_ptr<scm_backend> backend{};
+    return backend;
+}
+
+std::shared_ptr<scm_backend> create_default_backend() {
+#ifdef STATICLIB_WINDOWS
+    return std::make_shared<windows_scm>();
+#else // !STATICLIB_WINDOWS
+    return std::make_shared<posix_scm>();
+#endif // STATICLIB_WINDOWS
+}
+
+} // namespace
+
+void set_scm_backend(std::shared_ptr<scm_backend> backend) {
+    std::lock_guard<std::mutex> guard{static_backend_mutex()};
+    static_backend() = std::move(backend);
+}
+
+std::shared_ptr<scm_backend> get_scm_backend() {
+    std::lock_guard<std::mutex> guard{static_backend_mutex()};
+    auto& backend = static_backend();
+    if (nullptr == backend.get()) {
+        backend = create_default_backend();
+    }
+    if (nullptr == backend.get()) throw winservice_exception(TRACEMSG(
+            "SCM backend is not available on this platform, use 'set_scm_backend' to specify one"));
+    return backend;
+}
+
+} // namespace
+}
@@ -0,0 +1,154 @@
+/*
+ * Copyright 2026, alex at staticlibs.net
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * File:   scm_session.cpp
+ * Author: alex
+ *
+ * Created on October 17, 2026, 9:42 AM
+ */
+
+#include "staticlib/winservice/scm_session.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+
+#include "staticlib/config.hpp"
+#include "staticlib/support.hpp"
+#include "staticlib/utils.hpp"
+
+namespace staticlib {
+namespace winservice {
+
+scm_session::scm_session(uint32_t max_concurrency) :
+scm_session(get_scm_backend(), max_concurrency) { }
+
+scm_session::scm_session(std::shared_ptr<scm_backend> backend, uint32_t max_concurrency) :
+backend(std::move(backend)),
+connection(this->backend->connect().release()),
+max_concurrency(max_concurrency > 0 ? max_concurrency : 1) { }
+
+void scm_session::install_service(const service_config& config) {
+    connection->install_service(config);
+}
+
+reconcile_result scm_session::reconcile_service(const service_config& desired) {
+    reconcile_result res;
+    res.service_name = desired.name;
+    if (!connection->is_service_installed(desired.name)) {
+        // same default as in 'install_service'
+        auto conf = desired;
+        if (conf.binary_path.empty()) conf.binary_path = sl::utils::current_executable_path();
+        connection->install_service(conf);
+        res.installed = true;
+        return res;
+    }
+    auto current = connection->query_service_config(desired.name);
+    res.changed_fields = diff_service_config(current, desired);
+    if (0 == res.changed_fields) {
+        return res;
+    }
+    // unspecified fields are passed to SCM unchanged
+    auto merged = desired;
+    if (merged.display_name.empty()) merged.display_name = current.display_name;
+    if (merged.binary_path.empty()) merged.binary_path = current.binary_path;
+    if (merged.account.empty()) merged.account = current.account;
+    if (0 == merged.preshutdown_timeout_millis) merged.preshutdown_timeout_millis = current.preshutdown_timeout_millis;
+    connection->change_service_config(merged, res.changed_fields);
+    return res;
+}
+
+void scm_session::uninstall_service(const std::string& service_name) {
+    auto st = connection->query_service_status(service_name);
+    if (state_stopped != st.current_state) throw winservice_exception(TRACEMSG(
+            "Error uninstalling service, name: [" + service_name + "],"
+            " service must be stopped before the uninstallation"));
+    connection->uninstall_service(service_name);
+}
+
+void scm_session::start_service(const std::string& service_name) {
+    connection->start_service(service_name);
+}
+
+void scm_session::stop_service(const std::string& service_name) {
+    connection->control_service(service_name, control_stop);
+}
+
+service_status scm_session::control_service(const std::string& service_name, uint32_t control) {
+    return connection->control_service(service_name, control);
+}
+
+service_status scm_session::query_service_status(const std::string& service_name) {
+    return connection->query_service_status(service_name);
+}
+
+std::vector<service_operation_result> scm_session::start_services(const std::vector<std::string>& service_names) {
+    return run_batch(service_names, [this](const std::string& name) {
+        this->start_service(name);
+    });
+}
+
+std::vector<service_operation_result> scm_session::stop_services(const std::vector<std::string>& service_names) {
+    return run_batch(service_names, [this](const std::string& name) {
+        this->stop_service(name);
+    });
+}
+
+std::vector<service_operation_result> scm_session::uninstall_services(const std::vector<std::string>& service_names) {
+    return run_batch(service_names, [this](const std::string& name) {
+        this->uninstall_service(name);
+    });
+}
+
+scm_connection& scm_session::get_connection() {
+    return *connection;
+}
+
+std::vector<service_operation_result> scm_session::run_batch(const std::vector<std::string>& service_names,
+        std::function<void(const std::string&)> operation) {
+    auto results = std::vector<service_operation_result>(service_names.size());
+    std::atomic<size_t> next{0};
+    auto worker = [&] {
+        for (;;) {
+            size_t idx = next.fetch_add(1);
+            if (idx >= service_names.size()) break;
+            auto& res = results[idx];
+            res.service_name = service_names[idx];
+            try {
+                operation(service_names[idx]);
+                res.success = true;
+            } catch (const std::exception& e) {
+                res.error = e.what();
+            } catch (...) {
+                res.error = "Unknown error";
+            }
+        }
+    };
+    auto count = std::min(static_cast<size_t>(max_concurrency), service_names.size());
+    auto threads = std::vector<std::thread>();
+    for (size_t i = 1; i < count; i++) {
+        threads.emplace_back(worker);
+    }
+    worker();
+    for (auto& th : threads) {
+        th.join();
+    }
+    return results;
+}
+
+} // namespace
+}
@@ -0,0 +1,196 @@
+/*
+ * Copyright 2026, alex at staticlibs.net
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * File:   service_event_bus.cpp
+ * Author: alex
+ *
+ * Created on October 17, 2026, 10:40 AM
+ */
+
+#include "staticlib/winservice/service_event_bus.hpp"
+
+#include <condition_variable>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "staticlib/config.hpp"
+
+namespace staticlib {
+namespace winservice {
+
+namespace { // anonymous
+
+// control itself for the predefined controls, 'control_user_min' for user-defined ones
+uint32_t event_kind(uint32_t control) {
+    if (control >= control_user_min && control <= control_user_max) {
+        return control_user_min;
+    }
+    return control;
+}
+
+} // namespace
+
+class service_event_bus::impl : public std::enable_shared_from_this<service_event_bus::impl> {
+    mutable std::mutex mutex;
+    std::condition_variable cv;
+    std::deque<service_event> queue;
+    uint64_t next_id = 1;
+    std::map<uint64_t, std::pair<uint32_t, std::function<void(const service_event&)>>> subscribers;
+    bool stopped = false;
+    std::thread worker;
+
+public:
+    void start() {
+        auto self = shared_from_this();
+        worker = std::thread([self] {
+            self->run();
+        });
+    }
+
+    void stop() STATICLIB_NOEXCEPT {
+        {
+            std::lock_guard<std::mutex> guard{mutex};
+            stopped = true;
+        }
+        cv.notify_all();
+        if (std::this_thread::get_id() == worker.get_id()) {
+            // bus is destroyed by one of the subscribers
+            worker.detach();
+        } else if (worker.joinable()) {
+            worker.join();
+        }
+    }
+
+    uint64_t subscribe(uint32_t kind, std::function<void(const service_event&)> subscriber) {
+        std::lock_guard<std::mutex> guard{mutex};
+        auto id = next_id++;
+        subscribers.insert(std::make_pair(id, std::make_pair(kind, std::move(subscriber))));
+        return id;
+    }
+
+    void unsubscribe(uint64_t subscription_id) {
+        std::lock_guard<std::mutex> guard{mutex};
+        subscribers.erase(subscription_id);
+    }
+
+    uint32_t accepted_controls() const {
+        std::lock_guard<std::mutex> guard{mutex};
+        uint32_t res = 0;
+        for (auto& en : subscribers) {
+            switch (en.second.first) {
+            case control_paramchange: res |= accept_paramchange; break;
+            case control_power_event: res |= accept_power_event; break;
+            case control_session_change: res |= accept_session_change; break;
+            default: break; // user-defined controls are always accepted
+            }
+        }
+        return res;
+    }
+
+    bool publish(const service_event& event) {
+        std::lock_guard<std::mutex> guard{mutex};
+        if (stopped || !has_subscribers(event_kind(event.control))) {
+            return false;
+        }
+        queue.push_back(event);
+        cv.notify_all();
+        return true;
+    }
+
+private:
+    // must be called under lock
+    bool has_subscribers(uint32_t kind) {
+        for (auto& en : subscribers) {
+            if (kind == en.second.first) return true;
+        }
+        return false;
+    }
+
+    void run() {
+        for (;;) {
+            auto event = service_event();
+            auto targets = std::vector<std::function<void(const service_event&)>>();
+            {
+                std::unique_lock<std::mutex> lock{mutex};
+                cv.wait(lock, [this] {
+                    return stopped || !queue.empty();
+                });
+                // enqueued events are delivered before stopping
+                if (queue.empty()) return;
+                event = std::move(queue.front());
+                queue.pop_front();
+                auto kind = event_kind(event.control);
+                for (auto& en : subscribers) {
+                    if (kind == en.second.first) {
+                        targets.push_back(en.second.second);
+                    }
+                }
+            }
+            for (auto& fun : targets) {
+                try {
+                    fun(event);
+                } catch (...) {
+                    // subscriber errors must not stop the bus
+                }
+            }
+        }
+    }
+};
+
+service_event_bus::service_event_bus() :
+pimpl(std::make_shared<impl>()) {
+    pimpl->start();
+}
+
+service_event_bus::~service_event_bus() {
+    pimpl->stop();
+}
+
+uint64_t service_event_bus::on_param_change(std::function<void(const service_event&)> subscriber) {
+    return pimpl->subscribe(control_paramchange, std::move(subscriber));
+}
+
+uint64_t service_event_bus::on_user_control(std::function<void(const service_event&)> subscriber) {
+    return pimpl->subscribe(control_user_min, std::move(subscriber));
+}
+
+uint64_t service_event_bus::on_power_event(std::function<void(const service_event&)> subscriber) {
+    return pimpl->subscribe(control_power_event, std::move(subscriber));
+}
+
+uint64_t service_event_bus::on_session_change(std::function<void(const service_event&)> subscriber) {
+    return pimpl->subscribe(control_session_change, std::move(subscriber));
+}
+
+void service_event_bus::unsubscribe(uint64_t subscription_id) {
+    pimpl->unsubscribe(subscription_id);
+}
+
+uint32_t service_event_bus::accepted_controls() const {
+    return pimpl->accepted_controls();
+}
+
+bool service_event_bus::publish(const service_event& event) {
+    return pimpl->publish(event);
+}
+
+} // namespace
+}
@@ -0,0 +1,103 @@
+/*
+ * Copyright 2026, alex at staticlibs.net
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * File:   service_metrics.cpp
+ * Author: alex
+ *
+ * Created on October 17, 2026, 11:48 AM
+ */
+
+#include "staticlib/winservice/service_metrics.hpp"
+
+#include <map>
+#include <mutex>
+
+#include "metrics_recorder.hpp"
+
+namespace staticlib {
+namespace winservice {
+
+namespace { // anonymous
+
+std::mutex& static_mutex() {
+    static std::mutex mutex{};
+    return mutex;
+}
+
+std::map<std::string, std::shared_ptr<metrics_recorder>>& static_recorders() {
+    static std::map<std::string, std::shared_ptr<metrics_recorder>> map{};
+    return map;
+}
+
+} // namespace
+
+uint64_t latency_histogram::percentile_millis(double fraction) const {
+    if (0 == count) {
+        return 0;
+    }
+    auto rank = static_cast<uint64_t>(fraction * static_cast<double>(count));
+    if (rank >= count) {
+        rank = count - 1;
+    }
+    uint64_t seen = 0;
+    for (size_t i = 0; i < counts.size(); i++) {
+        seen += counts[i];
+        if (seen > rank) {
+            return i < bounds_millis.size() ? bounds_millis[i] : max_millis;
+        }
+    }
+    return max_millis;
+}
+
+std::shared_ptr<metrics_recorder> find_metrics_recorder(const std::string& service_name) {
+    std::lock_guard<std::mutex> guard{static_mutex()};
+    auto& map = static_recorders();
+    auto it = map.find(service_name);
+    if (map.end() == it) {
+        it = map.insert(std::make_pair(service_name, std::make_shared<metrics_recorder>())).first;
+    }
+    return it->second;
+}
+
+service_metrics get_service_metrics(const std::string& service_name) {
+    std::lock_guard<std::mutex> guard{static_mutex()};
+    auto& map = static_recorders();
+    auto it = map.find(service_name);
+    if (map.end() != it) {
+        return it->second->snapshot(service_name);
+    }
+    return metrics_recorder().snapshot(service_name);
+}
+
+std::vector<service_metrics> get_all_service_metrics() {
+    std::lock_guard<std::mutex> guard{static_mutex()};
+    auto res = std::vector<service_metrics>();
+    for (auto& pa : static_recorders()) {
+        res.emplace_back(pa.second->snapshot(pa.first));
+    }
+    return res;
+}
+
+void reset_service_metrics() {
+    std::lock_guard<std::mutex> guard{static_mutex()};
+    for (auto& pa : static_recorders()) {
+        pa.second->reset();
+    }
+}
+
+} // namespace
+}
@@ -0,0 +1,138 @@
+/*
+ * Copyright 2026, alex at staticlibs.net
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * File:   service_snapshot.cpp
+ * Author: alex
+ *
+ * Created on October 17, 2026, 10:20 AM
+ */
+
+#include "staticlib/winservice/service_snapshot.hpp"
+
+#include <algorithm>
+#include <memory>
+#include <utility>
+
+#include "staticlib/winservice/winservice_exception.hpp"
+
+namespace staticlib {
+namespace winservice {
+
+namespace { // anonymous
+
+uint32_t compare_entries(const service_entry& previous, const service_entry& current, bool with_config) {
+    uint32_t res = 0;
+    if (previous.status.current_state != current.status.current_state) {
+        res |= change_state;
+    }
+    if (previous.status.process_id != current.status.process_id) {
+        res |= change_process;
+    }
+    if (previous.status.win32_exit_code != current.status.win32_exit_code ||
+            previous.status.service_specific_exit_code != current.status.service_specific_exit_code) {
+        res |= change_exit_code;
+    }
+    if (with_config && (previous.display_name != current.display_name ||
+            0 != diff_service_config(previous.config, current.config) ||
+            0 != diff_service_config(current.config, previous.config))) {
+        res |= change_config;
+    }
+    return res;
+}
+
+service_change make_change(const std::string& name, uint32_t changes, const service_status& previous,
+        const service_status& current) {
+    service_change ch;
+    ch.service_name = name;
+    ch.changes = changes;
+    ch.previous = previous;
+    ch.current = current;
+    return ch;
+}
+
+} // namespace
+
+service_snapshot::service_snapshot(std::vector<std::string> service_names, bool include_config) :
+names_filter(std::move(service_names)),
+include_config(include_config) {
+    std::sort(names_filter.begin(), names_filter.end());
+}
+
+std::vector<service_change> service_snapshot::refresh(scm_connection& connection) {
+    auto listed = connection.enumerate_services();
+    if (!names_filter.empty()) {
+        listed.erase(std::remove_if(listed.begin(), listed.end(), [this](const service_entry& se) {
+            return !std::binary_search(names_filter.begin(), names_filter.end(), se.name);
+        }), listed.end());
+    }
+    if (include_config) {
+        for (auto& se : listed) {
+            try {
+                se.config = connection.query_service_config(se.name);
+            } catch (const winservice_exception&) {
+                // service may be deleted after the enumeration
+            }
+        }
+    }
+
+    // both lists are sorted by name
+    auto res = std::vector<service_change>();
+    auto empty = service_status();
+    size_t i = 0;
+    size_t j = 0;
+    while (i < entries.size() || j < listed.size()) {
+        if (j == listed.size() || (i < entries.size() && entries[i].name < listed[j].name)) {
+            res.push_back(make_change(entries[i].name, change_removed, entries[i].status, empty));
+            i += 1;
+        } else if (i == entries.size() || listed[j].name < entries[i].name) {
+            res.push_back(make_change(listed[j].name, change_added, empty, listed[j].status));
+            j += 1;
+        } else {
+            auto changes = compare_entries(entries[i], listed[j], include_config);
+            if (0 != changes) {
+                res.push_back(make_change(listed[j].name, changes, entries[i].status, listed[j].status));
+            }
+            i += 1;
+            j += 1;
+        }
+    }
+    entries = std::move(listed);
+    version += 1;
+    return res;
+}
+
+const std::vector<service_entry>& service_snapshot::get_entries() const {
+    return entries;
+}
+
+const service_entry* service_snapshot::find(const std::string& service_name) const {
+    auto it = std::lower_bound(entries.begin(), entries.end(), service_name,
+            [](const service_entry& se, const std::string& name) {
+                return se.name < name;
+            });
+    if (entries.end() != it && service_name == it->name) {
+        return std::addressof(*it);
+    }
+    return nullptr;
+}
+
+uint64_t service_snapshot::get_version() const {
+    return version;
+}
+
+} // namespace
+}
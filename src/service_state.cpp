@@ -0,0 +1,107 @@
+/*
+ * Copyright 2026, alex at staticlibs.net
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * File:   service_state.cpp
+ * Author: alex
+ *
+ * Created on October 17, 2026, 1:58 PM
+ */
+
+#include "staticlib/winservice/service_state.hpp"
+
+#include <map>
+#include <mutex>
+
+#include "state_publisher.hpp"
+
+namespace staticlib {
+namespace winservice {
+
+namespace { // anonymous
+
+std::mutex& static_mutex() {
+    static std::mutex mutex{};
+    return mutex;
+}
+
+std::map<std::string, std::shared_ptr<state_publisher>>& static_publishers() {
+    static std::map<std::string, std::shared_ptr<state_publisher>> map{};
+    return map;
+}
+
+} // namespace
+
+std::shared_ptr<state_publisher> find_state_publisher(const std::string& service_name) {
+    std::lock_guard<std::mutex> guard{static_mutex()};
+    auto& map = static_publishers();
+    auto it = map.find(service_name);
+    if (map.end() == it) {
+        it = map.insert(std::make_pair(service_name, std::make_shared<state_publisher>())).first;
+    }
+    return it->second;
+}
+
+class service_state_view::impl {
+public:
+    std::shared_ptr<state_publisher> publisher;
+
+    impl(const std::string& service_name) :
+    publisher(find_state_publisher(service_name)) { }
+};
+
+service_state_view::service_state_view(const std::string& service_name) :
+pimpl(std::make_shared<impl>(service_name)) { }
+
+uint32_t service_state_view::current_state() const {
+    return pimpl->publisher->state();
+}
+
+bool service_state_view::is_running() const {
+    return state_running == pimpl->publisher->state();
+}
+
+bool service_state_view::is_stopping() const {
+    auto state = pimpl->publisher->state();
+    return state_stop_pending == state || state_stopped == state;
+}
+
+service_state_snapshot service_state_view::snapshot() const {
+    return pimpl->publisher->read();
+}
+
+service_state_snapshot service_state_view::wait_for_state(uint32_t state, uint32_t timeout_millis) const {
+    return pimpl->publisher->wait([state](const service_state_snapshot& snap) {
+        return state == snap.current_state;
+    }, timeout_millis);
+}
+
+service_state_snapshot service_state_view::wait_for_change(uint64_t version, uint32_t timeout_millis) const {
+    return pimpl->publisher->wait([version](const service_state_snapshot& snap) {
+        return snap.version > version;
+    }, timeout_millis);
+}
+
+uint64_t service_state_view::subscribe(std::function<void(const service_state_snapshot&)> listener) {
+    return pimpl->publisher->subscribe(std::move(listener));
+}
+
+void service_state_view::unsubscribe(uint64_t subscription_id) {
+    pimpl->publisher->unsubscribe(subscription_id);
+}
+
+} // namespace
+}
@@ -0,0 +1,161 @@
+/*
+ * Copyright 2026, alex at staticlibs.net
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * File:   service_status.cpp
+ * Author: alex
+ *
+ * Created on October 17, 2026, 11:38 AM
+ */
+
+#include "staticlib/winservice/service_status.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <utility>
+
+#include "staticlib/config.hpp"
+#include "staticlib/support.hpp"
+
+#include "guid_string.hpp"
+
+namespace staticlib {
+namespace winservice {
+
+std::string state_to_string(uint32_t state) {
+    switch (state) {
+    case state_stopped: return "SERVICE_STOPPED";
+    case state_start_pending: return "SERVICE_START_PENDING";
+    case state_stop_pending: return "SERVICE_STOP_PENDING";
+    case state_running: return "SERVICE_RUNNING";
+    case state_continue_pending: return "SERVICE_CONTINUE_PENDING";
+    case state_pause_pending: return "SERVICE_PAUSE_PENDING";
+    case state_paused: return "SERVICE_PAUSED";
+    default: return "UNKNOWN_STATE_" + sl::support::to_string(state);
+    }
+}
+
+namespace { // anonymous
+
+// account names are case-insensitive
+bool equals_ignore_case(const std::string& left, const std::string& right) {
+    return left.length() == right.length() && std::equal(left.begin(), left.end(), right.begin(),
+            [](char a, char b) {
+                return std::tolower(static_cast<unsigned char>(a)) == std::tolower(static_cast<unsigned char>(b));
+            });
+}
+
+bool equals(const service_failure_actions& left, const service_failure_actions& right) {
+    if (left.reset_period_secs != right.reset_period_secs ||
+            left.command != right.command ||
+            left.actions.size() != right.actions.size()) {
+        return false;
+    }
+    for (size_t i = 0; i < left.actions.size(); i++) {
+        if (left.actions[i].type != right.actions[i].type ||
+                left.actions[i].delay_millis != right.actions[i].delay_millis) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool equals(const std::vector<service_trigger>& left, const std::vector<service_trigger>& right) {
+    if (left.size() != right.size()) {
+        return false;
+    }
+    for (size_t i = 0; i < left.size(); i++) {
+        if (left[i].type != right[i].type ||
+                left[i].action != right[i].action ||
+                normalize_guid_string(left[i].subtype) != normalize_guid_string(right[i].subtype) ||
+                left[i].data != right[i].data) {
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+uint32_t diff_service_config(const service_config& current, const service_config& desired) {
+    uint32_t res = 0;
+    if (!desired.display_name.empty() && current.display_name != desired.display_name) {
+        res |= config_display_name;
+    }
+    if ((!desired.binary_path.empty() && current.binary_path != desired.binary_path) ||
+            current.arguments != desired.arguments) {
+        res |= config_binary_path;
+    }
+    if (!desired.account.empty() && !equals_ignore_case(current.account, desired.account)) {
+        res |= config_account;
+    }
+    if (current.service_type != desired.service_type) {
+        res |= config_service_type;
+    }
+    if (current.start_type != desired.start_type ||
+            (start_type_auto == desired.start_type && current.delayed_auto_start != desired.delayed_auto_start)) {
+        res |= config_start_type;
+    }
+    if (current.dependencies != desired.dependencies) {
+        res |= config_dependencies;
+    }
+    if (!equals_ignore_case(current.load_order_group, desired.load_order_group)) {
+        res |= config_load_order_group;
+    }
+    if (!equals(current.triggers, desired.triggers)) {
+        res |= config_triggers;
+    }
+    if (current.description != desired.description) {
+        res |= config_description;
+    }
+    if (!equals(current.failure_actions, desired.failure_actions)) {
+        res |= config_failure_actions;
+    }
+    if (desired.preshutdown_timeout_millis > 0 &&
+            current.preshutdown_timeout_millis != desired.preshutdown_timeout_millis) {
+        res |= config_preshutdown_timeout;
+    }
+    return res;
+}
+
+std::string config_fields_to_string(uint32_t fields) {
+    static const std::vector<std::pair<uint32_t, std::string>> names = {
+        {config_display_name, "display_name"},
+        {config_binary_path, "binary_path"},
+        {config_account, "account"},
+        {config_service_type, "service_type"},
+        {config_start_type, "start_type"},
+        {config_dependencies, "dependencies"},
+        {config_description, "description"},
+        {config_failure_actions, "failure_actions"},
+        {config_preshutdown_timeout, "preshutdown_timeout"},
+        {config_load_order_group, "load_order_group"},
+        {config_triggers, "triggers"}
+    };
+    auto res = std::string();
+    for (auto& pa : names) {
+        if (0 != (fields & pa.first)) {
+            if (!res.empty()) {
+                res.append(", ");
+            }
+            res.append(pa.second);
+        }
+    }
+    return res;
+}
+
+} // namespace
+}
@@ -0,0 +1,380 @@
+/*
+ * Copyright 2026, alex at staticlibs.net
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * File:   service_supervisor.cpp
+ * Author: alex
+ *
+ * Created on October 17, 2026, 2:55 PM
+ */
+
+#include "staticlib/winservice/service_supervisor.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "staticlib/config.hpp"
+#include "staticlib/support.hpp"
+
+#include "staticlib/winservice/operations.hpp"
+#include "staticlib/winservice/service_tracer.hpp"
+
+namespace staticlib {
+namespace winservice {
+
+namespace { // anonymous
+
+class supervised_component {
+public:
+    std::string name;
+    std::function<void()> starter;
+    std::function<void()> stopper;
+    restart_policy policy;
+    bool running = false;
+    bool restart_pending = false;
+    std::deque<std::chrono::steady_clock::time_point> restarts;
+    uint32_t restarts_total = 0;
+};
+
+// result of the callback run under the watchdog, shared with the (possibly abandoned) thread
+class watched_call {
+public:
+    std::mutex mutex;
+    std::condition_variable cv;
+    bool done = false;
+    std::exception_ptr error;
+};
+
+std::chrono::milliseconds backoff_delay(const restart_policy& policy, size_t restarts_in_window) {
+    double delay = policy.initial_backoff_millis;
+    for (size_t i = 0; i < restarts_in_window && delay < policy.max_backoff_millis; i++) {
+        delay *= policy.backoff_multiplier;
+    }
+    delay = std::min(delay, static_cast<double>(policy.max_backoff_millis));
+    return std::chrono::milliseconds(static_cast<long long>(delay));
+}
+
+} // namespace
+
+class service_supervisor::impl : public std::enable_shared_from_this<service_supervisor::impl> {
+    std::string service_name;
+    uint32_t start_timeout_millis;
+    uint32_t stop_timeout_millis;
+    uint32_t escalation_exit_code;
+
+    mutable std::mutex mutex;
+    std::condition_variable cv;
+    std::vector<supervised_component> components;
+    std::deque<size_t> failed;
+    bool active = false;
+    std::function<void(const std::string&)> logger;
+    std::thread worker;
+
+public:
+    impl(const std::string& service_name, uint32_t start_timeout_millis,
+            uint32_t stop_timeout_millis, uint32_t escalation_exit_code) :
+    service_name(service_name),
+    start_timeout_millis(start_timeout_millis),
+    stop_timeout_millis(stop_timeout_millis),
+    escalation_exit_code(escalation_exit_code) { }
+
+    void add_component(const std::string& name, std::function<void()> starter,
+            std::function<void()> stopper, restart_policy policy) {
+        std::lock_guard<std::mutex> guard{mutex};
+        if (active) throw winservice_exception(TRACEMSG(
+                "Components cannot be added to the running supervisor, name: [" + name + "]"));
+        for (auto& comp : components) {
+            if (name == comp.name) throw winservice_exception(TRACEMSG(
+                    "Duplicate component name: [" + name + "]"));
+        }
+        supervised_component comp;
+        comp.name = name;
+        comp.starter = std::move(starter);
+        comp.stopper = std::move(stopper);
+        comp.policy = policy;
+        components.emplace_back(std::move(comp));
+    }
+
+    void report_failure(const std::string& name, const std::string& message) {
+        std::lock_guard<std::mutex> guard{mutex};
+        auto idx = find_component(name);
+        auto& comp = components[idx];
+        if (!active || !comp.running || comp.restart_pending) {
+            return;
+        }
+        comp.restart_pending = true;
+        failed.push_back(idx);
+        log("Component failed, name: [" + name + "], message: [" + message + "]");
+        cv.notify_all();
+    }
+
+    uint32_t restart_count(const std::string& name) const {
+        std::lock_guard<std::mutex> guard{mutex};
+        return components[find_component(name)].restarts_total;
+    }
+
+    void start(std::function<void(const std::string&)> service_logger) {
+        {
+            std::lock_guard<std::mutex> guard{mutex};
+            logger = std::move(service_logger);
+            failed.clear();
+            for (auto& comp : components) {
+                comp.restart_pending = false;
+                comp.restarts.clear();
+                comp.restarts_total = 0;
+            }
+        }
+        auto self = shared_from_this();
+        run_watched([self] {
+            self->start_components();
+        }, start_timeout_millis, "start");
+        std::lock_guard<std::mutex> guard{mutex};
+        active = true;
+        worker = std::thread([self] {
+            self->run();
+        });
+    }
+
+    void stop() {
+        stop_worker();
+        auto self = shared_from_this();
+        run_watched([self] {
+            self->stop_components();
+        }, stop_timeout_millis, "stop");
+    }
+
+    void stop_worker() STATICLIB_NOEXCEPT {
+        {
+            std::lock_guard<std::mutex> guard{mutex};
+            active = false;
+            failed.clear();
+        }
+        cv.notify_all();
+        if (worker.joinable()) {
+            worker.join();
+        }
+    }
+
+private:
+    // must be called under lock
+    size_t find_component(const std::string& name) const {
+        for (size_t i = 0; i < components.size(); i++) {
+            if (name == components[i].name) return i;
+        }
+        throw winservice_exception(TRACEMSG("Unknown component, name: [" + name + "]"));
+    }
+
+    // must be called under lock
+    void log(const std::string& message) {
+        if (logger) {
+            logger(message);
+        }
+    }
+
+    void set_running(size_t idx, bool running) {
+        std::lock_guard<std::mutex> guard{mutex};
+        components[idx].running = running;
+    }
+
+    void start_components() {
+        for (size_t i = 0; i < components.size(); i++) {
+            try {
+                trace_span span(components[i].name, "component");
+                components[i].starter();
+                set_running(i, true);
+            } catch (...) {
+                // roll back the components started so far
+                try {
+                    stop_components();
+                } catch (...) {
+                    // start error is reported
+                }
+                throw;
+            }
+        }
+    }
+
+    void stop_components() {
+        auto error = std::exception_ptr();
+        for (size_t i = components.size(); i > 0; i--) {
+            auto idx = i - 1;
+            {
+                std::lock_guard<std::mutex> guard{mutex};
+                if (!components[idx].running) continue;
+            }
+            try {
+                trace_span span(components[idx].name, "component");
+                components[idx].stopper();
+            } catch (...) {
+                if (!error) {
+                    error = std::current_exception();
+                }
+            }
+            set_running(idx, false);
+        }
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+
+    void run_watched(std::function<void()> fun, uint32_t timeout_millis, const std::string& phase) {
+        if (0 == timeout_millis) {
+            fun();
+            return;
+        }
+        auto call = std::make_shared<watched_call>();
+        auto th = std::thread([call, fun] {
+            auto error = std::exception_ptr();
+            try {
+                fun();
+            } catch (...) {
+                error = std::current_exception();
+            }
+            std::lock_guard<std::mutex> guard{call->mutex};
+            call->error = error;
+            call->done = true;
+            call->cv.notify_all();
+        });
+        {
+            std::unique_lock<std::mutex> lock{call->mutex};
+            auto done = call->cv.wait_for(lock, std::chrono::milliseconds(timeout_millis), [&call] {
+                return call->done;
+            });
+            if (!done) {
+                // hung thread cannot be interrupted, it is left running
+                th.detach();
+                throw service_specific_error(escalation_exit_code, TRACEMSG(
+                        "Hang detected, phase: [" + phase + "]," +
+                        " timeout millis: [" + sl::support::to_string(timeout_millis) + "]"));
+            }
+        }
+        th.join();
+        if (call->error) {
+            std::rethrow_exception(call->error);
+        }
+    }
+
+    void escalate(const std::string& message) {
+        {
+            std::lock_guard<std::mutex> guard{mutex};
+            log("Stopping service, in-process recovery failed, name: [" + service_name + "]," +
+                    " message: [" + message + "]");
+        }
+        try {
+            request_service_stop(service_name, escalation_exit_code);
+        } catch (const std::exception& e) {
+            std::lock_guard<std::mutex> guard{mutex};
+            log(e.what());
+        }
+    }
+
+    void run() {
+        for (;;) {
+            size_t idx = 0;
+            {
+                std::unique_lock<std::mutex> lock{mutex};
+                cv.wait(lock, [this] {
+                    return !active || !failed.empty();
+                });
+                if (!active) return;
+                idx = failed.front();
+                auto& comp = components[idx];
+                auto now = std::chrono::steady_clock::now();
+                auto window = std::chrono::milliseconds(comp.policy.window_millis);
+                while (!comp.restarts.empty() && now - comp.restarts.front() > window) {
+                    comp.restarts.pop_front();
+                }
+                if (comp.restarts.size() >= comp.policy.max_restarts) {
+                    auto msg = "Restart policy exhausted, component: [" + comp.name + "]," +
+                            " restarts: [" + sl::support::to_string(comp.restarts.size()) + "]";
+                    lock.unlock();
+                    escalate(msg);
+                    return;
+                }
+                auto delay = backoff_delay(comp.policy, comp.restarts.size());
+                auto stopped = cv.wait_for(lock, delay, [this] {
+                    return !active;
+                });
+                if (stopped) return;
+                failed.pop_front();
+                comp.restarts.push_back(std::chrono::steady_clock::now());
+                comp.restarts_total += 1;
+            }
+            auto& comp = components[idx];
+            try {
+                run_watched(comp.stopper, stop_timeout_millis, "stop, component: [" + comp.name + "]");
+                set_running(idx, false);
+                run_watched(comp.starter, start_timeout_millis, "start, component: [" + comp.name + "]");
+                set_running(idx, true);
+            } catch (const std::exception& e) {
+                escalate(e.what());
+                return;
+            }
+            std::lock_guard<std::mutex> guard{mutex};
+            comp.restart_pending = false;
+            log("Component restarted, name: [" + comp.name + "]," +
+                    " restarts: [" + sl::support::to_string(comp.restarts_total) + "]");
+        }
+    }
+};
+
+service_supervisor::service_supervisor(const std::string& service_name, uint32_t start_timeout_millis,
+        uint32_t stop_timeout_millis, uint32_t escalation_exit_code) :
+pimpl(std::make_shared<impl>(service_name, start_timeout_millis, stop_timeout_millis, escalation_exit_code)) { }
+
+service_supervisor::~service_supervisor() {
+    pimpl->stop_worker();
+}
+
+service_supervisor& service_supervisor::add_component(const std::string& name, std::function<void()> starter,
+        std::function<void()> stopper, restart_policy policy) {
+    pimpl->add_component(name, std::move(starter), std::move(stopper), policy);
+    return *this;
+}
+
+void service_supervisor::report_failure(const std::string& name, const std::string& message) {
+    pimpl->report_failure(name, message);
+}
+
+uint32_t service_supervisor::restart_count(const std::string& name) const {
+    return pimpl->restart_count(name);
+}
+
+service_lifecycle service_supervisor::create_lifecycle(std::function<void(const std::string&)> logger) {
+    if (!logger) {
+        logger = [](const std::string&) {};
+    }
+    auto supervisor = pimpl;
+    service_lifecycle lc;
+    lc.starter = [supervisor, logger](service_transition&) {
+        supervisor->start(logger);
+    };
+    lc.stopper = [supervisor](service_transition&) {
+        supervisor->stop();
+    };
+    lc.logger = logger;
+    return lc;
+}
+
+} // namespace
+}
@@ -0,0 +1,225 @@
+/*
+ * Copyright 2026, alex at staticlibs.net
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * File:   service_tracer.cpp
+ * Author: alex
+ *
+ * Created on October 17, 2026, 10:30 AM
+ */
+
+#include "staticlib/winservice/service_tracer.hpp"
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "staticlib/config.hpp"
+#include "staticlib/support.hpp"
+
+// VS2013 does not support 'thread_local', pointer is a POD
+#if defined(_MSC_VER) && _MSC_VER < 1900
+#define STATICLIB_WINSERVICE_THREAD_LOCAL __declspec(thread)
+#else
+#define STATICLIB_WINSERVICE_THREAD_LOCAL thread_local
+#endif
+
+namespace staticlib {
+namespace winservice {
+
+namespace { // anonymous
+
+// spans over this limit are dropped to bound the memory used by a long running service
+const size_t max_spans_per_thread = 1 << 16;
+
+class span_record {
+public:
+    std::string name;
+    const char* category;
+    uint64_t begin_micros;
+    uint64_t duration_micros;
+
+    span_record(std::string name, const char* category, uint64_t begin_micros, uint64_t duration_micros) :
+    name(std::move(name)),
+    category(category),
+    begin_micros(begin_micros),
+    duration_micros(duration_micros) { }
+};
+
+// owned by the registry, thread only keeps a pointer, so buffers
+// of the finished threads are kept until dumped
+class thread_buffer {
+public:
+    // buffer lock is only contended while dumping
+    std::mutex mutex;
+    std::vector<span_record> spans;
+    uint32_t thread_id;
+
+    explicit thread_buffer(uint32_t thread_id) :
+    thread_id(thread_id) { }
+};
+
+class trace_registry {
+public:
+    std::atomic<bool> enabled{false};
+    std::chrono::steady_clock::time_point epoch = std::chrono::steady_clock::now();
+    std::mutex mutex;
+    std::vector<std::shared_ptr<thread_buffer>> buffers;
+};
+
+trace_registry& static_registry() {
+    static trace_registry registry;
+    return registry;
+}
+
+STATICLIB_WINSERVICE_THREAD_LOCAL thread_buffer* current_buffer = nullptr;
+
+thread_buffer& local_buffer() {
+    if (nullptr == current_buffer) {
+        auto& reg = static_registry();
+        std::lock_guard<std::mutex> guard{reg.mutex};
+        auto tid = static_cast<uint32_t>(reg.buffers.size() + 1);
+        reg.buffers.emplace_back(std::make_shared<thread_buffer>(tid));
+        current_buffer = reg.buffers.back().get();
+    }
+    return *current_buffer;
+}
+
+uint64_t micros_since_epoch(std::chrono::steady_clock::time_point tp) {
+    auto diff = tp - static_registry().epoch;
+    auto res = std::chrono::duration_cast<std::chrono::microseconds>(diff).count();
+    return res > 0 ? static_cast<uint64_t>(res) : 0;
+}
+
+void append_json_string(std::string& out, const std::string& str) {
+    static const char* hex = "0123456789abcdef";
+    out.push_back('"');
+    for (char ch : str) {
+        switch (ch) {
+        case '"': out.append("\\\""); break;
+        case '\\': out.append("\\\\"); break;
+        case '\n': out.append("\\n"); break;
+        case '\r': out.append("\\r"); break;
+        case '\t': out.append("\\t"); break;
+        default:
+            if (static_cast<unsigned char>(ch) < 0x20) {
+                out.append("\\u00");
+                out.push_back(hex[(ch >> 4) & 0xf]);
+                out.push_back(hex[ch & 0xf]);
+            } else {
+                out.push_back(ch);
+            }
+        }
+    }
+    out.push_back('"');
+}
+
+} // namespace
+
+void enable_tracing(bool enabled) {
+    static_registry().enabled.store(enabled, std::memory_order_relaxed);
+}
+
+bool is_tracing_enabled() {
+    return static_registry().enabled.load(std::memory_order_relaxed);
+}
+
+std::string dump_trace_json() {
+    auto& reg = static_registry();
+    auto buffers = std::vector<std::shared_ptr<thread_buffer>>();
+    {
+        std::lock_guard<std::mutex> guard{reg.mutex};
+        buffers = reg.buffers;
+    }
+    auto res = std::string("{\"traceEvents\":[");
+    bool first = true;
+    for (auto& buf : buffers) {
+        std::lock_guard<std::mutex> guard{buf->mutex};
+        for (auto& sp : buf->spans) {
+            if (!first) {
+                res.append(",\n");
+            }
+            first = false;
+            res.append("{\"name\":");
+            append_json_string(res, sp.name);
+            res.append(",\"cat\":");
+            append_json_string(res, sp.category);
+            res.append(",\"ph\":\"X\",\"pid\":1,\"tid\":");
+            res.append(sl::support::to_string(buf->thread_id));
+            res.append(",\"ts\":");
+            res.append(sl::support::to_string(sp.begin_micros));
+            res.append(",\"dur\":");
+            res.append(sl::support::to_string(sp.duration_micros));
+            res.append("}");
+        }
+    }
+    res.append("],\"displayTimeUnit\":\"ms\"}");
+    return res;
+}
+
+void clear_trace() {
+    auto& reg = static_registry();
+    std::lock_guard<std::mutex> guard{reg.mutex};
+    for (auto& buf : reg.buffers) {
+        std::lock_guard<std::mutex> buf_guard{buf->mutex};
+        buf->spans.clear();
+    }
+}
+
+trace_span::trace_span(const char* name, const char* category) :
+category(category),
+active(is_tracing_enabled()) {
+    if (active) {
+        this->name = name;
+        begin = std::chrono::steady_clock::now();
+    }
+}
+
+trace_span::trace_span(const std::string& name, const char* category) :
+category(category),
+active(is_tracing_enabled()) {
+    if (active) {
+        this->name = name;
+        begin = std::chrono::steady_clock::now();
+    }
+}
+
+trace_span::~trace_span() {
+    end();
+}
+
+void trace_span::end() {
+    if (!active) {
+        return;
+    }
+    active = false;
+    auto finish = std::chrono::steady_clock::now();
+    try {
+        auto& buf = local_buffer();
+        std::lock_guard<std::mutex> guard{buf.mutex};
+        if (buf.spans.size() < max_spans_per_thread) {
+            auto dur = std::chrono::duration_cast<std::chrono::microseconds>(finish - begin).count();
+            buf.spans.emplace_back(std::move(name), category, micros_since_epoch(begin),
+                    static_cast<uint64_t>(dur));
+        }
+    } catch (...) {
+        // tracing must not break the traced code
+    }
+}
+
+} // namespace
+}
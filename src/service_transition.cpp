@@ -0,0 +1,102 @@
+/*
+ * Copyright 2026, alex at staticlibs.net
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * File:   service_transition.cpp
+ * Author: alex
+ *
+ * Created on October 17, 2026, 2:31 PM
+ */
+
+#include "staticlib/winservice/service_transition.hpp"
+
+#include <algorithm>
+
+namespace staticlib {
+namespace winservice {
+
+service_transition::service_transition(uint32_t pending_state, uint32_t target_state,
+        uint32_t wait_hint_millis, std::function<void(uint32_t)> reporter) :
+service_transition(pending_state, target_state, wait_hint_millis, 0, wait_hint_millis,
+        cancellation_token(), std::move(reporter)) { }
+
+service_transition::service_transition(uint32_t pending_state, uint32_t target_state,
+        uint32_t wait_hint_millis, uint32_t reason, uint32_t budget_millis, cancellation_token token,
+        std::function<void(uint32_t)> reporter) :
+pending(pending_state),
+target(target_state),
+wait_hint_millis(wait_hint_millis),
+reason_control(reason),
+started_at(std::chrono::steady_clock::now()),
+deadline_at(started_at + std::chrono::milliseconds(budget_millis)),
+token(std::move(token)),
+reporter(std::move(reporter)) { }
+
+uint32_t service_transition::pending_state() const {
+    return pending;
+}
+
+uint32_t service_transition::target_state() const {
+    return target;
+}
+
+uint32_t service_transition::reason() const {
+    return reason_control;
+}
+
+std::chrono::steady_clock::time_point service_transition::deadline() const {
+    return deadline_at;
+}
+
+uint32_t service_transition::remaining_millis() const {
+    auto left = deadline_at - std::chrono::steady_clock::now();
+    auto millis = std::chrono::duration_cast<std::chrono::milliseconds>(left).count();
+    return millis > 0 ? static_cast<uint32_t>(millis) : 0;
+}
+
+const cancellation_token& service_transition::cancellation() const {
+    return token;
+}
+
+bool service_transition::is_cancelled() const {
+    return token.is_cancelled();
+}
+
+void service_transition::checkpoint() {
+    reporter(wait_hint_millis);
+}
+
+void service_transition::report_progress(double fraction) {
+    progress_fraction = std::min(std::max(fraction, 0.0), 1.0);
+    uint32_t hint = wait_hint_millis;
+    if (progress_fraction > 0) {
+        // remaining time estimated from the time spent so far
+        auto elapsed = std::chrono::steady_clock::now() - started_at;
+        auto elapsed_millis = std::chrono::duration_cast<std::chrono::milliseconds>(elapsed).count();
+        auto remaining = static_cast<double>(elapsed_millis) * (1 - progress_fraction) / progress_fraction;
+        if (remaining > static_cast<double>(hint)) {
+            hint = remaining < 0xffffffffu ? static_cast<uint32_t>(remaining) : 0xffffffffu;
+        }
+    }
+    reporter(hint);
+}
+
+double service_transition::progress() const {
+    return progress_fraction;
+}
+
+} // namespace
+}
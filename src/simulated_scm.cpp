@@ -0,0 +1,596 @@
+/*
+ * Copyright 2026, alex at staticlibs.net
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * File:   simulated_scm.cpp
+ * Author: alex
+ *
+ * Created on October 17, 2026, 10:47 AM
+ */
+
+#include "staticlib/winservice/simulated_scm.hpp"
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <thread>
+
+#include "staticlib/config.hpp"
+#include "staticlib/support.hpp"
+
+#include "guid_string.hpp"
+
+namespace staticlib {
+namespace winservice {
+
+namespace { // anonymous
+
+class dispatcher_state;
+
+class service_record {
+public:
+    service_config config;
+    service_status status;
+    std::vector<service_status> history;
+    std::function<bool(uint32_t, uint32_t, uint32_t)> handler;
+    std::shared_ptr<dispatcher_state> dispatcher;
+    bool start_requested = false;
+    bool delete_pending = false;
+    uint32_t config_changes = 0;
+};
+
+class work_item {
+public:
+    std::string service_name;
+    bool is_start = false;
+    uint32_t control = 0;
+    uint32_t event_type = 0;
+    uint32_t event_data = 0;
+    std::shared_ptr<bool> delivered;
+};
+
+class dispatcher_state {
+public:
+    std::vector<std::string> service_names;
+    std::deque<work_item> queue;
+    bool started_any = false;
+    uint32_t process_id = 0;
+};
+
+// Win32 error codes are used to keep the messages
+// consistent with the ones reported by native SCM
+std::string error_string(uint32_t code) {
+    std::string name = "";
+    switch (code) {
+    case 6: name = "ERROR_INVALID_HANDLE"; break;
+    case 13: name = "ERROR_INVALID_DATA"; break;
+    case 87: name = "ERROR_INVALID_PARAMETER"; break;
+    case 1052: name = "ERROR_INVALID_SERVICE_CONTROL"; break;
+    case 1053: name = "ERROR_SERVICE_REQUEST_TIMEOUT"; break;
+    case 1056: name = "ERROR_SERVICE_ALREADY_RUNNING"; break;
+    case 1058: name = "ERROR_SERVICE_DISABLED"; break;
+    case 1060: name = "ERROR_SERVICE_DOES_NOT_EXIST"; break;
+    case 1061: name = "ERROR_SERVICE_CANNOT_ACCEPT_CTRL"; break;
+    case 1062: name = "ERROR_SERVICE_NOT_ACTIVE"; break;
+    case 1063: name = "ERROR_FAILED_SERVICE_CONTROLLER_CONNECT"; break;
+    case 1072: name = "ERROR_SERVICE_MARKED_FOR_DELETE"; break;
+    case 1073: name = "ERROR_SERVICE_EXISTS"; break;
+    case 1083: name = "ERROR_SERVICE_NOT_IN_EXE"; break;
+    default: name = "UNKNOWN_ERROR";
+    }
+    return sl::support::to_string(code) + ": " + name;
+}
+
+bool is_control_accepted(uint32_t control, uint32_t accepted) {
+    switch (control) {
+    case control_stop: return 0 != (accepted & accept_stop);
+    case control_pause: return 0 != (accepted & accept_pause_continue);
+    case control_continue: return 0 != (accepted & accept_pause_continue);
+    case control_paramchange: return 0 != (accepted & accept_paramchange);
+    default: return control >= control_user_min && control <= control_user_max;
+    }
+}
+
+// same checks as 'ChangeServiceConfig2W' does for 'SERVICE_CONFIG_TRIGGER_INFO'
+bool is_valid_trigger(const service_trigger& trigger) {
+    guid_parts guid;
+    bool known_type = (trigger.type >= trigger_type_device_interface_arrival &&
+            trigger.type <= trigger_type_network_endpoint) || trigger_type_custom == trigger.type;
+    bool known_action = trigger_action_start == trigger.action || trigger_action_stop == trigger.action;
+    return known_type && known_action && parse_guid_string(trigger.subtype, guid);
+}
+
+void check_triggers(const service_config& config) {
+    for (auto& tr : config.triggers) {
+        if (!is_valid_trigger(tr)) throw winservice_exception(TRACEMSG(
+                "Error changing service config, name: [" + config.name + "]," +
+                " invalid trigger, type: [" + sl::support::to_string(tr.type) + "]," +
+                " subtype: [" + tr.subtype + "]," +
+                " error: [" + error_string(87) + "]"));
+    }
+}
+
+} // namespace
+
+class simulated_scm::impl : public std::enable_shared_from_this<simulated_scm::impl> {
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::map<std::string, service_record> records;
+    uint32_t control_timeout_millis = 30000;
+    // fake IDs of the processes that run dispatchers
+    uint32_t next_process_id = 1000;
+
+public:
+    std::unique_ptr<scm_connection> connect() {
+        return std::unique_ptr<scm_connection>(new connection(shared_from_this()));
+    }
+
+    void install_service(const service_config& config) {
+        std::lock_guard<std::mutex> guard{mutex};
+        if (config.name.empty()) throw winservice_exception(TRACEMSG(
+                "Cannot create service, error: [" + error_string(87) + "]"));
+        auto it = records.find(config.name);
+        if (records.end() != it) {
+            auto code = it->second.delete_pending ? 1072 : 1073;
+            throw winservice_exception(TRACEMSG(
+                    "Cannot create service, error: [" + error_string(code) + "]"));
+        }
+        check_triggers(config);
+        auto& rec = records[config.name];
+        rec.config = config;
+        rec.status.service_type = config.service_type;
+        rec.status.current_state = state_stopped;
+    }
+
+    void uninstall_service(const std::string& service_name) {
+        std::lock_guard<std::mutex> guard{mutex};
+        auto& rec = find_record(service_name);
+        if (rec.delete_pending) throw winservice_exception(TRACEMSG(
+                "Error uninstalling service, name: [" + service_name + "]," +
+                " error: [" + error_string(1072) + "]"));
+        if (is_stopped(rec) && nullptr == rec.dispatcher.get()) {
+            records.erase(service_name);
+        } else {
+            // removed when the service is stopped, same as native SCM does
+            rec.delete_pending = true;
+        }
+    }
+
+    void start_service(const std::string& service_name) {
+        std::lock_guard<std::mutex> guard{mutex};
+        auto& rec = find_record(service_name);
+        uint32_t code = 0;
+        if (rec.delete_pending) {
+            code = 1072;
+        } else if (!is_stopped(rec)) {
+            code = 1056;
+        } else if (start_type_disabled == rec.config.start_type) {
+            code = 1058;
+        }
+        if (0 != code) throw winservice_exception(TRACEMSG(
+                "Error starting service, name: [" + service_name + "]," +
+                " error: [" + error_string(code) + "]"));
+        rec.start_requested = true;
+        service_status st;
+        st.service_type = rec.config.service_type;
+        st.current_state = state_start_pending;
+        update_status(rec, st);
+        if (nullptr != rec.dispatcher.get()) {
+            enqueue_start(rec);
+        }
+    }
+
+    service_status control_service(const std::string& service_name, uint32_t control) {
+        std::unique_lock<std::mutex> lock{mutex};
+        auto& rec = find_record(service_name);
+        if (control_interrogate == control) {
+            return rec.status;
+        }
+        uint32_t code = 0;
+        auto state = rec.status.current_state;
+        if (control_shutdown == control || control_preshutdown == control ||
+                control_power_event == control || control_session_change == control) {
+            // cannot be sent by applications
+            code = 87;
+        } else if (state_stopped == state) {
+            code = 1062;
+        } else if (state_start_pending == state || state_stop_pending == state) {
+            code = 1061;
+        } else if (!is_control_accepted(control, rec.status.controls_accepted)) {
+            code = 1052;
+        }
+        if (0 != code) throw winservice_exception(TRACEMSG(
+                "Error sending control to service, name: [" + service_name + "]," +
+                " control: [" + sl::support::to_string(control) + "]," +
+                " error: [" + error_string(code) + "]"));
+        deliver_control(lock, service_name, control);
+        return find_record(service_name).status;
+    }
+
+    service_status query_service_status(const std::string& service_name) {
+        std::lock_guard<std::mutex> guard{mutex};
+        return find_record(service_name).status;
+    }
+
+    std::vector<service_entry> enumerate_services() {
+        std::lock_guard<std::mutex> guard{mutex};
+        auto res = std::vector<service_entry>();
+        res.reserve(records.size());
+        // map is ordered by name
+        for (auto& en : records) {
+            service_entry se;
+            se.name = en.first;
+            se.display_name = en.second.config.display_name;
+            se.status = en.second.status;
+            res.push_back(std::move(se));
+        }
+        return res;
+    }
+
+    bool is_service_installed(const std::string& service_name) {
+        std::lock_guard<std::mutex> guard{mutex};
+        return records.end() != records.find(service_name);
+    }
+
+    service_config query_service_config(const std::string& service_name) {
+        std::lock_guard<std::mutex> guard{mutex};
+        auto res = find_record(service_name).config;
+        res.password.clear();
+        return res;
+    }
+
+    void change_service_config(const service_config& config, uint32_t fields) {
+        std::lock_guard<std::mutex> guard{mutex};
+        auto& rec = find_record(config.name);
+        if (rec.delete_pending) throw winservice_exception(TRACEMSG(
+                "Error changing service config, name: [" + config.name + "]," +
+                " error: [" + error_string(1072) + "]"));
+        if (0 != (fields & config_triggers)) {
+            check_triggers(config);
+        }
+        auto& cf = rec.config;
+        if (0 != (fields & config_display_name)) cf.display_name = config.display_name;
+        if (0 != (fields & config_binary_path)) {
+            if (!config.binary_path.empty()) {
+                cf.binary_path = config.binary_path;
+            }
+            cf.arguments = config.arguments;
+        }
+        if (0 != (fields & config_account)) {
+            cf.account = config.account;
+            cf.password = config.password;
+        }
+        if (0 != (fields & config_service_type)) cf.service_type = config.service_type;
+        if (0 != (fields & config_start_type)) {
+            cf.start_type = config.start_type;
+            cf.delayed_auto_start = config.delayed_auto_start;
+        }
+        if (0 != (fields & config_dependencies)) cf.dependencies = config.dependencies;
+        if (0 != (fields & config_load_order_group)) cf.load_order_group = config.load_order_group;
+        if (0 != (fields & config_triggers)) cf.triggers = config.triggers;
+        if (0 != (fields & config_description)) cf.description = config.description;
+        if (0 != (fields & config_failure_actions)) cf.failure_actions = config.failure_actions;
+        if (0 != (fields & config_preshutdown_timeout)) {
+            cf.preshutdown_timeout_millis = config.preshutdown_timeout_millis;
+        }
+        rec.config_changes += 1;
+    }
+
+    void run_dispatcher(const std::vector<std::string>& service_names,
+            std::function<void(const std::string&)> service_main) {
+        std::unique_lock<std::mutex> lock{mutex};
+        auto ds = std::make_shared<dispatcher_state>();
+        ds->process_id = next_process_id++;
+        bool launched = false;
+        for (auto& name : service_names) {
+            auto it = records.find(name);
+            if (records.end() == it) continue;
+            if (nullptr != it->second.dispatcher.get()) throw winservice_exception(TRACEMSG(
+                    "Error starting service, name: [" + name + "]," +
+                    " error: [" + error_string(1056) + "]"));
+            launched = launched || it->second.start_requested;
+        }
+        // process is expected to be launched by SCM
+        if (!launched) throw winservice_exception(TRACEMSG(
+                "Error starting service dispatcher, error: [" + error_string(1063) + "]"));
+        for (auto& name : service_names) {
+            auto it = records.find(name);
+            if (records.end() == it) continue;
+            ds->service_names.push_back(name);
+            it->second.dispatcher = ds;
+            if (it->second.start_requested) {
+                enqueue_start(it->second);
+            }
+        }
+
+        std::vector<std::thread> threads;
+        for (;;) {
+            cv.wait(lock, [&] {
+                return !ds->queue.empty() || all_stopped(*ds);
+            });
+            if (ds->queue.empty()) break;
+            auto item = std::move(ds->queue.front());
+            ds->queue.pop_front();
+            if (item.is_start) {
+                ds->started_any = true;
+                records[item.service_name].start_requested = false;
+                auto name = item.service_name;
+                threads.emplace_back([service_main, name] {
+                    service_main(name);
+                });
+            } else {
+                auto handler = records[item.service_name].handler;
+                lock.unlock();
+                if (handler) {
+                    handler(item.control, item.event_type, item.event_data);
+                }
+                lock.lock();
+                *item.delivered = true;
+                cv.notify_all();
+            }
+        }
+
+        for (auto& name : ds->service_names) {
+            auto& rec = records[name];
+            rec.dispatcher.reset();
+            rec.handler = nullptr;
+            if (rec.delete_pending) {
+                records.erase(name);
+            }
+        }
+        lock.unlock();
+        for (auto& th : threads) {
+            th.join();
+        }
+    }
+
+    void register_control_handler(const std::string& service_name,
+            std::function<bool(uint32_t, uint32_t, uint32_t)> handler) {
+        std::lock_guard<std::mutex> guard{mutex};
+        auto it = records.find(service_name);
+        if (records.end() == it || nullptr == it->second.dispatcher.get()) throw winservice_exception(TRACEMSG(
+                "Error registering control handler, name: [" + service_name + "]," +
+                " error: [" + error_string(1083) + "]"));
+        it->second.handler = std::move(handler);
+    }
+
+    void set_service_status(const std::string& service_name, const service_status& status) {
+        std::lock_guard<std::mutex> guard{mutex};
+        auto it = records.find(service_name);
+        uint32_t code = 0;
+        if (records.end() == it || !it->second.handler) {
+            code = 6;
+        } else if (status.current_state < state_stopped || status.current_state > state_paused) {
+            code = 13;
+        }
+        if (0 != code) throw winservice_exception(TRACEMSG(
+                "Error changing status to: [" + sl::support::to_string(status.current_state) + "]," +
+                " error: [" + error_string(code) + "]"));
+        update_status(it->second, status);
+    }
+
+    void send_control(const std::string& service_name, uint32_t control, uint32_t event_type,
+            uint32_t event_data) {
+        std::unique_lock<std::mutex> lock{mutex};
+        deliver_control(lock, service_name, control, event_type, event_data);
+    }
+
+    service_status wait_for_state(const std::string& service_name, uint32_t state, uint32_t timeout_millis) {
+        std::unique_lock<std::mutex> lock{mutex};
+        auto reached = cv.wait_for(lock, std::chrono::milliseconds(timeout_millis), [&] {
+            auto it = records.find(service_name);
+            return records.end() != it && state == it->second.status.current_state;
+        });
+        if (!reached) throw winservice_exception(TRACEMSG(
+                "Timeout waiting for service state, name: [" + service_name + "]," +
+                " state: [" + state_to_string(state) + "]," +
+                " timeout: [" + sl::support::to_string(timeout_millis) + "]"));
+        return find_record(service_name).status;
+    }
+
+    service_status wait_for_status(const std::string& service_name, uint32_t state, uint32_t timeout_millis) {
+        std::unique_lock<std::mutex> lock{mutex};
+        auto last = find_record(service_name).status;
+        cv.wait_for(lock, std::chrono::milliseconds(timeout_millis), [&] {
+            auto it = records.find(service_name);
+            if (records.end() != it) {
+                last = it->second.status;
+            } else {
+                // deleted after stop
+                last.current_state = state_stopped;
+            }
+            return state == last.current_state || state_stopped == last.current_state;
+        });
+        return last;
+    }
+
+    std::vector<service_status> status_history(const std::string& service_name) {
+        std::lock_guard<std::mutex> guard{mutex};
+        return find_record(service_name).history;
+    }
+
+    uint32_t config_change_count(const std::string& service_name) {
+        std::lock_guard<std::mutex> guard{mutex};
+        return find_record(service_name).config_changes;
+    }
+
+    void set_control_timeout_millis(uint32_t millis) {
+        std::lock_guard<std::mutex> guard{mutex};
+        control_timeout_millis = millis;
+    }
+
+private:
+    class connection : public scm_connection {
+        std::shared_ptr<impl> scm;
+
+    public:
+        connection(std::shared_ptr<impl> scm) :
+        scm(std::move(scm)) { }
+
+        virtual void install_service(const service_config& config) override {
+            scm->install_service(config);
+        }
+
+        virtual void uninstall_service(const std::string& service_name) override {
+            scm->uninstall_service(service_name);
+        }
+
+        virtual void start_service(const std::string& service_name) override {
+            scm->start_service(service_name);
+        }
+
+        virtual service_status control_service(const std::string& service_name, uint32_t control) override {
+            return scm->control_service(service_name, control);
+        }
+
+        virtual service_status query_service_status(const std::string& service_name) override {
+            return scm->query_service_status(service_name);
+        }
+
+        virtual std::vector<service_entry> enumerate_services() override {
+            return scm->enumerate_services();
+        }
+
+        virtual bool is_service_installed(const std::string& service_name) override {
+            return scm->is_service_installed(service_name);
+        }
+
+        virtual service_config query_service_config(const std::string& service_name) override {
+            return scm->query_service_config(service_name);
+        }
+
+        virtual void change_service_config(const service_config& config, uint32_t fields) override {
+            scm->change_service_config(config, fields);
+        }
+
+        virtual service_status wait_for_status(const std::string& service_name, uint32_t state,
+                uint32_t timeout_millis) override {
+            return scm->wait_for_status(service_name, state, timeout_millis);
+        }
+    };
+
+    service_record& find_record(const std::string& service_name) {
+        auto it = records.find(service_name);
+        if (records.end() == it) throw winservice_exception(TRACEMSG(
+                "Cannot open service, name: [" + service_name + "]," +
+                " error: [" + error_string(1060) + "]"));
+        return it->second;
+    }
+
+    bool is_stopped(const service_record& rec) {
+        return state_stopped == rec.status.current_state && !rec.start_requested;
+    }
+
+    bool all_stopped(const dispatcher_state& ds) {
+        if (!ds.started_any) return false;
+        for (auto& name : ds.service_names) {
+            if (!is_stopped(records[name])) return false;
+        }
+        return true;
+    }
+
+    void update_status(service_record& rec, const service_status& status) {
+        rec.status = status;
+        bool hosted = nullptr != rec.dispatcher.get() && state_stopped != status.current_state;
+        rec.status.process_id = hosted ? rec.dispatcher->process_id : 0;
+        rec.history.push_back(rec.status);
+        cv.notify_all();
+    }
+
+    void enqueue_start(service_record& rec) {
+        work_item item;
+        item.service_name = rec.config.name;
+        item.is_start = true;
+        rec.dispatcher->queue.push_back(std::move(item));
+        cv.notify_all();
+    }
+
+    void deliver_control(std::unique_lock<std::mutex>& lock, const std::string& service_name, uint32_t control,
+            uint32_t event_type = 0, uint32_t event_data = 0) {
+        auto& rec = find_record(service_name);
+        if (nullptr == rec.dispatcher.get() || !rec.handler) throw winservice_exception(TRACEMSG(
+                "Error sending control to service, name: [" + service_name + "]," +
+                " control: [" + sl::support::to_string(control) + "]," +
+                " error: [" + error_string(1062) + "]"));
+        work_item item;
+        item.service_name = service_name;
+        item.control = control;
+        item.event_type = event_type;
+        item.event_data = event_data;
+        item.delivered = std::make_shared<bool>(false);
+        auto delivered = item.delivered;
+        rec.dispatcher->queue.push_back(std::move(item));
+        cv.notify_all();
+        auto success = cv.wait_for(lock, std::chrono::milliseconds(control_timeout_millis), [&delivered] {
+            return *delivered;
+        });
+        if (!success) throw winservice_exception(TRACEMSG(
+                "Error sending control to service, name: [" + service_name + "]," +
+                " control: [" + sl::support::to_string(control) + "]," +
+                " error: [" + error_string(1053) + "]"));
+    }
+};
+
+simulated_scm::simulated_scm() :
+pimpl(std::make_shared<impl>()) { }
+
+simulated_scm::~simulated_scm() { }
+
+std::unique_ptr<scm_connection> simulated_scm::connect() {
+    return pimpl->connect();
+}
+
+void simulated_scm::run_dispatcher(const std::vector<std::string>& service_names,
+        std::function<void(const std::string&)> service_main) {
+    pimpl->run_dispatcher(service_names, std::move(service_main));
+}
+
+void simulated_scm::register_control_handler(const std::string& service_name,
+        std::function<bool(uint32_t, uint32_t, uint32_t)> handler) {
+    pimpl->register_control_handler(service_name, std::move(handler));
+}
+
+void simulated_scm::set_service_status(const std::string& service_name, const service_status& status) {
+    pimpl->set_service_status(service_name, status);
+}
+
+void simulated_scm::send_control(const std::string& service_name, uint32_t control, uint32_t event_type,
+        uint32_t event_data) {
+    pimpl->send_control(service_name, control, event_type, event_data);
+}
+
+service_status simulated_scm::wait_for_state(const std::string& service_name, uint32_t state,
+        uint32_t timeout_millis) {
+    return pimpl->wait_for_state(service_name, state, timeout_millis);
+}
+
+std::vector<service_status> simulated_scm::status_history(const std::string& service_name) {
+    return pimpl->status_history(service_name);
+}
+
+uint32_t simulated_scm::config_change_count(const std::string& service_name) {
+    return pimpl->config_change_count(service_name);
+}
+
+void simulated_scm::set_control_timeout_millis(uint32_t millis) {
+    pimpl->set_control_timeout_millis(millis);
+}
+
+} // namespace
+}
+
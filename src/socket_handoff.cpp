@@ -0,0 +1,934 @@
+/*
+ * Copyright 2026, alex at staticlibs.net
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * File:   socket_handoff.cpp
+ * Author: alex
+ *
+ * Created on October 17, 2026, 3:40 PM
+ */
+
+#include "staticlib/winservice/socket_handoff.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <mutex>
+#include <thread>
+#include <utility>
+
+#include "staticlib/config.hpp"
+
+#ifdef STATICLIB_WINDOWS
+#include <winsock2.h>
+#include "staticlib/support/windows.hpp"
+#include <sddl.h>
+#else // !STATICLIB_WINDOWS
+#include <cerrno>
+#include <cstddef>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <sys/types.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif // STATICLIB_WINDOWS
+
+#include "staticlib/support.hpp"
+#ifdef STATICLIB_WINDOWS
+#include "staticlib/utils.hpp"
+#endif // STATICLIB_WINDOWS
+
+#include "staticlib/winservice/winservice_exception.hpp"
+
+namespace staticlib {
+namespace winservice {
+
+namespace { // anonymous
+
+// "SLHO" in little-endian
+const uint32_t handoff_magic = 0x4f484c53;
+
+// sent by the new instance after it has put the sockets into use
+const char release_byte = 'R';
+
+// sent back by the old instance after it has stopped listening on the endpoint
+const char released_byte = 'D';
+
+// how often the accept loop checks whether the server is closed
+const int accept_poll_millis = 100;
+
+// how often the pipe is checked for incoming data
+const int pipe_poll_millis = 10;
+
+// sent before the sockets, all fields are in host byte order,
+// both sides run on the same host
+struct handoff_header {
+    uint32_t magic;
+    uint32_t socket_count;
+    uint32_t state_length;
+    uint32_t reserved;
+};
+
+handoff_header make_header(const handoff_state& st) {
+    if (st.sockets.size() > max_handoff_sockets) throw winservice_exception(TRACEMSG(
+            "Too many sockets for handoff, count: [" + sl::support::to_string(st.sockets.size()) + "]," +
+            " max: [" + sl::support::to_string(max_handoff_sockets) + "]"));
+    handoff_header res;
+    res.magic = handoff_magic;
+    res.socket_count = static_cast<uint32_t>(st.sockets.size());
+    res.state_length = static_cast<uint32_t>(st.state.length());
+    res.reserved = 0;
+    return res;
+}
+
+void check_header(const handoff_header& header) {
+    if (handoff_magic != header.magic || header.socket_count > max_handoff_sockets) {
+        throw winservice_exception(TRACEMSG(
+                "Invalid handoff header received, magic: [" + sl::support::to_string(header.magic) + "]," +
+                " sockets count: [" + sl::support::to_string(header.socket_count) + "]"));
+    }
+}
+
+#ifdef STATICLIB_WINDOWS
+
+std::string pipe_path(const std::string& endpoint) {
+    if (0 == endpoint.find("\\\\")) {
+        return endpoint;
+    }
+    return "\\\\.\\pipe\\" + endpoint;
+}
+
+std::string last_error_str() {
+    return sl::utils::errcode_to_string(::GetLastError());
+}
+
+// returns false if the other side has closed the pipe before any data
+bool read_all(HANDLE pipe, char* buf, size_t len) {
+    size_t done = 0;
+    while (done < len) {
+        DWORD read = 0;
+        auto success = ::ReadFile(pipe, buf + done, static_cast<DWORD>(len - done),
+                std::addressof(read), nullptr);
+        if (0 == success) {
+            auto err = ::GetLastError();
+            if (ERROR_BROKEN_PIPE == err && 0 == done) {
+                return false;
+            }
+            throw winservice_exception(TRACEMSG(
+                    "Handoff pipe read error, error: [" + sl::utils::errcode_to_string(err) + "]"));
+        }
+        done += read;
+    }
+    return true;
+}
+
+void write_all(HANDLE pipe, const char* buf, size_t len) {
+    size_t done = 0;
+    while (done < len) {
+        DWORD written = 0;
+        auto success = ::WriteFile(pipe, buf + done, static_cast<DWORD>(len - done),
+                std::addressof(written), nullptr);
+        if (0 == success) throw winservice_exception(TRACEMSG(
+                "Handoff pipe write error, error: [" + last_error_str() + "]"));
+        done += written;
+    }
+}
+
+// named pipes do not support read timeouts in blocking mode
+void wait_for_data(HANDLE pipe, uint32_t timeout_millis) {
+    auto start = std::chrono::steady_clock::now();
+    for (;;) {
+        DWORD available = 0;
+        auto success = ::PeekNamedPipe(pipe, nullptr, 0, nullptr, std::addressof(available), nullptr);
+        if (0 == success || available > 0) {
+            // errors are reported by 'ReadFile'
+            return;
+        }
+        auto elapsed = std::chrono::steady_clock::now() - start;
+        auto elapsed_millis = std::chrono::duration_cast<std::chrono::milliseconds>(elapsed).count();
+        if (elapsed_millis >= static_cast<long long>(timeout_millis)) {
+            throw winservice_exception(TRACEMSG(
+                    "Handoff pipe read timeout, timeout millis: [" + sl::support::to_string(timeout_millis) + "]"));
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(pipe_poll_millis));
+    }
+}
+
+// allows access to the pipe only to the user of the current process
+class pipe_security {
+    PSECURITY_DESCRIPTOR descriptor = nullptr;
+
+public:
+    SECURITY_ATTRIBUTES attributes;
+
+    pipe_security() {
+        HANDLE token = nullptr;
+        if (0 == ::OpenProcessToken(::GetCurrentProcess(), TOKEN_QUERY, std::addressof(token))) {
+            throw winservice_exception(TRACEMSG(
+                    "'OpenProcessToken' error, error: [" + last_error_str() + "]"));
+        }
+        auto deferred_token = sl::support::defer([token]() STATICLIB_NOEXCEPT {
+            ::CloseHandle(token);
+        });
+        DWORD len = 0;
+        ::GetTokenInformation(token, TokenUser, nullptr, 0, std::addressof(len));
+        auto buf = std::vector<char>(len);
+        if (0 == ::GetTokenInformation(token, TokenUser, buf.data(), len, std::addressof(len))) {
+            throw winservice_exception(TRACEMSG(
+                    "'GetTokenInformation' error, error: [" + last_error_str() + "]"));
+        }
+        auto user = reinterpret_cast<TOKEN_USER*>(buf.data());
+        wchar_t* sid = nullptr;
+        if (0 == ::ConvertSidToStringSidW(user->User.Sid, std::addressof(sid))) {
+            throw winservice_exception(TRACEMSG(
+                    "'ConvertSidToStringSidW' error, error: [" + last_error_str() + "]"));
+        }
+        auto deferred_sid = sl::support::defer([sid]() STATICLIB_NOEXCEPT {
+            ::LocalFree(sid);
+        });
+        // protected DACL with the single entry: full access for the user
+        auto sddl = std::wstring(L"D:P(A;;GA;;;") + sid + L")";
+        if (0 == ::ConvertStringSecurityDescriptorToSecurityDescriptorW(sddl.c_str(),
+                SDDL_REVISION_1, std::addressof(descriptor), nullptr)) {
+            throw winservice_exception(TRACEMSG(
+                    "'ConvertStringSecurityDescriptorToSecurityDescriptorW' error, error: [" + last_error_str() + "]"));
+        }
+        attributes.nLength = sizeof(attributes);
+        attributes.lpSecurityDescriptor = descriptor;
+        attributes.bInheritHandle = FALSE;
+    }
+
+    ~pipe_security() STATICLIB_NOEXCEPT {
+        if (nullptr != descriptor) {
+            ::LocalFree(descriptor);
+        }
+    }
+
+    pipe_security(const pipe_security&) = delete;
+
+    pipe_security& operator=(const pipe_security&) = delete;
+};
+
+// Winsock must be initialized to duplicate and to open sockets
+class winsock_init {
+public:
+    winsock_init() {
+        WSADATA wd;
+        auto err = ::WSAStartup(MAKEWORD(2, 2), std::addressof(wd));
+        if (0 != err) throw winservice_exception(TRACEMSG(
+                "'WSAStartup' error, error: [" + sl::utils::errcode_to_string(static_cast<uint32_t>(err)) + "]"));
+    }
+
+    ~winsock_init() STATICLIB_NOEXCEPT {
+        ::WSACleanup();
+    }
+
+    winsock_init(const winsock_init&) = delete;
+
+    winsock_init& operator=(const winsock_init&) = delete;
+};
+
+#else // !STATICLIB_WINDOWS
+
+std::string errno_str() {
+    return std::string(std::strerror(errno));
+}
+
+socklen_t make_address(const std::string& path, struct sockaddr_un& addr) {
+    std::memset(std::addressof(addr), '\0', sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    if (path.empty() || path.length() >= sizeof(addr.sun_path)) throw winservice_exception(TRACEMSG(
+            "Invalid handoff socket path: [" + path + "]"));
+    std::memcpy(addr.sun_path, path.data(), path.length());
+    if ('@' == path[0]) {
+        // abstract namespace
+        addr.sun_path[0] = '\0';
+    }
+    return static_cast<socklen_t>(offsetof(struct sockaddr_un, sun_path) + path.length());
+}
+
+int create_socket() {
+    auto fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (-1 == fd) throw winservice_exception(TRACEMSG(
+            "Error creating handoff socket, error: [" + errno_str() + "]"));
+    ::fcntl(fd, F_SETFD, FD_CLOEXEC);
+    return fd;
+}
+
+// returns false if the other side has closed the connection before any data
+bool read_all(int fd, char* buf, size_t len) {
+    size_t done = 0;
+    while (done < len) {
+        auto count = ::recv(fd, buf + done, len - done, 0);
+        if (count < 0 && EINTR == errno) continue;
+        if (count < 0) throw winservice_exception(TRACEMSG(
+                "Handoff socket read error, error: [" + errno_str() + "]"));
+        if (0 == count) {
+            if (0 == done) {
+                return false;
+            }
+            throw winservice_exception(TRACEMSG("Handoff connection closed unexpectedly"));
+        }
+        done += static_cast<size_t>(count);
+    }
+    return true;
+}
+
+void write_all(int fd, const char* buf, size_t len) {
+    size_t done = 0;
+    while (done < len) {
+        auto count = ::send(fd, buf + done, len - done, MSG_NOSIGNAL);
+        if (count < 0 && EINTR == errno) continue;
+        if (count < 0) throw winservice_exception(TRACEMSG(
+                "Handoff socket write error, error: [" + errno_str() + "]"));
+        done += static_cast<size_t>(count);
+    }
+}
+
+void set_timeout(int fd, uint32_t timeout_millis) {
+    struct timeval tv;
+    tv.tv_sec = static_cast<time_t>(timeout_millis / 1000);
+    tv.tv_usec = static_cast<suseconds_t>((timeout_millis % 1000) * 1000);
+    ::setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, std::addressof(tv), sizeof(tv));
+    ::setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, std::addressof(tv), sizeof(tv));
+}
+
+// sockets are passed only to the processes of the same user
+bool is_peer_same_user(int fd) {
+#ifdef SO_PEERCRED
+    struct ucred cred;
+    socklen_t len = sizeof(cred);
+    if (0 != ::getsockopt(fd, SOL_SOCKET, SO_PEERCRED, std::addressof(cred), std::addressof(len))) {
+        return false;
+    }
+    return cred.uid == ::geteuid();
+#else // !SO_PEERCRED
+    uid_t uid = 0;
+    gid_t gid = 0;
+    if (0 != ::getpeereid(fd, std::addressof(uid), std::addressof(gid))) {
+        return false;
+    }
+    return uid == ::geteuid();
+#endif // SO_PEERCRED
+}
+
+#endif // STATICLIB_WINDOWS
+
+// state used by the background thread, is kept alive by the thread,
+// so the server can be closed or dropped from 'on_released'
+class server_worker {
+    std::string endpoint;
+    std::function<handoff_state()> provider;
+    std::function<void()> on_released;
+    uint32_t timeout_millis;
+    std::atomic<bool> closed;
+    std::atomic<bool> released;
+    std::mutex mutex;
+#ifdef STATICLIB_WINDOWS
+    winsock_init winsock;
+    std::wstring wpath;
+    HANDLE pipe = INVALID_HANDLE_VALUE;
+#else // !STATICLIB_WINDOWS
+    int listen_fd = -1;
+    // guarded by mutex, so it is not shut down after being closed and reused
+    int conn_fd = -1;
+#endif // STATICLIB_WINDOWS
+
+public:
+    server_worker(const std::string& endpoint, std::function<handoff_state()> provider,
+            std::function<void()> on_released, uint32_t timeout_millis) :
+    endpoint(endpoint.data(), endpoint.length()),
+    provider(std::move(provider)),
+    on_released(std::move(on_released)),
+    timeout_millis(timeout_millis),
+    closed(false),
+    released(false) {
+        if (!this->provider) throw winservice_exception(TRACEMSG(
+                "Invalid empty handoff state provider specified"));
+        open_endpoint();
+    }
+
+    ~server_worker() STATICLIB_NOEXCEPT {
+        close_endpoint();
+    }
+
+    server_worker(const server_worker&) = delete;
+
+    server_worker& operator=(const server_worker&) = delete;
+
+    bool is_released() const {
+        return released.load();
+    }
+
+    void request_close() STATICLIB_NOEXCEPT {
+        if (!closed.exchange(true)) {
+            wakeup_worker();
+        }
+    }
+
+    void run() {
+        while (!closed.load()) {
+            try {
+                if (accept_and_serve()) {
+                    break;
+                }
+            } catch (const std::exception&) {
+                // new instance has failed during the handoff,
+                // continue serving and wait for the next one
+            }
+        }
+        {
+            std::lock_guard<std::mutex> guard{mutex};
+            close_endpoint();
+        }
+        if (released.load() && on_released) {
+            on_released();
+        }
+    }
+
+private:
+#ifdef STATICLIB_WINDOWS
+
+    void open_endpoint() {
+        wpath = sl::utils::widen(pipe_path(endpoint));
+        pipe_security security;
+        pipe = ::CreateNamedPipeW(wpath.c_str(),
+                PIPE_ACCESS_DUPLEX | FILE_FLAG_FIRST_PIPE_INSTANCE,
+                PIPE_TYPE_BYTE | PIPE_READMODE_BYTE | PIPE_WAIT | PIPE_REJECT_REMOTE_CLIENTS,
+                1, 4096, 4096, 0, std::addressof(security.attributes));
+        if (INVALID_HANDLE_VALUE == pipe) throw winservice_exception(TRACEMSG(
+                "Error creating handoff pipe, name: [" + endpoint + "]," +
+                " error: [" + last_error_str() + "]"));
+    }
+
+    void close_endpoint() STATICLIB_NOEXCEPT {
+        if (INVALID_HANDLE_VALUE != pipe) {
+            ::CloseHandle(pipe);
+            pipe = INVALID_HANDLE_VALUE;
+        }
+    }
+
+    void wakeup_worker() STATICLIB_NOEXCEPT {
+        // empty connection wakes up 'ConnectNamedPipe', blocking 'ReadFile'
+        // is interrupted by the owner of the thread
+        auto conn = ::CreateFileW(wpath.c_str(), GENERIC_READ | GENERIC_WRITE, 0, nullptr, OPEN_EXISTING, 0, nullptr);
+        if (INVALID_HANDLE_VALUE != conn) {
+            ::CloseHandle(conn);
+        }
+    }
+
+    bool accept_and_serve() {
+        auto success = ::ConnectNamedPipe(pipe, nullptr);
+        auto err = 0 == success ? ::GetLastError() : ERROR_SUCCESS;
+        if (0 == success && ERROR_PIPE_CONNECTED != err) {
+            if (closed.load()) {
+                return false;
+            }
+            if (ERROR_NO_DATA == err) {
+                // client has connected and disconnected already
+                ::DisconnectNamedPipe(pipe);
+                return false;
+            }
+            throw winservice_exception(TRACEMSG(
+                    "'ConnectNamedPipe' error, error: [" + sl::utils::errcode_to_string(err) + "]"));
+        }
+        auto deferred = sl::support::defer([this]() STATICLIB_NOEXCEPT {
+            if (INVALID_HANDLE_VALUE != pipe) {
+                ::DisconnectNamedPipe(pipe);
+            }
+        });
+        DWORD pid = 0;
+        wait_for_data(pipe, timeout_millis);
+        if (!read_all(pipe, reinterpret_cast<char*>(std::addressof(pid)), sizeof(pid))) {
+            return false;
+        }
+        auto st = provider();
+        auto header = make_header(st);
+        auto infos = std::vector<WSAPROTOCOL_INFOW>(st.sockets.size());
+        for (size_t i = 0; i < st.sockets.size(); i++) {
+            auto sock = static_cast<SOCKET>(st.sockets[i]);
+            auto err = ::WSADuplicateSocketW(sock, pid, std::addressof(infos[i]));
+            if (0 != err) throw winservice_exception(TRACEMSG(
+                    "'WSADuplicateSocketW' error, socket: [" + sl::support::to_string(st.sockets[i]) + "]," +
+                    " error: [" + sl::utils::errcode_to_string(static_cast<uint32_t>(::WSAGetLastError())) + "]"));
+        }
+        write_all(pipe, reinterpret_cast<const char*>(std::addressof(header)), sizeof(header));
+        if (!infos.empty()) {
+            write_all(pipe, reinterpret_cast<const char*>(infos.data()), infos.size() * sizeof(WSAPROTOCOL_INFOW));
+        }
+        write_all(pipe, st.state.data(), st.state.length());
+        char ack = '\0';
+        wait_for_data(pipe, timeout_millis);
+        if (!read_all(pipe, std::addressof(ack), 1) || release_byte != ack) {
+            return false;
+        }
+        // name is freed for the handoff server of the new instance
+        // when the handle is closed, new instance waits for it
+        auto conn = pipe;
+        pipe = INVALID_HANDLE_VALUE;
+        auto deferred_close = sl::support::defer([conn]() STATICLIB_NOEXCEPT {
+            ::FlushFileBuffers(conn);
+            ::CloseHandle(conn);
+        });
+        released.store(true);
+        write_all(conn, std::addressof(released_byte), 1);
+        return true;
+    }
+
+#else // !STATICLIB_WINDOWS
+
+    void open_endpoint() {
+        struct sockaddr_un addr;
+        auto addr_len = make_address(endpoint, addr);
+        listen_fd = create_socket();
+        auto success = false;
+        auto deferred = sl::support::defer([this, &success]() STATICLIB_NOEXCEPT {
+            if (!success) {
+                ::close(listen_fd);
+                listen_fd = -1;
+            }
+        });
+        auto paddr = reinterpret_cast<const struct sockaddr*>(std::addressof(addr));
+        auto err = ::bind(listen_fd, paddr, addr_len);
+        if (-1 == err && EADDRINUSE == errno && '@' != endpoint[0]) {
+            // socket file may be left by the crashed instance
+            auto probe = create_socket();
+            auto probe_err = ::connect(probe, paddr, addr_len);
+            auto probe_errno = errno;
+            ::close(probe);
+            if (-1 == probe_err && ECONNREFUSED == probe_errno) {
+                ::unlink(endpoint.c_str());
+                err = ::bind(listen_fd, paddr, addr_len);
+            } else {
+                errno = EADDRINUSE;
+            }
+        }
+        if (-1 == err) throw winservice_exception(TRACEMSG(
+                "Error binding handoff socket, path: [" + endpoint + "]," +
+                " error: [" + errno_str() + "]"));
+        if (-1 == ::listen(listen_fd, 4)) throw winservice_exception(TRACEMSG(
+                "Error listening on handoff socket, path: [" + endpoint + "]," +
+                " error: [" + errno_str() + "]"));
+        success = true;
+    }
+
+    void close_endpoint() STATICLIB_NOEXCEPT {
+        if (-1 != listen_fd) {
+            ::close(listen_fd);
+            listen_fd = -1;
+            if ('@' != endpoint[0]) {
+                ::unlink(endpoint.c_str());
+            }
+        }
+    }
+
+    void wakeup_worker() STATICLIB_NOEXCEPT {
+        // accept loop checks the flag, connection may be blocked in 'recv'
+        std::lock_guard<std::mutex> guard{mutex};
+        if (-1 != conn_fd) {
+            ::shutdown(conn_fd, SHUT_RDWR);
+        }
+    }
+
+    bool accept_and_serve() {
+        struct pollfd pfd;
+        pfd.fd = listen_fd;
+        pfd.events = POLLIN;
+        pfd.revents = 0;
+        auto count = ::poll(std::addressof(pfd), 1, accept_poll_millis);
+        if (count <= 0) {
+            return false;
+        }
+        auto fd = ::accept(listen_fd, nullptr, nullptr);
+        if (-1 == fd) {
+            return false;
+        }
+        ::fcntl(fd, F_SETFD, FD_CLOEXEC);
+        {
+            std::lock_guard<std::mutex> guard{mutex};
+            conn_fd = fd;
+        }
+        auto deferred = sl::support::defer([this, fd]() STATICLIB_NOEXCEPT {
+            std::lock_guard<std::mutex> guard{mutex};
+            conn_fd = -1;
+            ::close(fd);
+        });
+        if (closed.load() || !is_peer_same_user(fd)) {
+            return false;
+        }
+        set_timeout(fd, timeout_millis);
+        uint32_t pid = 0;
+        if (!read_all(fd, reinterpret_cast<char*>(std::addressof(pid)), sizeof(pid))) {
+            return false;
+        }
+        auto st = provider();
+        auto header = make_header(st);
+        send_header(fd, header, st.sockets);
+        write_all(fd, st.state.data(), st.state.length());
+        char ack = '\0';
+        if (!read_all(fd, std::addressof(ack), 1) || release_byte != ack) {
+            return false;
+        }
+        // free the path for the handoff server of the new instance
+        {
+            std::lock_guard<std::mutex> guard{mutex};
+            close_endpoint();
+        }
+        released.store(true);
+        write_all(fd, std::addressof(released_byte), 1);
+        return true;
+    }
+
+    void send_header(int fd, handoff_header& header, const std::vector<int64_t>& sockets) {
+        struct iovec iov;
+        iov.iov_base = std::addressof(header);
+        iov.iov_len = sizeof(header);
+        struct msghdr msg;
+        std::memset(std::addressof(msg), '\0', sizeof(msg));
+        msg.msg_iov = std::addressof(iov);
+        msg.msg_iovlen = 1;
+        auto control = std::vector<char>();
+        if (!sockets.empty()) {
+            auto fds_len = sockets.size() * sizeof(int);
+            control.resize(CMSG_SPACE(fds_len));
+            msg.msg_control = control.data();
+            msg.msg_controllen = control.size();
+            auto cmsg = CMSG_FIRSTHDR(std::addressof(msg));
+            cmsg->cmsg_level = SOL_SOCKET;
+            cmsg->cmsg_type = SCM_RIGHTS;
+            cmsg->cmsg_len = CMSG_LEN(fds_len);
+            auto fds = reinterpret_cast<int*>(CMSG_DATA(cmsg));
+            for (size_t i = 0; i < sockets.size(); i++) {
+                fds[i] = static_cast<int>(sockets[i]);
+            }
+        }
+        ssize_t sent = -1;
+        do {
+            sent = ::sendmsg(fd, std::addressof(msg), MSG_NOSIGNAL);
+        } while (sent < 0 && EINTR == errno);
+        if (sent < 0) throw winservice_exception(TRACEMSG(
+                "Error sending handoff sockets, error: [" + errno_str() + "]"));
+        // fds are attached to the first byte, rest of the header is sent as plain data
+        auto rest = static_cast<size_t>(sent);
+        if (rest < sizeof(header)) {
+            write_all(fd, reinterpret_cast<const char*>(std::addressof(header)) + rest, sizeof(header) - rest);
+        }
+    }
+
+#endif // STATICLIB_WINDOWS
+};
+
+} // namespace
+
+class handoff_server::impl {
+    std::shared_ptr<server_worker> state;
+    std::thread worker;
+
+public:
+    impl(const std::string& endpoint, std::function<handoff_state()> provider,
+            std::function<void()> on_released, uint32_t timeout_millis) :
+    state(std::make_shared<server_worker>(endpoint, std::move(provider), std::move(on_released), timeout_millis)) {
+        auto st = state;
+        worker = std::thread([st] {
+            st->run();
+        });
+    }
+
+    ~impl() STATICLIB_NOEXCEPT {
+        close();
+        if (worker.joinable()) {
+            // dropped from 'on_released', worker thread finishes on its own
+            worker.detach();
+        }
+    }
+
+    impl(const impl&) = delete;
+
+    impl& operator=(const impl&) = delete;
+
+    bool is_released() const {
+        return state->is_released();
+    }
+
+    void close() STATICLIB_NOEXCEPT {
+        state->request_close();
+        // cannot be joined from 'on_released', endpoint is already closed there
+        if (worker.joinable() && std::this_thread::get_id() != worker.get_id()) {
+#ifdef STATICLIB_WINDOWS
+            // interrupts blocking 'ConnectNamedPipe' or 'ReadFile'
+            ::CancelSynchronousIo(static_cast<HANDLE>(worker.native_handle()));
+#endif // STATICLIB_WINDOWS
+            worker.join();
+        }
+    }
+};
+
+class handoff_client::impl {
+    std::string endpoint;
+#ifdef STATICLIB_WINDOWS
+    winsock_init winsock;
+    HANDLE pipe = INVALID_HANDLE_VALUE;
+#else // !STATICLIB_WINDOWS
+    int fd = -1;
+#endif // STATICLIB_WINDOWS
+
+public:
+    impl(const std::string& endpoint) :
+    endpoint(endpoint.data(), endpoint.length()) { }
+
+    ~impl() STATICLIB_NOEXCEPT {
+        disconnect();
+    }
+
+    impl(const impl&) = delete;
+
+    impl& operator=(const impl&) = delete;
+
+#ifdef STATICLIB_WINDOWS
+
+    bool receive(uint32_t timeout_millis, handoff_state& out) {
+        disconnect();
+        auto wpath = sl::utils::widen(pipe_path(endpoint));
+        if (0 == ::WaitNamedPipeW(wpath.c_str(), timeout_millis)) {
+            auto err = ::GetLastError();
+            if (ERROR_FILE_NOT_FOUND == err) {
+                return false;
+            }
+            throw winservice_exception(TRACEMSG("Error waiting for handoff pipe, name: [" + endpoint + "]," +
+                    " error: [" + sl::utils::errcode_to_string(err) + "]"));
+        }
+        pipe = ::CreateFileW(wpath.c_str(), GENERIC_READ | GENERIC_WRITE, 0, nullptr, OPEN_EXISTING, 0, nullptr);
+        if (INVALID_HANDLE_VALUE == pipe) {
+            auto err = ::GetLastError();
+            if (ERROR_FILE_NOT_FOUND == err) {
+                return false;
+            }
+            throw winservice_exception(TRACEMSG("Error opening handoff pipe, name: [" + endpoint + "]," +
+                    " error: [" + sl::utils::errcode_to_string(err) + "]"));
+        }
+        auto success = false;
+        auto deferred = sl::support::defer([this, &success]() STATICLIB_NOEXCEPT {
+            if (!success) {
+                disconnect();
+            }
+        });
+        DWORD pid = ::GetCurrentProcessId();
+        write_all(pipe, reinterpret_cast<const char*>(std::addressof(pid)), sizeof(pid));
+        handoff_header header;
+        if (!read_all(pipe, reinterpret_cast<char*>(std::addressof(header)), sizeof(header))) {
+            throw winservice_exception(TRACEMSG("Handoff pipe closed by the running instance"));
+        }
+        check_header(header);
+        auto infos = std::vector<WSAPROTOCOL_INFOW>(header.socket_count);
+        if (!infos.empty()) {
+            read_all(pipe, reinterpret_cast<char*>(infos.data()), infos.size() * sizeof(WSAPROTOCOL_INFOW));
+        }
+        auto state = std::string();
+        state.resize(header.state_length);
+        if (!state.empty()) {
+            read_all(pipe, std::addressof(state.front()), state.length());
+        }
+        auto sockets = std::vector<int64_t>();
+        auto deferred_sockets = sl::support::defer([&sockets]() STATICLIB_NOEXCEPT {
+            for (auto sock : sockets) {
+                ::closesocket(static_cast<SOCKET>(sock));
+            }
+        });
+        for (auto& info : infos) {
+            auto sock = ::WSASocketW(FROM_PROTOCOL_INFO, FROM_PROTOCOL_INFO, FROM_PROTOCOL_INFO,
+                    std::addressof(info), 0, WSA_FLAG_OVERLAPPED);
+            if (INVALID_SOCKET == sock) throw winservice_exception(TRACEMSG(
+                    "'WSASocketW' error, error: [" + sl::utils::errcode_to_string(static_cast<uint32_t>(::WSAGetLastError())) + "]"));
+            sockets.push_back(static_cast<int64_t>(sock));
+        }
+        out.sockets = std::move(sockets);
+        sockets.clear();
+        out.state = std::move(state);
+        success = true;
+        return true;
+    }
+
+    void release_previous() {
+        if (INVALID_HANDLE_VALUE == pipe) throw winservice_exception(TRACEMSG(
+                "Handoff state was not received, endpoint: [" + endpoint + "]"));
+        auto deferred = sl::support::defer([this]() STATICLIB_NOEXCEPT {
+            disconnect();
+        });
+        write_all(pipe, std::addressof(release_byte), 1);
+        char confirm = '\0';
+        if (!read_all(pipe, std::addressof(confirm), 1) || released_byte != confirm) {
+            throw winservice_exception(TRACEMSG("Release was not confirmed by the running instance"));
+        }
+        // pipe is closed by the running instance when the name is freed
+        char eof = '\0';
+        if (read_all(pipe, std::addressof(eof), 1)) {
+            throw winservice_exception(TRACEMSG("Unexpected data received after the release confirmation"));
+        }
+    }
+
+private:
+    void disconnect() STATICLIB_NOEXCEPT {
+        if (INVALID_HANDLE_VALUE != pipe) {
+            ::CloseHandle(pipe);
+            pipe = INVALID_HANDLE_VALUE;
+        }
+    }
+
+#else // !STATICLIB_WINDOWS
+
+    bool receive(uint32_t timeout_millis, handoff_state& out) {
+        disconnect();
+        struct sockaddr_un addr;
+        auto addr_len = make_address(endpoint, addr);
+        fd = create_socket();
+        auto success = false;
+        auto deferred = sl::support::defer([this, &success]() STATICLIB_NOEXCEPT {
+            if (!success) {
+                disconnect();
+            }
+        });
+        set_timeout(fd, timeout_millis);
+        auto err = ::connect(fd, reinterpret_cast<const struct sockaddr*>(std::addressof(addr)), addr_len);
+        if (-1 == err) {
+            if (ENOENT == errno || ECONNREFUSED == errno) {
+                return false;
+            }
+            throw winservice_exception(TRACEMSG("Error connecting to handoff socket, path: [" + endpoint + "]," +
+                    " error: [" + errno_str() + "]"));
+        }
+        uint32_t pid = static_cast<uint32_t>(::getpid());
+        write_all(fd, reinterpret_cast<const char*>(std::addressof(pid)), sizeof(pid));
+        auto sockets = std::vector<int64_t>();
+        auto deferred_sockets = sl::support::defer([&sockets]() STATICLIB_NOEXCEPT {
+            for (auto sock : sockets) {
+                ::close(static_cast<int>(sock));
+            }
+        });
+        handoff_header header;
+        receive_header(header, sockets);
+        auto state = std::string();
+        state.resize(header.state_length);
+        if (!state.empty()) {
+            read_all(fd, std::addressof(state.front()), state.length());
+        }
+        out.sockets = std::move(sockets);
+        sockets.clear();
+        out.state = std::move(state);
+        success = true;
+        return true;
+    }
+
+    void release_previous() {
+        if (-1 == fd) throw winservice_exception(TRACEMSG(
+                "Handoff state was not received, endpoint: [" + endpoint + "]"));
+        auto deferred = sl::support::defer([this]() STATICLIB_NOEXCEPT {
+            disconnect();
+        });
+        write_all(fd, std::addressof(release_byte), 1);
+        char confirm = '\0';
+        if (!read_all(fd, std::addressof(confirm), 1) || released_byte != confirm) {
+            throw winservice_exception(TRACEMSG("Release was not confirmed by the running instance"));
+        }
+    }
+
+private:
+    void disconnect() STATICLIB_NOEXCEPT {
+        if (-1 != fd) {
+            ::close(fd);
+            fd = -1;
+        }
+    }
+
+    void receive_header(handoff_header& header, std::vector<int64_t>& sockets) {
+        struct iovec iov;
+        iov.iov_base = std::addressof(header);
+        iov.iov_len = sizeof(header);
+        struct msghdr msg;
+        std::memset(std::addressof(msg), '\0', sizeof(msg));
+        msg.msg_iov = std::addressof(iov);
+        msg.msg_iovlen = 1;
+        auto control = std::vector<char>(CMSG_SPACE(max_handoff_sockets * sizeof(int)));
+        msg.msg_control = control.data();
+        msg.msg_controllen = control.size();
+        int flags = 0;
+#ifdef MSG_CMSG_CLOEXEC
+        flags |= MSG_CMSG_CLOEXEC;
+#endif // MSG_CMSG_CLOEXEC
+        ssize_t count = -1;
+        do {
+            count = ::recvmsg(fd, std::addressof(msg), flags);
+        } while (count < 0 && EINTR == errno);
+        if (count < 0) throw winservice_exception(TRACEMSG(
+                "Error receiving handoff sockets, error: [" + errno_str() + "]"));
+        if (0 == count) throw winservice_exception(TRACEMSG(
+                "Handoff connection closed by the running instance"));
+        for (auto cmsg = CMSG_FIRSTHDR(std::addressof(msg)); nullptr != cmsg;
+                cmsg = CMSG_NXTHDR(std::addressof(msg), cmsg)) {
+            if (SOL_SOCKET != cmsg->cmsg_level || SCM_RIGHTS != cmsg->cmsg_type) {
+                continue;
+            }
+            auto fds_count = (cmsg->cmsg_len - CMSG_LEN(0)) / sizeof(int);
+            auto fds = reinterpret_cast<const int*>(CMSG_DATA(cmsg));
+            for (size_t i = 0; i < fds_count; i++) {
+#ifndef MSG_CMSG_CLOEXEC
+                ::fcntl(fds[i], F_SETFD, FD_CLOEXEC);
+#endif // !MSG_CMSG_CLOEXEC
+                sockets.push_back(static_cast<int64_t>(fds[i]));
+            }
+        }
+        if (0 != (msg.msg_flags & MSG_CTRUNC)) throw winservice_exception(TRACEMSG(
+                "Handoff sockets were truncated"));
+        auto rest = static_cast<size_t>(count);
+        if (rest < sizeof(header)) {
+            read_all(fd, reinterpret_cast<char*>(std::addressof(header)) + rest, sizeof(header) - rest);
+        }
+        check_header(header);
+        if (header.socket_count != sockets.size()) throw winservice_exception(TRACEMSG(
+                "Invalid number of handoff sockets received, expected: [" +
+                sl::support::to_string(header.socket_count) + "]," +
+                " actual: [" + sl::support::to_string(sockets.size()) + "]"));
+    }
+
+#endif // STATICLIB_WINDOWS
+};
+
+handoff_server::handoff_server(const std::string& endpoint, std::function<handoff_state()> provider,
+        std::function<void()> on_released, uint32_t timeout_millis) :
+pimpl(std::make_shared<impl>(endpoint, std::move(provider), std::move(on_released), timeout_millis)) { }
+
+bool handoff_server::is_released() const {
+    return pimpl->is_released();
+}
+
+void handoff_server::close() {
+    pimpl->close();
+}
+
+handoff_client::handoff_client(const std::string& endpoint) :
+pimpl(std::make_shared<impl>(endpoint)) { }
+
+bool handoff_client::receive(uint32_t timeout_millis, handoff_state& out) {
+    return pimpl->receive(timeout_millis, out);
+}
+
+void handoff_client::release_previous() {
+    pimpl->release_previous();
+}
+
+} // namespace
+}
@@ -0,0 +1,186 @@
+/*
+ * Copyright 2026, alex at staticlibs.net
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * File:   state_publisher.hpp
+ * Author: alex
+ *
+ * Created on October 17, 2026, 1:32 PM
+ */
+
+#ifndef STATICLIB_WINSERVICE_STATE_PUBLISHER_HPP
+#define STATICLIB_WINSERVICE_STATE_PUBLISHER_HPP
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "staticlib/winservice/service_state.hpp"
+#include "staticlib/winservice/service_status.hpp"
+
+namespace staticlib {
+namespace winservice {
+
+/**
+ * Publishes service status to application threads using a sequence lock,
+ * readers retry if the snapshot was changed while it was being read
+ */
+class state_publisher {
+    // odd while the write is in progress
+    std::atomic<uint64_t> sequence;
+    std::atomic<uint32_t> current_state;
+    std::atomic<uint32_t> check_point;
+    std::atomic<uint32_t> win32_exit_code;
+    std::atomic<uint64_t> transition_time_millis;
+
+    // writers and waiters only
+    std::mutex mutex;
+    std::condition_variable cv;
+    uint64_t next_listener_id = 1;
+    std::map<uint64_t, std::function<void(const service_state_snapshot&)>> listeners;
+
+public:
+    state_publisher() {
+        sequence.store(0, std::memory_order_relaxed);
+        current_state.store(state_stopped, std::memory_order_relaxed);
+        check_point.store(0, std::memory_order_relaxed);
+        win32_exit_code.store(0, std::memory_order_relaxed);
+        transition_time_millis.store(0, std::memory_order_relaxed);
+    }
+
+    state_publisher(const state_publisher&) = delete;
+
+    state_publisher& operator=(const state_publisher&) = delete;
+
+    typedef std::function<void(const service_state_snapshot&)> listener_type;
+
+    void publish(const service_status& status) {
+        service_state_snapshot snap;
+        auto listeners_copy = update(status, snap);
+        notify(listeners_copy, snap);
+    }
+
+    // does not call listeners, returns the ones to notify if the state was changed
+    std::vector<listener_type> update(const service_status& status, service_state_snapshot& snap) {
+        auto listeners_copy = std::vector<listener_type>();
+        std::lock_guard<std::mutex> guard{mutex};
+        bool changed = current_state.load(std::memory_order_relaxed) != status.current_state ||
+                0 == sequence.load(std::memory_order_relaxed);
+        auto seq = sequence.load(std::memory_order_relaxed);
+        sequence.store(seq + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        current_state.store(status.current_state, std::memory_order_relaxed);
+        check_point.store(status.check_point, std::memory_order_relaxed);
+        win32_exit_code.store(status.win32_exit_code, std::memory_order_relaxed);
+        if (changed) {
+            transition_time_millis.store(now_millis(), std::memory_order_relaxed);
+        }
+        sequence.store(seq + 2, std::memory_order_release);
+        cv.notify_all();
+        if (changed && !listeners.empty()) {
+            snap = read();
+            for (auto& pa : listeners) {
+                listeners_copy.push_back(pa.second);
+            }
+        }
+        return listeners_copy;
+    }
+
+    static void notify(const std::vector<listener_type>& listeners_copy,
+            const service_state_snapshot& snap) {
+        for (auto& li : listeners_copy) {
+            try {
+                li(snap);
+            } catch (...) {
+                // listener errors must not break the lifecycle
+            }
+        }
+    }
+
+    uint32_t state() const {
+        return current_state.load(std::memory_order_acquire);
+    }
+
+    service_state_snapshot read() const {
+        service_state_snapshot res;
+        for (;;) {
+            auto before = sequence.load(std::memory_order_acquire);
+            if (0 != (before & 1)) {
+                continue;
+            }
+            res.current_state = current_state.load(std::memory_order_relaxed);
+            res.check_point = check_point.load(std::memory_order_relaxed);
+            res.win32_exit_code = win32_exit_code.load(std::memory_order_relaxed);
+            res.transition_time_millis = transition_time_millis.load(std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_acquire);
+            auto after = sequence.load(std::memory_order_relaxed);
+            if (before == after) {
+                res.version = before / 2;
+                return res;
+            }
+        }
+    }
+
+    service_state_snapshot wait(std::function<bool(const service_state_snapshot&)> predicate,
+            uint32_t timeout_millis) {
+        std::unique_lock<std::mutex> lock{mutex};
+        auto res = read();
+        cv.wait_for(lock, std::chrono::milliseconds(timeout_millis), [&] {
+            res = read();
+            return predicate(res);
+        });
+        return res;
+    }
+
+    uint64_t subscribe(std::function<void(const service_state_snapshot&)> listener) {
+        std::lock_guard<std::mutex> guard{mutex};
+        auto id = next_listener_id;
+        next_listener_id += 1;
+        listeners.insert(std::make_pair(id, std::move(listener)));
+        return id;
+    }
+
+    void unsubscribe(uint64_t id) {
+        std::lock_guard<std::mutex> guard{mutex};
+        listeners.erase(id);
+    }
+
+private:
+    static uint64_t now_millis() {
+        auto since_epoch = std::chrono::system_clock::now().time_since_epoch();
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(since_epoch).count());
+    }
+};
+
+/**
+ * Returns state publisher of the specified service,
+ * creates it on the first call, publishers are never removed
+ *
+ * @param service_name service name
+ * @return state publisher
+ */
+std::shared_ptr<state_publisher> find_state_publisher(const std::string& service_name);
+
+} // namespace
+}
+
+#endif /* STATICLIB_WINSERVICE_STATE_PUBLISHER_HPP */
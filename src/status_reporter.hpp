@@ -0,0 +1,208 @@
+/*
+ * Copyright 2026, alex at staticlibs.net
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * File:   status_reporter.hpp
+ * Author: alex
+ *
+ * Created on October 17, 2026, 2:52 PM
+ */
+
+#ifndef STATICLIB_WINSERVICE_STATUS_REPORTER_HPP
+#define STATICLIB_WINSERVICE_STATUS_REPORTER_HPP
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "staticlib/config.hpp"
+#include "staticlib/support.hpp"
+
+#include "staticlib/winservice/lifecycle_events.hpp"
+#include "staticlib/winservice/scm_backend.hpp"
+#include "staticlib/winservice/service_tracer.hpp"
+
+#include "metrics_recorder.hpp"
+#include "state_publisher.hpp"
+
+namespace staticlib {
+namespace winservice {
+
+/**
+ * Publishes service status to SCM, while service is in pending state
+ * publishes increasing checkpoints periodically from a heartbeat thread
+ */
+class status_reporter {
+    std::string name;
+    std::shared_ptr<scm_backend> backend;
+    std::shared_ptr<lifecycle_event_channel> events;
+    uint32_t wait_hint_millis;
+    uint32_t heartbeat_interval_millis;
+    std::shared_ptr<metrics_recorder> metrics;
+    std::shared_ptr<state_publisher> publisher;
+
+    std::mutex mutex;
+    std::condition_variable cv;
+    service_status status;
+    // last hint reported by the transition, kept by heartbeat checkpoints
+    uint32_t progress_hint = 0;
+    bool closed = false;
+    std::thread heartbeat;
+
+public:
+    status_reporter(const std::string& name, std::shared_ptr<scm_backend> backend,
+            std::shared_ptr<lifecycle_event_channel> events, const service_status& initial_status,
+            uint32_t wait_hint_millis, uint32_t heartbeat_interval_millis,
+            std::shared_ptr<metrics_recorder> metrics, std::shared_ptr<state_publisher> publisher) :
+    name(name.data(), name.length()),
+    backend(std::move(backend)),
+    events(std::move(events)),
+    wait_hint_millis(wait_hint_millis),
+    heartbeat_interval_millis(heartbeat_interval_millis),
+    metrics(std::move(metrics)),
+    publisher(std::move(publisher)),
+    status(initial_status) {
+        if (heartbeat_interval_millis > 0) {
+            heartbeat = std::thread([this] {
+                run_heartbeat();
+            });
+        }
+    }
+
+    ~status_reporter() STATICLIB_NOEXCEPT {
+        close();
+    }
+
+    status_reporter(const status_reporter&) = delete;
+
+    status_reporter& operator=(const status_reporter&) = delete;
+
+    void close() STATICLIB_NOEXCEPT {
+        {
+            std::lock_guard<std::mutex> guard{mutex};
+            closed = true;
+            cv.notify_all();
+        }
+        if (heartbeat.joinable()) {
+            heartbeat.join();
+        }
+    }
+
+    uint32_t current_state() {
+        std::lock_guard<std::mutex> guard{mutex};
+        return status.current_state;
+    }
+
+    void set_status(uint32_t state, uint32_t error, uint32_t service_specific_error = 0) {
+        auto listeners = std::vector<state_publisher::listener_type>();
+        service_state_snapshot snap;
+        auto report_error = std::exception_ptr();
+        {
+            trace_span lock_span("status_lock_wait", "lifecycle");
+            std::lock_guard<std::mutex> guard{mutex};
+            lock_span.end();
+            status.current_state = state;
+            status.win32_exit_code = error;
+            status.service_specific_exit_code = service_specific_error;
+            progress_hint = 0;
+            if (state_running == state || state_stopped == state || state_paused == state) {
+                status.check_point = 0;
+                status.wait_hint = 0;
+            } else {
+                status.check_point += 1;
+                status.wait_hint = wait_hint_millis;
+            }
+            // application threads see the state even if SCM is not reachable
+            listeners = publisher->update(status, snap);
+            try {
+                trace_span span("scm_set_service_status", "scm");
+                backend->set_service_status(name, status);
+                metrics->record_status_update(true);
+            } catch (const std::exception& e) {
+                metrics->record_status_update(false);
+                // do not throw if error reporting is in progress
+                if (0 == error) {
+                    report_error = std::current_exception();
+                } else {
+                    events->publish(make_lifecycle_event(event_status_report_failed, severity_error, name,
+                            0, state, error, e.what()));
+                }
+            }
+        }
+        // listeners may call back into the reporter
+        state_publisher::notify(listeners, snap);
+        if (report_error) {
+            std::rethrow_exception(report_error);
+        }
+    }
+
+    void checkpoint(uint32_t wait_hint) STATICLIB_NOEXCEPT {
+        std::lock_guard<std::mutex> guard{mutex};
+        if (is_pending(status.current_state)) {
+            status.check_point += 1;
+            status.wait_hint = wait_hint;
+            progress_hint = wait_hint;
+            publish_checkpoint();
+        }
+    }
+
+private:
+    bool is_pending(uint32_t state) {
+        return state_start_pending == state || state_stop_pending == state ||
+                state_continue_pending == state || state_pause_pending == state;
+    }
+
+    // state is not changed by checkpoints, so there are no listeners to notify
+    void publish_checkpoint() STATICLIB_NOEXCEPT {
+        service_state_snapshot snap;
+        publisher->update(status, snap);
+        try {
+            backend->set_service_status(name, status);
+            metrics->record_status_update(true);
+        } catch (const std::exception& e) {
+            metrics->record_status_update(false);
+            events->publish(make_lifecycle_event(event_checkpoint_failed, severity_warning, name,
+                    status.current_state, 0, 0, e.what()));
+        }
+    }
+
+    void run_heartbeat() STATICLIB_NOEXCEPT {
+        std::unique_lock<std::mutex> lock{mutex};
+        auto interval = std::chrono::milliseconds(heartbeat_interval_millis);
+        auto next = std::chrono::steady_clock::now() + interval;
+        while (!closed) {
+            if (std::cv_status::no_timeout == cv.wait_until(lock, next)) continue;
+            next += interval;
+            if (is_pending(status.current_state)) {
+                status.check_point += 1;
+                status.wait_hint = std::max(progress_hint, wait_hint_millis);
+                publish_checkpoint();
+            }
+        }
+    }
+};
+
+} // namespace
+}
+
+#endif /* STATICLIB_WINSERVICE_STATUS_REPORTER_HPP */
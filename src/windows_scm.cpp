@@ -0,0 +1,789 @@
+/*
+ * Copyright 2026, alex at staticlibs.net
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * File:   windows_scm.cpp
+ * Author: alex
+ *
+ * Created on October 17, 2026, 11:09 AM
+ */
+
+#include "staticlib/winservice/windows_scm.hpp"
+#ifdef STATICLIB_WINDOWS
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "staticlib/support/windows.hpp"
+
+#include "staticlib/config.hpp"
+#include "staticlib/support.hpp"
+#include "staticlib/utils.hpp"
+
+#include "command_line.hpp"
+#include "guid_string.hpp"
+
+namespace staticlib {
+namespace winservice {
+
+namespace { // anonymous
+
+class service_handle_deleter {
+public:
+    void operator()(SC_HANDLE handle) {
+        CloseServiceHandle(handle);
+    }
+};
+
+using service_handle = std::unique_ptr<SC_HANDLE__, service_handle_deleter>;
+
+std::mutex& static_mutex() {
+    static std::mutex mutex{};
+    return mutex;
+}
+
+std::function<void(const std::string&)>& static_service_main() {
+    static std::function<void(const std::string&)> fun{};
+    return fun;
+}
+
+// control code, event type, event data
+typedef std::function<bool(uint32_t, uint32_t, uint32_t)> handler_fun;
+
+// handlers are passed to SCM as context pointers,
+// and are kept alive until the end of the process
+std::map<std::string, std::unique_ptr<handler_fun>>& static_control_handlers() {
+    static std::map<std::string, std::unique_ptr<handler_fun>> map{};
+    return map;
+}
+
+std::map<std::string, SERVICE_STATUS_HANDLE>& static_status_handles() {
+    static std::map<std::string, SERVICE_STATUS_HANDLE> map{};
+    return map;
+}
+
+void WINAPI service_main_trampoline(DWORD argc, LPWSTR* argv) STATICLIB_NOEXCEPT {
+    // the first argument is a service name
+    auto name = argc > 0 ? sl::utils::narrow(argv[0]) : std::string();
+    static_service_main()(name);
+}
+
+DWORD WINAPI control_handler_trampoline(DWORD control, DWORD event_type, LPVOID event_data,
+        LPVOID context) STATICLIB_NOEXCEPT {
+    auto handler = static_cast<handler_fun*>(context);
+    // event data is only valid during this call
+    DWORD data = 0;
+    if (SERVICE_CONTROL_SESSIONCHANGE == control && nullptr != event_data) {
+        data = static_cast<WTSSESSION_NOTIFICATION*>(event_data)->dwSessionId;
+    }
+    if (nullptr != handler && *handler && (*handler)(control, event_type, data)) {
+        return NO_ERROR;
+    }
+    return ERROR_CALL_NOT_IMPLEMENTED;
+}
+
+// double-null-terminated list
+std::wstring dependencies_to_wstring(const std::vector<std::string>& dependencies) {
+    auto res = std::wstring();
+    for (auto& dep : dependencies) {
+        res += sl::utils::widen(dep);
+        res.push_back(L'\0');
+    }
+    res.push_back(L'\0');
+    return res;
+}
+
+std::vector<std::string> dependencies_from_wstring(const wchar_t* list) {
+    auto res = std::vector<std::string>();
+    if (nullptr == list) {
+        return res;
+    }
+    while (L'\0' != *list) {
+        auto wdep = std::wstring(list);
+        res.push_back(sl::utils::narrow(wdep));
+        list += wdep.length() + 1;
+    }
+    return res;
+}
+
+GUID guid_to_native(const guid_parts& parts) {
+    GUID res;
+    res.Data1 = parts.data1;
+    res.Data2 = parts.data2;
+    res.Data3 = parts.data3;
+    std::memcpy(res.Data4, parts.data4, sizeof(res.Data4));
+    return res;
+}
+
+guid_parts guid_from_native(const GUID& guid) {
+    guid_parts res;
+    res.data1 = guid.Data1;
+    res.data2 = guid.Data2;
+    res.data3 = guid.Data3;
+    std::memcpy(res.data4, guid.Data4, sizeof(res.data4));
+    return res;
+}
+
+void check_triggers(const service_config& config) {
+    for (auto& tr : config.triggers) {
+        guid_parts parts;
+        if (!parse_guid_string(tr.subtype, parts)) throw winservice_exception(TRACEMSG(
+                "Invalid trigger subtype GUID, name: [" + config.name + "]," +
+                " subtype: [" + tr.subtype + "]"));
+    }
+}
+
+// restart action requires 'SERVICE_START' access
+bool has_restart_action(const service_config& config) {
+    for (auto& act : config.failure_actions.actions) {
+        if (failure_action_restart == act.type) return true;
+    }
+    return false;
+}
+
+service_status from_native(const SERVICE_STATUS& ss) {
+    service_status res;
+    res.service_type = ss.dwServiceType;
+    res.current_state = ss.dwCurrentState;
+    res.controls_accepted = ss.dwControlsAccepted;
+    res.win32_exit_code = ss.dwWin32ExitCode;
+    res.service_specific_exit_code = ss.dwServiceSpecificExitCode;
+    res.check_point = ss.dwCheckPoint;
+    res.wait_hint = ss.dwWaitHint;
+    return res;
+}
+
+service_status from_native(const SERVICE_STATUS_PROCESS& ssp) {
+    service_status res;
+    res.service_type = ssp.dwServiceType;
+    res.current_state = ssp.dwCurrentState;
+    res.controls_accepted = ssp.dwControlsAccepted;
+    res.win32_exit_code = ssp.dwWin32ExitCode;
+    res.service_specific_exit_code = ssp.dwServiceSpecificExitCode;
+    res.check_point = ssp.dwCheckPoint;
+    res.wait_hint = ssp.dwWaitHint;
+    res.process_id = ssp.dwProcessId;
+    return res;
+}
+
+// called as APC on the thread that registered the notification
+void CALLBACK status_change_callback(PVOID param) STATICLIB_NOEXCEPT {
+    auto notify = static_cast<SERVICE_NOTIFYW*>(param);
+    *static_cast<bool*>(notify->pContext) = true;
+}
+
+// caches SCM and service handles, can be used from multiple threads
+class windows_connection : public scm_connection {
+    std::mutex mutex;
+    service_handle scm;
+    DWORD scm_access = 0;
+    std::map<std::string, std::pair<std::shared_ptr<SC_HANDLE__>, DWORD>> services;
+    // reused between enumerations
+    std::vector<char> enum_buffer;
+
+public:
+    virtual void install_service(const service_config& config) override {
+        auto wdeps = dependencies_to_wstring(config.dependencies);
+        auto wgroup = sl::utils::widen(config.load_order_group);
+        auto wcmd = sl::utils::widen(compose_command_line(config.binary_path, config.arguments));
+        // invalid config must not leave the service half-configured
+        check_triggers(config);
+        DWORD access = SERVICE_QUERY_STATUS | SERVICE_CHANGE_CONFIG | DELETE;
+        if (has_restart_action(config)) {
+            access |= SERVICE_START;
+        }
+        std::lock_guard<std::mutex> guard{mutex};
+        auto service = CreateServiceW(
+                manager(SC_MANAGER_CONNECT | SC_MANAGER_CREATE_SERVICE), // SCManager database
+                sl::utils::widen(config.name).c_str(),    // Name of service
+                sl::utils::widen(config.display_name).c_str(), // Name to display
+                access,                             // Desired access
+                config.service_type,                // Service type
+                config.start_type,                  // Service start type
+                SERVICE_ERROR_NORMAL,               // Error control type
+                wcmd.c_str(),                       // Service's binary with arguments
+                config.load_order_group.empty() ? nullptr :
+                wgroup.c_str(),                     // Load ordering group
+                nullptr,                            // No tag identifier
+                config.dependencies.empty() ? nullptr :
+                wdeps.c_str(),                      // Dependencies
+                sl::utils::widen(config.account).c_str(), // Service running account
+                config.password.empty() ? nullptr :
+                sl::utils::widen(config.password).c_str() // Password of the account
+            );
+        if (nullptr == service) throw winservice_exception(TRACEMSG(
+                "Cannot create service, error: [" + sl::utils::errcode_to_string(GetLastError()) + "]"));
+        auto handle = std::shared_ptr<SC_HANDLE__>(service, service_handle_deleter());
+        services[config.name] = std::make_pair(handle, access);
+        // only non-default optional settings are applied
+        uint32_t fields = 0;
+        if (!config.description.empty()) fields |= config_description;
+        if (config.delayed_auto_start) fields |= config_start_type;
+        if (!config.failure_actions.actions.empty()) fields |= config_failure_actions;
+        if (config.preshutdown_timeout_millis > 0) fields |= config_preshutdown_timeout;
+        if (!config.triggers.empty()) fields |= config_triggers;
+        try {
+            change_config2(handle.get(), config, fields);
+        } catch (...) {
+            // rollback, service that is not running is deleted immediately
+            DeleteService(handle.get());
+            services.erase(config.name);
+            throw;
+        }
+    }
+
+    virtual void uninstall_service(const std::string& service_name) override {
+        auto service = open_service(service_name, DELETE);
+        auto success = DeleteService(service.get());
+        auto err = GetLastError();
+        drop_service(service_name);
+        if (!success) throw winservice_exception(TRACEMSG(
+                "Error uninstalling service, name: [" + service_name + "]," +
+                " error: [" + sl::utils::errcode_to_string(err) + "]"));
+    }
+
+    virtual void start_service(const std::string& service_name) override {
+        auto service = open_service(service_name, SERVICE_START);
+        auto success = StartServiceW(service.get(), 0, nullptr);
+        if (!success) {
+            auto err = GetLastError();
+            drop_service(service_name);
+            throw winservice_exception(TRACEMSG(
+                    "Error starting service, name: [" + service_name + "]," +
+                    " error: [" + sl::utils::errcode_to_string(err) + "]"));
+        }
+    }
+
+    virtual service_status control_service(const std::string& service_name, uint32_t control) override {
+        auto service = open_service(service_name, control_access(control));
+        SERVICE_STATUS ss;
+        auto success = ControlService(service.get(), control, std::addressof(ss));
+        if (!success) {
+            auto err = GetLastError();
+            drop_service(service_name);
+            throw winservice_exception(TRACEMSG(
+                    "Error sending control to service, name: [" + service_name + "]," +
+                    " control: [" + sl::support::to_string(control) + "]," +
+                    " error: [" + sl::utils::errcode_to_string(err) + "]"));
+        }
+        return from_native(ss);
+    }
+
+    virtual service_status query_service_status(const std::string& service_name) override {
+        auto service = open_service(service_name, SERVICE_QUERY_STATUS);
+        try {
+            return query_status(service.get(), service_name);
+        } catch (const std::exception&) {
+            drop_service(service_name);
+            throw;
+        }
+    }
+
+    virtual std::vector<service_entry> enumerate_services() override {
+        std::lock_guard<std::mutex> guard{mutex};
+        auto scm = manager(SC_MANAGER_CONNECT | SC_MANAGER_ENUMERATE_SERVICE);
+        auto res = std::vector<service_entry>();
+        DWORD resume = 0;
+        for (;;) {
+            if (enum_buffer.empty()) {
+                enum_buffer.resize(64 * 1024);
+            }
+            DWORD needed = 0;
+            DWORD returned = 0;
+            auto success = EnumServicesStatusExW(scm, SC_ENUM_PROCESS_INFO, SERVICE_WIN32, SERVICE_STATE_ALL,
+                    reinterpret_cast<LPBYTE>(enum_buffer.data()), static_cast<DWORD>(enum_buffer.size()),
+                    std::addressof(needed), std::addressof(returned), std::addressof(resume), nullptr);
+            auto err = success ? ERROR_SUCCESS : GetLastError();
+            if (!success && ERROR_MORE_DATA != err) throw winservice_exception(TRACEMSG(
+                    "Error enumerating services, error: [" + sl::utils::errcode_to_string(err) + "]"));
+            auto arr = reinterpret_cast<LPENUM_SERVICE_STATUS_PROCESSW>(enum_buffer.data());
+            for (DWORD i = 0; i < returned; i++) {
+                service_entry se;
+                se.name = sl::utils::narrow(arr[i].lpServiceName);
+                se.display_name = sl::utils::narrow(arr[i].lpDisplayName);
+                se.status = from_native(arr[i].ServiceStatusProcess);
+                res.push_back(std::move(se));
+            }
+            if (success) break;
+            // remaining entries are returned from the resume point
+            if (needed > enum_buffer.size()) {
+                enum_buffer.resize(needed);
+            }
+        }
+        std::sort(res.begin(), res.end(), [](const service_entry& a, const service_entry& b) {
+            return a.name < b.name;
+        });
+        return res;
+    }
+
+    virtual bool is_service_installed(const std::string& service_name) override {
+        SC_HANDLE ha = nullptr;
+        DWORD err = 0;
+        {
+            std::lock_guard<std::mutex> guard{mutex};
+            ha = OpenServiceW(manager(SC_MANAGER_CONNECT), sl::utils::widen(service_name).c_str(),
+                    SERVICE_QUERY_STATUS);
+            err = GetLastError();
+        }
+        if (nullptr != ha) {
+            CloseServiceHandle(ha);
+            return true;
+        }
+        if (ERROR_SERVICE_DOES_NOT_EXIST == err) {
+            return false;
+        }
+        throw winservice_exception(TRACEMSG(
+                "Cannot open service, name: [" + service_name + "]," +
+                " error: [" + sl::utils::errcode_to_string(err) + "]"));
+    }
+
+    virtual service_config query_service_config(const std::string& service_name) override {
+        auto service = open_service(service_name, SERVICE_QUERY_CONFIG);
+        try {
+            return query_config(service.get(), service_name);
+        } catch (const std::exception&) {
+            drop_service(service_name);
+            throw;
+        }
+    }
+
+    virtual void change_service_config(const service_config& config, uint32_t fields) override {
+        DWORD access = SERVICE_CHANGE_CONFIG;
+        if (0 != (fields & config_failure_actions) && has_restart_action(config)) {
+            access |= SERVICE_START;
+        }
+        auto service = open_service(config.name, access);
+        try {
+            change_config(service.get(), config, fields);
+            change_config2(service.get(), config, fields);
+        } catch (const std::exception&) {
+            drop_service(config.name);
+            throw;
+        }
+    }
+
+    virtual service_status wait_for_status(const std::string& service_name, uint32_t state,
+            uint32_t timeout_millis) override {
+        // dedicated handle is used, closing it cancels the pending notification
+        SC_HANDLE ha = nullptr;
+        {
+            std::lock_guard<std::mutex> guard{mutex};
+            ha = OpenServiceW(manager(SC_MANAGER_CONNECT), sl::utils::widen(service_name).c_str(),
+                    SERVICE_QUERY_STATUS);
+        }
+        if (nullptr == ha) throw winservice_exception(TRACEMSG(
+                "Cannot open service, name: [" + service_name + "]," +
+                " error: [" + sl::utils::errcode_to_string(GetLastError()) + "]"));
+        auto service = service_handle(ha, service_handle_deleter());
+        bool fired = false;
+        SERVICE_NOTIFYW notify;
+        std::memset(std::addressof(notify), '\0', sizeof(notify));
+        notify.dwVersion = SERVICE_NOTIFY_STATUS_CHANGE;
+        notify.pfnNotifyCallback = status_change_callback;
+        notify.pContext = static_cast<PVOID>(std::addressof(fired));
+        auto deferred = sl::support::defer([&service]() STATICLIB_NOEXCEPT {
+            service.reset();
+            // notification struct lives on this stack, already queued APCs must be drained
+            while (WAIT_IO_COMPLETION == SleepEx(0, TRUE)) { }
+        });
+
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout_millis);
+        // notifications are requested only for the states that complete the wait,
+        // registration for the current state would fire immediately
+        DWORD mask = (1u << (state - 1)) | SERVICE_NOTIFY_STOPPED;
+        auto st = query_status(service.get(), service_name);
+        while (state != st.current_state && state_stopped != st.current_state) {
+            fired = false;
+            auto err = NotifyServiceStatusChangeW(service.get(), mask, std::addressof(notify));
+            if (ERROR_SUCCESS != err) throw winservice_exception(TRACEMSG(
+                    "Error subscribing to service status change, name: [" + service_name + "]," +
+                    " error: [" + sl::utils::errcode_to_string(err) + "]"));
+            while (!fired) {
+                auto now = std::chrono::steady_clock::now();
+                if (now >= deadline) {
+                    // checkpoint changes are not notified, latest one is queried
+                    return query_status(service.get(), service_name);
+                }
+                auto left = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - now).count();
+                SleepEx(static_cast<DWORD>(left), TRUE);
+            }
+            if (ERROR_SUCCESS != notify.dwNotificationStatus) throw winservice_exception(TRACEMSG(
+                    "Error waiting for service status change, name: [" + service_name + "]," +
+                    " error: [" + sl::utils::errcode_to_string(notify.dwNotificationStatus) + "]"));
+            st = from_native(notify.ServiceStatus);
+        }
+        return st;
+    }
+
+private:
+    // variable-length structures are returned by SCM, size is queried first
+    std::vector<char> query_config2(SC_HANDLE service, DWORD level, const std::string& service_name) {
+        DWORD needed = 0;
+        QueryServiceConfig2W(service, level, nullptr, 0, std::addressof(needed));
+        auto buf = std::vector<char>(needed > 0 ? needed : 1);
+        auto success = QueryServiceConfig2W(service, level, reinterpret_cast<LPBYTE>(buf.data()),
+                static_cast<DWORD>(buf.size()), std::addressof(needed));
+        if (!success) throw winservice_exception(TRACEMSG(
+                "Error querying service config, name: [" + service_name + "]," +
+                " level: [" + sl::support::to_string(level) + "]," +
+                " error: [" + sl::utils::errcode_to_string(GetLastError()) + "]"));
+        return buf;
+    }
+
+    service_config query_config(SC_HANDLE service, const std::string& service_name) {
+        DWORD needed = 0;
+        QueryServiceConfigW(service, nullptr, 0, std::addressof(needed));
+        auto buf = std::vector<char>(needed > 0 ? needed : sizeof(QUERY_SERVICE_CONFIGW));
+        auto qsc = reinterpret_cast<LPQUERY_SERVICE_CONFIGW>(buf.data());
+        auto success = QueryServiceConfigW(service, qsc, static_cast<DWORD>(buf.size()), std::addressof(needed));
+        if (!success) throw winservice_exception(TRACEMSG(
+                "Error querying service config, name: [" + service_name + "]," +
+                " error: [" + sl::utils::errcode_to_string(GetLastError()) + "]"));
+        service_config res;
+        res.name = service_name;
+        res.display_name = nullptr != qsc->lpDisplayName ? sl::utils::narrow(qsc->lpDisplayName) : "";
+        auto cmd = split_command_line(nullptr != qsc->lpBinaryPathName ?
+                sl::utils::narrow(qsc->lpBinaryPathName) : "");
+        if (!cmd.empty()) {
+            res.binary_path = cmd.front();
+            res.arguments.assign(cmd.begin() + 1, cmd.end());
+        }
+        res.account = nullptr != qsc->lpServiceStartName ? sl::utils::narrow(qsc->lpServiceStartName) : "";
+        res.service_type = qsc->dwServiceType;
+        res.start_type = qsc->dwStartType;
+        res.dependencies = dependencies_from_wstring(qsc->lpDependencies);
+        res.load_order_group = nullptr != qsc->lpLoadOrderGroup ? sl::utils::narrow(qsc->lpLoadOrderGroup) : "";
+
+        auto desc_buf = query_config2(service, SERVICE_CONFIG_DESCRIPTION, service_name);
+        auto desc = reinterpret_cast<LPSERVICE_DESCRIPTIONW>(desc_buf.data());
+        res.description = nullptr != desc->lpDescription ? sl::utils::narrow(desc->lpDescription) : "";
+
+        auto delayed_buf = query_config2(service, SERVICE_CONFIG_DELAYED_AUTO_START_INFO, service_name);
+        res.delayed_auto_start = FALSE != reinterpret_cast<LPSERVICE_DELAYED_AUTO_START_INFO>(
+                delayed_buf.data())->fDelayedAutostart;
+
+        auto fa_buf = query_config2(service, SERVICE_CONFIG_FAILURE_ACTIONS, service_name);
+        auto fa = reinterpret_cast<LPSERVICE_FAILURE_ACTIONSW>(fa_buf.data());
+        res.failure_actions.reset_period_secs = fa->dwResetPeriod;
+        res.failure_actions.command = nullptr != fa->lpCommand ? sl::utils::narrow(fa->lpCommand) : "";
+        for (DWORD i = 0; i < fa->cActions; i++) {
+            service_failure_action act;
+            act.type = fa->lpsaActions[i].Type;
+            act.delay_millis = fa->lpsaActions[i].Delay;
+            res.failure_actions.actions.push_back(act);
+        }
+
+        auto pre_buf = query_config2(service, SERVICE_CONFIG_PRESHUTDOWN_INFO, service_name);
+        res.preshutdown_timeout_millis = reinterpret_cast<LPSERVICE_PRESHUTDOWN_INFO>(
+                pre_buf.data())->dwPreshutdownTimeout;
+
+        auto trig_buf = query_config2(service, SERVICE_CONFIG_TRIGGER_INFO, service_name);
+        auto trig = reinterpret_cast<PSERVICE_TRIGGER_INFO>(trig_buf.data());
+        for (DWORD i = 0; i < trig->cTriggers; i++) {
+            auto& st = trig->pTriggers[i];
+            service_trigger tr;
+            tr.type = st.dwTriggerType;
+            tr.action = st.dwAction;
+            if (nullptr != st.pTriggerSubtype) {
+                tr.subtype = format_guid_string(guid_from_native(*st.pTriggerSubtype));
+            }
+            for (DWORD j = 0; j < st.cDataItems; j++) {
+                auto& item = st.pDataItems[j];
+                if (SERVICE_TRIGGER_DATA_TYPE_STRING != item.dwDataType || nullptr == item.pData) continue;
+                auto wdata = std::wstring(reinterpret_cast<wchar_t*>(item.pData), item.cbData / sizeof(wchar_t));
+                // data is null-terminated
+                while (!wdata.empty() && L'\0' == wdata.back()) {
+                    wdata.pop_back();
+                }
+                tr.data.push_back(sl::utils::narrow(wdata));
+            }
+            res.triggers.push_back(tr);
+        }
+        return res;
+    }
+
+    void change_config(SC_HANDLE service, const service_config& config, uint32_t fields) {
+        auto wcmd = sl::utils::widen(compose_command_line(config.binary_path, config.arguments));
+        auto wdeps = dependencies_to_wstring(config.dependencies);
+        auto waccount = sl::utils::widen(config.account);
+        auto wpassword = sl::utils::widen(config.password);
+        auto wdisplay = sl::utils::widen(config.display_name);
+        auto wgroup = sl::utils::widen(config.load_order_group);
+        uint32_t main_fields = config_display_name | config_binary_path | config_account |
+                config_service_type | config_start_type | config_dependencies | config_load_order_group;
+        if (0 == (fields & main_fields)) {
+            return;
+        }
+        auto success = ChangeServiceConfigW(service,
+                0 != (fields & config_service_type) ? config.service_type : SERVICE_NO_CHANGE,
+                0 != (fields & config_start_type) ? config.start_type : SERVICE_NO_CHANGE,
+                SERVICE_NO_CHANGE,
+                0 != (fields & config_binary_path) ? wcmd.c_str() : nullptr,
+                0 != (fields & config_load_order_group) ? wgroup.c_str() : nullptr,
+                nullptr, // tag identifier
+                0 != (fields & config_dependencies) ? wdeps.c_str() : nullptr,
+                0 != (fields & config_account) ? waccount.c_str() : nullptr,
+                0 != (fields & config_account) && !config.password.empty() ? wpassword.c_str() : nullptr,
+                0 != (fields & config_display_name) ? wdisplay.c_str() : nullptr);
+        if (!success) throw winservice_exception(TRACEMSG(
+                "Error changing service config, name: [" + config.name + "]," +
+                " fields: [" + config_fields_to_string(fields) + "]," +
+                " error: [" + sl::utils::errcode_to_string(GetLastError()) + "]"));
+    }
+
+    void change_config2(SC_HANDLE service, const service_config& config, uint32_t fields) {
+        if (0 != (fields & config_description)) {
+            auto wdesc = sl::utils::widen(config.description);
+            SERVICE_DESCRIPTIONW info;
+            info.lpDescription = const_cast<LPWSTR>(wdesc.c_str());
+            apply_config2(service, SERVICE_CONFIG_DESCRIPTION, std::addressof(info), config.name);
+        }
+        if (0 != (fields & config_start_type)) {
+            SERVICE_DELAYED_AUTO_START_INFO info;
+            info.fDelayedAutostart = config.delayed_auto_start && start_type_auto == config.start_type;
+            apply_config2(service, SERVICE_CONFIG_DELAYED_AUTO_START_INFO, std::addressof(info), config.name);
+        }
+        if (0 != (fields & config_failure_actions)) {
+            auto wcommand = sl::utils::widen(config.failure_actions.command);
+            auto actions = std::vector<SC_ACTION>();
+            for (auto& act : config.failure_actions.actions) {
+                SC_ACTION sa;
+                sa.Type = static_cast<SC_ACTION_TYPE>(act.type);
+                sa.Delay = act.delay_millis;
+                actions.push_back(sa);
+            }
+            SERVICE_FAILURE_ACTIONSW info;
+            info.dwResetPeriod = config.failure_actions.reset_period_secs;
+            info.lpRebootMsg = nullptr;
+            info.lpCommand = const_cast<LPWSTR>(wcommand.c_str());
+            info.cActions = static_cast<DWORD>(actions.size());
+            info.lpsaActions = actions.empty() ? nullptr : actions.data();
+            apply_config2(service, SERVICE_CONFIG_FAILURE_ACTIONS, std::addressof(info), config.name);
+        }
+        if (0 != (fields & config_preshutdown_timeout)) {
+            SERVICE_PRESHUTDOWN_INFO info;
+            info.dwPreshutdownTimeout = config.preshutdown_timeout_millis;
+            apply_config2(service, SERVICE_CONFIG_PRESHUTDOWN_INFO, std::addressof(info), config.name);
+        }
+        if (0 != (fields & config_triggers)) {
+            apply_triggers(service, config);
+        }
+    }
+
+    // native structures point into the buffers kept alive until the call returns
+    void apply_triggers(SC_HANDLE service, const service_config& config) {
+        auto guids = std::vector<GUID>();
+        auto wdata = std::vector<std::vector<std::wstring>>();
+        for (auto& tr : config.triggers) {
+            guid_parts parts;
+            if (!parse_guid_string(tr.subtype, parts)) throw winservice_exception(TRACEMSG(
+                    "Invalid trigger subtype GUID, name: [" + config.name + "]," +
+                    " subtype: [" + tr.subtype + "]"));
+            guids.push_back(guid_to_native(parts));
+            auto items = std::vector<std::wstring>();
+            for (auto& da : tr.data) {
+                items.push_back(sl::utils::widen(da));
+            }
+            wdata.push_back(std::move(items));
+        }
+        auto data_items = std::vector<std::vector<SERVICE_TRIGGER_SPECIFIC_DATA_ITEM>>();
+        for (auto& items : wdata) {
+            auto native = std::vector<SERVICE_TRIGGER_SPECIFIC_DATA_ITEM>();
+            for (auto& it : items) {
+                SERVICE_TRIGGER_SPECIFIC_DATA_ITEM di;
+                di.dwDataType = SERVICE_TRIGGER_DATA_TYPE_STRING;
+                di.cbData = static_cast<DWORD>((it.length() + 1) * sizeof(wchar_t));
+                di.pData = reinterpret_cast<PBYTE>(const_cast<wchar_t*>(it.c_str()));
+                native.push_back(di);
+            }
+            data_items.push_back(std::move(native));
+        }
+        auto triggers = std::vector<SERVICE_TRIGGER>();
+        for (size_t i = 0; i < config.triggers.size(); i++) {
+            SERVICE_TRIGGER st;
+            st.dwTriggerType = config.triggers[i].type;
+            st.dwAction = config.triggers[i].action;
+            st.pTriggerSubtype = std::addressof(guids[i]);
+            st.cDataItems = static_cast<DWORD>(data_items[i].size());
+            st.pDataItems = data_items[i].empty() ? nullptr : data_items[i].data();
+            triggers.push_back(st);
+        }
+        // empty list removes all the triggers
+        SERVICE_TRIGGER_INFO info;
+        info.cTriggers = static_cast<DWORD>(triggers.size());
+        info.pTriggers = triggers.empty() ? nullptr : triggers.data();
+        info.pReserved = nullptr;
+        apply_config2(service, SERVICE_CONFIG_TRIGGER_INFO, std::addressof(info), config.name);
+    }
+
+    void apply_config2(SC_HANDLE service, DWORD level, LPVOID info, const std::string& service_name) {
+        auto success = ChangeServiceConfig2W(service, level, info);
+        if (!success) throw winservice_exception(TRACEMSG(
+                "Error changing service config, name: [" + service_name + "]," +
+                " level: [" + sl::support::to_string(level) + "]," +
+                " error: [" + sl::utils::errcode_to_string(GetLastError()) + "]"));
+    }
+
+    service_status query_status(SC_HANDLE service, const std::string& service_name) {
+        SERVICE_STATUS_PROCESS ssp;
+        DWORD len;
+        auto success = QueryServiceStatusEx(service, SC_STATUS_PROCESS_INFO,
+                reinterpret_cast<BYTE*> (std::addressof(ssp)), sizeof(SERVICE_STATUS_PROCESS), std::addressof(len));
+        if (!success) throw winservice_exception(TRACEMSG(
+                "Error querying service status, name: [" + service_name + "]," +
+                " error: [" + sl::utils::errcode_to_string(GetLastError()) + "]"));
+        return from_native(ssp);
+    }
+
+    // must be called under lock
+    SC_HANDLE manager(DWORD access) {
+        if (nullptr == scm.get() || access != (scm_access & access)) {
+            scm_access |= access;
+            scm = service_handle(OpenSCManagerW(NULL, NULL, scm_access), service_handle_deleter());
+            if (nullptr == scm.get()) throw winservice_exception(TRACEMSG(
+                    "Cannot open SCM, error: [" + sl::utils::errcode_to_string(GetLastError()) + "]"));
+        }
+        return scm.get();
+    }
+
+    // cached handle is reopened when more access rights are required
+    std::shared_ptr<SC_HANDLE__> open_service(const std::string& service_name, DWORD access) {
+        std::lock_guard<std::mutex> guard{mutex};
+        auto it = services.find(service_name);
+        DWORD cached_access = 0;
+        if (services.end() != it) {
+            if (access == (it->second.second & access)) {
+                return it->second.first;
+            }
+            cached_access = it->second.second;
+        }
+        auto required = cached_access | access;
+        auto ha = OpenServiceW(manager(SC_MANAGER_CONNECT), sl::utils::widen(service_name).c_str(), required);
+        if (nullptr == ha) throw winservice_exception(TRACEMSG(
+                "Cannot open service, name: [" + service_name + "]," +
+                " error: [" + sl::utils::errcode_to_string(GetLastError()) + "]"));
+        auto service = std::shared_ptr<SC_HANDLE__>(ha, service_handle_deleter());
+        services[service_name] = std::make_pair(service, required);
+        return service;
+    }
+
+    // handle may become stale if service is deleted and created again
+    void drop_service(const std::string& service_name) {
+        std::lock_guard<std::mutex> guard{mutex};
+        services.erase(service_name);
+    }
+
+    DWORD control_access(uint32_t control) {
+        switch (control) {
+        case SERVICE_CONTROL_STOP: return SERVICE_STOP;
+        case SERVICE_CONTROL_PAUSE: return SERVICE_PAUSE_CONTINUE;
+        case SERVICE_CONTROL_CONTINUE: return SERVICE_PAUSE_CONTINUE;
+        case SERVICE_CONTROL_PARAMCHANGE: return SERVICE_PAUSE_CONTINUE;
+        case SERVICE_CONTROL_INTERROGATE: return SERVICE_INTERROGATE;
+        default: return SERVICE_USER_DEFINED_CONTROL;
+        }
+    }
+};
+
+} // namespace
+
+std::unique_ptr<scm_connection> windows_scm::connect() {
+    return std::unique_ptr<scm_connection>(new windows_connection());
+}
+
+void windows_scm::run_dispatcher(const std::vector<std::string>& service_names,
+        std::function<void(const std::string&)> service_main) {
+    {
+        std::lock_guard<std::mutex> guard{static_mutex()};
+        static_service_main() = std::move(service_main);
+    }
+    auto wnames = std::vector<std::wstring>();
+    for (auto& name : service_names) {
+        wnames.emplace_back(sl::utils::widen(name));
+    }
+    auto table = std::vector<SERVICE_TABLE_ENTRYW>();
+    for (auto& wname : wnames) {
+        SERVICE_TABLE_ENTRYW en = { std::addressof(wname.front()), service_main_trampoline };
+        table.push_back(en);
+    }
+    SERVICE_TABLE_ENTRYW terminator = { nullptr, nullptr };
+    table.push_back(terminator);
+
+    // Connects the main thread of a service process to the service control
+    // manager, which causes the thread to be the service control dispatcher
+    // thread for the calling process. This call returns when the service has
+    // stopped. The process should simply terminate when the call returns.
+    auto success = StartServiceCtrlDispatcherW(table.data());
+    if (!success) throw winservice_exception(TRACEMSG(
+            "Error starting service, name: [" + (service_names.empty() ? std::string() : service_names.front()) + "]," +
+            " error: [" + sl::utils::errcode_to_string(GetLastError()) + "]"));
+}
+
+void windows_scm::register_control_handler(const std::string& service_name,
+        std::function<bool(uint32_t, uint32_t, uint32_t)> handler) {
+    std::lock_guard<std::mutex> guard{static_mutex()};
+    auto& handlers = static_control_handlers();
+    auto it = handlers.find(service_name);
+    if (handlers.end() == it) {
+        auto ptr = std::unique_ptr<handler_fun>(new handler_fun());
+        it = handlers.insert(std::make_pair(service_name, std::move(ptr))).first;
+    }
+    // service is stopped if it is being registered again
+    *it->second = std::move(handler);
+    auto ha = RegisterServiceCtrlHandlerExW(sl::utils::widen(service_name).c_str(),
+            control_handler_trampoline, static_cast<LPVOID>(it->second.get()));
+    if (nullptr == ha) throw winservice_exception(TRACEMSG(
+            "Fatal error on RegisterServiceCtrlHandlerExW: [" + sl::utils::errcode_to_string(GetLastError()) + "]"));
+    static_status_handles()[service_name] = ha;
+}
+
+void windows_scm::set_service_status(const std::string& service_name, const service_status& status) {
+    SERVICE_STATUS_HANDLE ha = nullptr;
+    {
+        std::lock_guard<std::mutex> guard{static_mutex()};
+        auto it = static_status_handles().find(service_name);
+        if (static_status_handles().end() != it) {
+            ha = it->second;
+        }
+    }
+    if (nullptr == ha) throw winservice_exception(TRACEMSG(
+            "Error changing status to: [" + sl::support::to_string(status.current_state) + "]," +
+            " control handler is not registered, name: [" + service_name + "]"));
+    SERVICE_STATUS st;
+    st.dwServiceType = status.service_type;
+    st.dwCurrentState = status.current_state;
+    st.dwControlsAccepted = status.controls_accepted;
+    st.dwWin32ExitCode = status.win32_exit_code;
+    st.dwServiceSpecificExitCode = status.service_specific_exit_code;
+    st.dwCheckPoint = status.check_point;
+    st.dwWaitHint = status.wait_hint;
+    auto success = SetServiceStatus(ha, std::addressof(st));
+    if (!success) throw winservice_exception(TRACEMSG(
+            "Error changing status to: [" + sl::support::to_string(status.current_state) + "]," +
+            " error: [" + sl::utils::errcode_to_string(GetLastError()) + "]"));
+}
+
+} // namespace
+}
+
+#endif // STATICLIB_WINDOWS
@@ -0,0 +1,140 @@
+/*
+ * Copyright 2026, alex at staticlibs.net
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * File:   component_graph_test.cpp
+ * Author: alex
+ *
+ * Created on October 17, 2026, 4:50 PM
+ */
+
+#include "staticlib/winservice.hpp"
+
+#include <chrono>
+#include <iostream>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "staticlib/config/assert.hpp"
+
+namespace sw = sl::winservice;
+
+class event_log {
+    std::mutex mutex;
+    std::vector<std::string> events;
+
+public:
+    void add(const std::string& ev) {
+        std::lock_guard<std::mutex> guard{mutex};
+        events.push_back(ev);
+    }
+
+    size_t index_of(const std::string& ev) {
+        std::lock_guard<std::mutex> guard{mutex};
+        for (size_t i = 0; i < events.size(); i++) {
+            if (ev == events[i]) return i;
+        }
+        throw std::runtime_error("Event not found: [" + ev + "]");
+    }
+
+    size_t size() {
+        std::lock_guard<std::mutex> guard{mutex};
+        return events.size();
+    }
+};
+
+std::function<void()> step(event_log& log, const std::string& ev, int millis) {
+    return [&log, ev, millis] {
+        std::this_thread::sleep_for(std::chrono::milliseconds(millis));
+        log.add(ev);
+    };
+}
+
+void test_order() {
+    event_log log;
+    sw::component_graph graph{4};
+    graph.add_component("db", {}, step(log, "db_start", 100), step(log, "db_stop", 100));
+    graph.add_component("cache", {}, step(log, "cache_start", 100), step(log, "cache_stop", 100));
+    graph.add_component("http", {"db", "cache"}, step(log, "http_start", 10), step(log, "http_stop", 10));
+    auto begin = std::chrono::steady_clock::now();
+    double last_progress = 0;
+    graph.start([](const std::string&) {}, [&last_progress](double fr) { last_progress = fr; });
+    auto elapsed = std::chrono::steady_clock::now() - begin;
+    // independent components are started concurrently
+    slassert(elapsed < std::chrono::milliseconds(190));
+    slassert(1.0 == last_progress);
+    slassert(log.index_of("db_start") < log.index_of("http_start"));
+    slassert(log.index_of("cache_start") < log.index_of("http_start"));
+
+    graph.stop([](const std::string&) {});
+    slassert(log.index_of("http_stop") < log.index_of("db_stop"));
+    slassert(log.index_of("http_stop") < log.index_of("cache_stop"));
+}
+
+void test_invalid_graph() {
+    sw::component_graph graph;
+    graph.add_component("a", {"b"}, nullptr, nullptr);
+    graph.add_component("b", {"a"}, nullptr, nullptr);
+    bool thrown = false;
+    try {
+        graph.start(nullptr);
+    } catch (const sw::winservice_exception&) {
+        thrown = true;
+    }
+    slassert(thrown);
+
+    sw::component_graph unknown;
+    unknown.add_component("a", {"c"}, nullptr, nullptr);
+    thrown = false;
+    try {
+        unknown.start(nullptr);
+    } catch (const sw::winservice_exception&) {
+        thrown = true;
+    }
+    slassert(thrown);
+}
+
+void test_rollback() {
+    event_log log;
+    sw::component_graph graph{2};
+    graph.add_component("db", {}, step(log, "db_start", 0), step(log, "db_stop", 0));
+    graph.add_component("http", {"db"}, [] { throw std::runtime_error("fail"); }, step(log, "http_stop", 0));
+    bool thrown = false;
+    try {
+        graph.start(nullptr);
+    } catch (const sw::winservice_exception&) {
+        thrown = true;
+    }
+    slassert(thrown);
+    // started component is stopped, failed one is not
+    slassert(2 == log.size());
+    slassert(log.index_of("db_start") < log.index_of("db_stop"));
+}
+
+int main() {
+    try {
+        test_order();
+        test_invalid_graph();
+        test_rollback();
+    } catch (const std::exception& e) {
+        std::cout << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
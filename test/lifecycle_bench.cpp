@@ -0,0 +1,168 @@
+/*
+ * Copyright 2026, alex at staticlibs.net
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * File:   lifecycle_bench.cpp
+ * Author: alex
+ *
+ * Created on October 17, 2026, 3:40 PM
+ */
+
+// Lifecycle benchmark against the simulated SCM, results are printed
+// as JSON lines (one object per benchmark) for trend tracking:
+//
+// lifecycle_bench [iterations] > results.jsonl
+
+#include "staticlib/winservice.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "staticlib/support.hpp"
+
+namespace sw = sl::winservice;
+
+const uint32_t timeout = 10000;
+
+class stopwatch {
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+public:
+    uint64_t elapsed_micros() const {
+        auto diff = std::chrono::steady_clock::now() - start;
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(diff).count());
+    }
+};
+
+uint64_t percentile(const std::vector<uint64_t>& sorted, double fraction) {
+    if (sorted.empty()) return 0;
+    auto idx = static_cast<size_t>(fraction * static_cast<double>(sorted.size() - 1));
+    return sorted[idx];
+}
+
+void report_latency(const std::string& name, std::vector<uint64_t> samples) {
+    std::sort(samples.begin(), samples.end());
+    uint64_t sum = 0;
+    for (auto sa : samples) {
+        sum += sa;
+    }
+    auto mean = samples.empty() ? 0 : sum / samples.size();
+    std::cout << "{\"benchmark\":\"" << name << "\",\"unit\":\"us\"" <<
+            ",\"count\":" << samples.size() <<
+            ",\"mean\":" << mean <<
+            ",\"p50\":" << percentile(samples, 0.5) <<
+            ",\"p90\":" << percentile(samples, 0.9) <<
+            ",\"p99\":" << percentile(samples, 0.99) <<
+            ",\"max\":" << (samples.empty() ? 0 : samples.back()) << "}" << std::endl;
+}
+
+void report_throughput(const std::string& name, uint32_t ops, uint64_t micros) {
+    auto per_sec = 0 == micros ? 0 : static_cast<uint64_t>(ops * 1000000.0 / static_cast<double>(micros));
+    std::cout << "{\"benchmark\":\"" << name << "\",\"unit\":\"ops/s\"" <<
+            ",\"count\":" << ops <<
+            ",\"total_us\":" << micros <<
+            ",\"value\":" << per_sec << "}" << std::endl;
+}
+
+void bench_control_handler(sw::simulated_scm& scm, uint32_t iterations) {
+    sw::install_service("bench", "bench_test");
+    sw::start_service("bench");
+    auto bus = std::make_shared<sw::service_event_bus>();
+    bus->on_param_change([](const sw::service_event&) {});
+    auto th = std::thread([bus] {
+        sw::service_lifecycle lc;
+        lc.starter = [](sw::service_transition&) {};
+        lc.event_bus = bus;
+        sw::start_service_and_wait("bench", std::move(lc));
+    });
+    scm.wait_for_state("bench", sw::state_running, timeout);
+    auto controls = std::vector<uint32_t>{sw::control_interrogate, sw::control_paramchange};
+    for (auto control : controls) {
+        auto samples = std::vector<uint64_t>();
+        samples.reserve(iterations);
+        for (uint32_t i = 0; i < iterations; i++) {
+            stopwatch watch;
+            scm.send_control("bench", control);
+            samples.push_back(watch.elapsed_micros());
+        }
+        report_latency("control_handler_" + std::string(sw::control_paramchange == control ?
+                "paramchange" : "interrogate"), std::move(samples));
+    }
+    sw::stop_service("bench");
+    th.join();
+    sw::uninstall_service("bench");
+}
+
+void bench_start_stop(sw::simulated_scm& scm, uint32_t iterations) {
+    sw::install_service("bench", "bench_test");
+    auto start_samples = std::vector<uint64_t>();
+    auto stop_samples = std::vector<uint64_t>();
+    for (uint32_t i = 0; i < iterations; i++) {
+        stopwatch start_sw;
+        sw::start_service("bench");
+        auto th = std::thread([] {
+            sw::service_lifecycle lc;
+            lc.starter = [](sw::service_transition&) {};
+            lc.stopper = [](sw::service_transition&) {};
+            sw::start_service_and_wait("bench", std::move(lc));
+        });
+        scm.wait_for_state("bench", sw::state_running, timeout);
+        start_samples.push_back(start_sw.elapsed_micros());
+        stopwatch stop_sw;
+        sw::stop_service("bench");
+        scm.wait_for_state("bench", sw::state_stopped, timeout);
+        stop_samples.push_back(stop_sw.elapsed_micros());
+        th.join();
+    }
+    report_latency("start_round_trip", std::move(start_samples));
+    report_latency("stop_round_trip", std::move(stop_samples));
+    sw::uninstall_service("bench");
+}
+
+void bench_install_uninstall(uint32_t iterations) {
+    sw::scm_session session;
+    stopwatch watch;
+    for (uint32_t i = 0; i < iterations; i++) {
+        auto name = "bench_" + sl::support::to_string(i);
+        sw::service_config conf;
+        conf.name = name;
+        conf.display_name = name;
+        conf.binary_path = "bench_test";
+        session.install_service(conf);
+        session.uninstall_service(name);
+    }
+    report_throughput("install_uninstall", iterations, watch.elapsed_micros());
+}
+
+int main(int argc, char* argv[]) {
+    uint32_t iterations = argc > 1 ? static_cast<uint32_t>(std::strtoul(argv[1], nullptr, 10)) : 1000;
+    try {
+        auto scm = std::make_shared<sw::simulated_scm>();
+        sw::set_scm_backend(scm);
+        bench_control_handler(*scm, iterations);
+        bench_start_stop(*scm, iterations / 10 + 1);
+        bench_install_uninstall(iterations);
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,154 @@
+/*
+ * Copyright 2026, alex at staticlibs.net
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * File:   lifecycle_events_test.cpp
+ * Author: alex
+ *
+ * Created on October 17, 2026, 4:25 PM
+ */
+
+#include "staticlib/winservice.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "staticlib/config/assert.hpp"
+#include "staticlib/support.hpp"
+
+namespace sw = sl::winservice;
+
+void test_channel() {
+    std::atomic<uint64_t> delivered{0};
+    std::atomic<uint64_t> sum{0};
+    sw::lifecycle_event_channel channel([&](const sw::lifecycle_event& ev) {
+        delivered += 1;
+        sum += ev.error_code;
+    }, 64);
+    auto threads = std::vector<std::thread>();
+    for (uint32_t t = 0; t < 4; t++) {
+        threads.emplace_back([&channel] {
+            for (uint32_t i = 0; i < 1000; i++) {
+                channel.publish(sw::make_lifecycle_event(sw::event_start_failed, sw::severity_error,
+                        "foo", sw::state_start_pending, sw::state_running, 1, "fail"));
+            }
+        });
+    }
+    for (auto& th : threads) {
+        th.join();
+    }
+    channel.close();
+    // every published event is either delivered or counted as dropped
+    slassert(4000 == delivered + channel.dropped_count());
+    slassert(sum == delivered);
+    slassert(!channel.publish(sw::lifecycle_event()));
+}
+
+void test_idle_consumer() {
+    std::atomic<uint32_t> delivered{0};
+    sw::lifecycle_event_channel channel([&delivered](const sw::lifecycle_event&) {
+        delivered += 1;
+    });
+    for (uint32_t i = 1; i <= 3; i++) {
+        // consumer is blocked on the condition variable
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        channel.publish(sw::make_lifecycle_event(sw::event_checkpoint_failed, sw::severity_warning,
+                "foo", 0, 0, 0, nullptr));
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+        while (i != delivered.load() && std::chrono::steady_clock::now() < deadline) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        slassert(i == delivered.load());
+    }
+}
+
+void test_truncation() {
+    auto long_name = std::string(100, 'a');
+    auto ev = sw::make_lifecycle_event(sw::event_stop_failed, sw::severity_error, long_name,
+            sw::state_stop_pending, sw::state_stopped, 2, nullptr);
+    slassert(63 == std::string(ev.service_name).length());
+    slassert('\0' == ev.message[0]);
+    slassert(ev.timestamp_millis > 0);
+    auto msg = sw::format_lifecycle_event(ev);
+    slassert(std::string::npos != msg.find("Error stopping service"));
+    slassert(std::string::npos != msg.find("STOP_PENDING"));
+}
+
+void test_lifecycle_events() {
+    auto scm = std::make_shared<sw::simulated_scm>();
+    sw::set_scm_backend(scm);
+    sw::install_service("foo", "foo_test");
+    sw::start_service("foo");
+    std::mutex mutex;
+    std::vector<sw::lifecycle_event> events;
+    sw::service_lifecycle lc;
+    lc.starter = [](sw::service_transition&) {
+        throw std::runtime_error("starter failed");
+    };
+    lc.events = std::make_shared<sw::lifecycle_event_channel>([&](const sw::lifecycle_event& ev) {
+        std::lock_guard<std::mutex> guard{mutex};
+        events.push_back(ev);
+    });
+    sw::start_service_and_wait("foo", lc);
+    lc.events->close();
+    // failure followed by resource accounting
+    slassert(2 == events.size());
+    slassert(sw::event_start_failed == events[0].event_id);
+    slassert(sw::state_start_pending == events[0].pending_state);
+    slassert(1 == events[0].error_code);
+    slassert(std::string("starter failed") == events[0].message);
+    slassert(sw::event_transition_completed == events[1].event_id);
+    slassert(sw::severity_info == events[1].severity);
+    slassert(std::string::npos != std::string(events[1].message).find("open handles: ["));
+
+    // string logger adapter, messages are delivered before the return
+    std::vector<std::string> messages;
+    sw::start_service("foo");
+    sw::start_service_and_wait("foo", [] { throw std::runtime_error("fail"); }, [] {},
+            [&messages](const std::string& msg) { messages.push_back(msg); });
+    slassert(2 == messages.size());
+    slassert(std::string::npos != messages[0].find("Error starting service, name: [foo]"));
+    slassert(std::string::npos != messages[1].find("Service transition completed, name: [foo]"));
+
+    // long messages are truncated, publishing does not allocate
+    messages.clear();
+    auto long_msg = std::string(1000, 'x');
+    sw::start_service("foo");
+    sw::start_service_and_wait("foo", [&long_msg] { throw sw::winservice_exception(TRACEMSG(long_msg)); }, [] {},
+            [&messages](const std::string& msg) { messages.push_back(msg); });
+    slassert(2 == messages.size());
+    slassert(0 == messages[0].find(std::string(255, 'x') + "\nError starting service, name: [foo]"));
+    sw::uninstall_service("foo");
+}
+
+int main() {
+    try {
+        test_channel();
+        test_truncation();
+        test_idle_consumer();
+        test_lifecycle_events();
+    } catch (const std::exception& e) {
+        std::cout << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,171 @@
+/*
+ * Copyright 2026, alex at staticlibs.net
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * File:   lifecycle_stress_test.cpp
+ * Author: alex
+ *
+ * Created on October 17, 2026, 2:10 PM
+ */
+
+#include "staticlib/winservice.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <future>
+#include <iostream>
+#include <map>
+#include <random>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "staticlib/config/assert.hpp"
+#include "staticlib/support.hpp"
+
+namespace sw = sl::winservice;
+
+// service must stop within this time after the storm, otherwise it is considered deadlocked
+const uint32_t timeout = 10000;
+
+// storm size can be increased for the longer runs, e.g. WINSERVICE_STRESS_ITERATIONS=10000
+uint32_t env_or_default(const char* name, uint32_t def) {
+    auto val = std::getenv(name);
+    if (nullptr == val) return def;
+    return static_cast<uint32_t>(std::strtoul(val, nullptr, 10));
+}
+
+void sleep_millis(int millis) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(millis));
+}
+
+std::string describe(const std::vector<sw::service_status>& history) {
+    auto res = std::string();
+    for (auto& st : history) {
+        res += sw::state_to_string(st.current_state) + " ";
+    }
+    return res;
+}
+
+// lost or reordered transitions show up as the invalid state sequence
+void check_history(const std::vector<sw::service_status>& history) {
+    static const std::map<uint32_t, std::set<uint32_t>> allowed = {
+        {sw::state_stopped, {sw::state_start_pending}},
+        {sw::state_start_pending, {sw::state_start_pending, sw::state_running, sw::state_stopped}},
+        {sw::state_running, {sw::state_running, sw::state_stop_pending, sw::state_pause_pending}},
+        {sw::state_pause_pending, {sw::state_pause_pending, sw::state_paused, sw::state_stopped}},
+        {sw::state_paused, {sw::state_paused, sw::state_continue_pending, sw::state_stop_pending}},
+        {sw::state_continue_pending, {sw::state_continue_pending, sw::state_running, sw::state_stopped}},
+        {sw::state_stop_pending, {sw::state_stop_pending, sw::state_stopped}}
+    };
+    slassert(!history.empty());
+    for (size_t i = 1; i < history.size(); i++) {
+        auto& next = allowed.at(history[i - 1].current_state);
+        if (0 == next.count(history[i].current_state)) {
+            throw std::runtime_error("Invalid transition, history: [" + describe(history) + "]");
+        }
+    }
+    slassert(sw::state_stopped == history.back().current_state);
+}
+
+void run_storm(sw::simulated_scm& scm, std::mt19937& rng) {
+    static const uint32_t controls[] = {
+        sw::control_stop, sw::control_pause, sw::control_continue, sw::control_shutdown
+    };
+    const std::string name = "storm";
+    sw::install_service(name, "storm_test");
+    sw::start_service(name);
+    std::atomic<int> in_callback{0};
+    std::atomic<bool> overlapped{false};
+    auto starter_millis = std::uniform_int_distribution<int>(0, 30)(rng);
+    auto callback = [&](sw::service_transition& tr, int millis) {
+        if (0 != in_callback.fetch_add(1)) {
+            overlapped = true;
+        }
+        // slow callback, returns early if superseded by the stop
+        tr.cancellation().wait_for(static_cast<uint32_t>(millis));
+        in_callback -= 1;
+    };
+    auto service = std::async(std::launch::async, [&] {
+        sw::service_lifecycle lc;
+        lc.starter = [&](sw::service_transition& tr) { callback(tr, starter_millis); };
+        lc.stopper = [&](sw::service_transition& tr) { callback(tr, starter_millis / 3); };
+        lc.heartbeat_interval_millis = 5;
+        sw::start_service_and_wait(name, std::move(lc));
+    });
+    // wait for the handler to be registered
+    while (scm.status_history(name).size() < 2) {
+        sleep_millis(1);
+    }
+    auto senders = std::vector<std::thread>();
+    for (int i = 0; i < 3; i++) {
+        auto seed = rng();
+        senders.emplace_back([&scm, &name, seed] {
+            auto local = std::mt19937(seed);
+            for (int j = 0; j < 8; j++) {
+                auto control = controls[std::uniform_int_distribution<int>(0, 3)(local)];
+                try {
+                    scm.send_control(name, control);
+                } catch (const sw::winservice_exception&) {
+                    // service already stopped
+                }
+                sleep_millis(std::uniform_int_distribution<int>(0, 5)(local));
+            }
+        });
+    }
+    for (auto& th : senders) {
+        th.join();
+    }
+    try {
+        scm.send_control(name, sw::control_stop);
+    } catch (const sw::winservice_exception&) {
+        // service already stopped
+    }
+    if (std::future_status::ready != service.wait_for(std::chrono::milliseconds(timeout))) {
+        std::cout << "Deadlock detected, history: [" << describe(scm.status_history(name)) << "]" << std::endl;
+        // hung threads cannot be joined
+        std::_Exit(1);
+    }
+    service.get();
+    slassert(!overlapped);
+    check_history(scm.status_history(name));
+    sw::uninstall_service(name);
+}
+
+void test_control_storm() {
+    auto iterations = env_or_default("WINSERVICE_STRESS_ITERATIONS", 30);
+    auto seed = env_or_default("WINSERVICE_STRESS_SEED", std::random_device()());
+    std::cout << "Control storm, iterations: [" << iterations << "], seed: [" << seed << "]" << std::endl;
+    auto rng = std::mt19937(seed);
+    auto scm = std::make_shared<sw::simulated_scm>();
+    sw::set_scm_backend(scm);
+    for (uint32_t i = 0; i < iterations; i++) {
+        run_storm(*scm, rng);
+    }
+}
+
+int main() {
+    try {
+        test_control_storm();
+    } catch (const std::exception& e) {
+        std::cout << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,760 @@
+/*
+ * Copyright 2026, alex at staticlibs.net
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * File:   lifecycle_test.cpp
+ * Author: alex
+ *
+ * Created on October 17, 2026, 1:40 PM
+ */
+
+#include "staticlib/winservice.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <deque>
+#include <functional>
+#include <iostream>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "staticlib/config/assert.hpp"
+
+namespace sw = sl::winservice;
+
+const uint32_t timeout = 10000;
+
+void sleep_millis(int millis) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(millis));
+}
+
+long long elapsed_millis(std::chrono::steady_clock::time_point start) {
+    auto diff = std::chrono::steady_clock::now() - start;
+    return std::chrono::duration_cast<std::chrono::milliseconds>(diff).count();
+}
+
+void test_shutdown_during_start() {
+    auto scm = std::make_shared<sw::simulated_scm>();
+    sw::set_scm_backend(scm);
+    sw::install_service("foo", "foo_test");
+    sw::start_service("foo");
+    std::atomic<int> stopped{0};
+    auto th = std::thread([&] {
+        sw::start_service_and_wait("foo",
+                [] { sleep_millis(500); },
+                [&] { stopped += 1; },
+                [](const std::string& msg) { std::cout << msg << std::endl; });
+    });
+    // wait for the handler to be registered
+    while (scm->status_history("foo").size() < 2) {
+        sleep_millis(1);
+    }
+    auto start = std::chrono::steady_clock::now();
+    scm->send_control("foo", sw::control_shutdown);
+    // handler must not wait for the starter
+    slassert(elapsed_millis(start) < 250);
+    th.join();
+    slassert(1 == stopped);
+    sw::uninstall_service("foo");
+}
+
+void test_coalescing() {
+    auto scm = std::make_shared<sw::simulated_scm>();
+    sw::set_scm_backend(scm);
+    sw::install_service("foo", "foo_test");
+    sw::start_service("foo");
+    std::atomic<int> started{0};
+    std::atomic<int> stopped{0};
+    auto th = std::thread([&] {
+        sw::start_service_and_wait("foo",
+                [&] { started += 1; },
+                [&] { stopped += 1; sleep_millis(200); },
+                [](const std::string& msg) { std::cout << msg << std::endl; });
+    });
+    scm->wait_for_state("foo", sw::state_running, timeout);
+    auto conn = scm->connect();
+    conn->control_service("foo", sw::control_pause);
+    scm->wait_for_state("foo", sw::state_pause_pending, timeout);
+    // enqueued while the first pause is in progress
+    conn->control_service("foo", sw::control_continue);
+    conn->control_service("foo", sw::control_pause);
+    conn->control_service("foo", sw::control_continue);
+    conn->control_service("foo", sw::control_stop);
+    th.join();
+    // pause, then all the remaining controls collapsed into stop
+    slassert(1 == started);
+    slassert(2 == stopped);
+    sw::uninstall_service("foo");
+}
+
+void test_heartbeat() {
+    auto scm = std::make_shared<sw::simulated_scm>();
+    sw::set_scm_backend(scm);
+    sw::install_service("foo", "foo_test");
+    sw::start_service("foo");
+    auto th = std::thread([&] {
+        sw::service_lifecycle lc;
+        lc.starter = [](sw::service_transition& tr) {
+            slassert(sw::state_start_pending == tr.pending_state());
+            slassert(sw::state_running == tr.target_state());
+            sleep_millis(100);
+            tr.report_progress(0.5);
+            sleep_millis(100);
+        };
+        lc.wait_hint_millis = 5000;
+        lc.heartbeat_interval_millis = 10;
+        sw::start_service_and_wait("foo", std::move(lc));
+    });
+    scm->wait_for_state("foo", sw::state_running, timeout);
+    sw::stop_service("foo");
+    th.join();
+    auto hist = scm->status_history("foo");
+    uint32_t pending_count = 0;
+    uint32_t last_checkpoint = 0;
+    for (auto& st : hist) {
+        if (sw::state_start_pending == st.current_state && st.check_point > 0) {
+            slassert(st.check_point > last_checkpoint);
+            slassert(st.wait_hint >= 5000);
+            last_checkpoint = st.check_point;
+            pending_count += 1;
+        }
+    }
+    slassert(pending_count > 5);
+    sw::uninstall_service("foo");
+}
+
+void test_progress_hint() {
+    auto scm = std::make_shared<sw::simulated_scm>();
+    sw::set_scm_backend(scm);
+    sw::install_service("foo", "foo_test");
+    sw::start_service("foo");
+    auto th = std::thread([&] {
+        sw::service_lifecycle lc;
+        lc.starter = [](sw::service_transition& tr) {
+            sleep_millis(100);
+            // about 900 millis remaining
+            tr.report_progress(0.1);
+            sleep_millis(100);
+        };
+        lc.wait_hint_millis = 50;
+        lc.heartbeat_interval_millis = 10;
+        sw::start_service_and_wait("foo", std::move(lc));
+    });
+    scm->wait_for_state("foo", sw::state_running, timeout);
+    sw::stop_service("foo");
+    th.join();
+    auto hist = scm->status_history("foo");
+    bool progress_reported = false;
+    uint32_t extended_count = 0;
+    for (auto& st : hist) {
+        if (sw::state_start_pending == st.current_state && st.wait_hint > 500) {
+            progress_reported = true;
+        }
+        if (sw::state_start_pending == st.current_state && progress_reported) {
+            // heartbeat keeps the estimate
+            slassert(st.wait_hint > 500);
+            extended_count += 1;
+        }
+        if (sw::state_stop_pending == st.current_state) {
+            slassert(50 == st.wait_hint);
+        }
+    }
+    slassert(extended_count > 3);
+    sw::uninstall_service("foo");
+}
+
+void test_pause_resume() {
+    auto scm = std::make_shared<sw::simulated_scm>();
+    sw::set_scm_backend(scm);
+    sw::install_service("foo", "foo_test");
+    sw::start_service("foo");
+    std::atomic<int> started{0};
+    std::atomic<int> stopped{0};
+    std::atomic<int> paused{0};
+    std::atomic<int> resumed{0};
+    auto th = std::thread([&] {
+        sw::service_lifecycle lc;
+        lc.starter = [&](sw::service_transition&) { started += 1; };
+        lc.stopper = [&](sw::service_transition&) { stopped += 1; };
+        lc.pauser = [&](sw::service_transition&) { paused += 1; };
+        lc.resumer = [&](sw::service_transition&) { resumed += 1; };
+        sw::start_service_and_wait("foo", std::move(lc));
+    });
+    scm->wait_for_state("foo", sw::state_running, timeout);
+    auto conn = scm->connect();
+    conn->control_service("foo", sw::control_pause);
+    scm->wait_for_state("foo", sw::state_paused, timeout);
+    conn->control_service("foo", sw::control_continue);
+    scm->wait_for_state("foo", sw::state_running, timeout);
+    sw::stop_service("foo");
+    th.join();
+    slassert(1 == started);
+    slassert(1 == stopped);
+    slassert(1 == paused);
+    slassert(1 == resumed);
+    sw::uninstall_service("foo");
+}
+
+void test_shared_process() {
+    auto scm = std::make_shared<sw::simulated_scm>();
+    sw::set_scm_backend(scm);
+    sw::install_service("foo", "foo_test", "LocalSystem", "", "SERVICE_DEMAND_START", "",
+            "SERVICE_WIN32_SHARE_PROCESS");
+    sw::install_service("bar", "bar_test", "LocalSystem", "", "SERVICE_DEMAND_START", "",
+            "SERVICE_WIN32_SHARE_PROCESS");
+    sw::start_service("foo");
+    std::atomic<int> foo_started{0};
+    std::atomic<int> bar_started{0};
+    auto th = std::thread([&] {
+        auto services = std::vector<std::pair<std::string, sw::service_lifecycle>>();
+        sw::service_lifecycle foo;
+        foo.starter = [&](sw::service_transition&) { foo_started += 1; };
+        services.emplace_back("foo", std::move(foo));
+        sw::service_lifecycle bar;
+        bar.starter = [&](sw::service_transition&) { bar_started += 1; };
+        services.emplace_back("bar", std::move(bar));
+        sw::start_services_and_wait(std::move(services));
+    });
+    scm->wait_for_state("foo", sw::state_running, timeout);
+    sw::start_service("bar");
+    scm->wait_for_state("bar", sw::state_running, timeout);
+    slassert(sw::service_type_share_process == scm->connect()->query_service_status("bar").service_type);
+    sw::stop_service("foo");
+    scm->wait_for_state("foo", sw::state_stopped, timeout);
+    // stopped service can be started again while the process is running
+    sw::start_service("foo");
+    scm->wait_for_state("foo", sw::state_running, timeout);
+    sw::stop_service("foo");
+    scm->wait_for_state("foo", sw::state_stopped, timeout);
+    sw::stop_service("bar");
+    th.join();
+    slassert(2 == foo_started);
+    slassert(1 == bar_started);
+    sw::uninstall_service("foo");
+    sw::uninstall_service("bar");
+}
+
+void test_metrics() {
+    auto scm = std::make_shared<sw::simulated_scm>();
+    sw::set_scm_backend(scm);
+    sw::reset_service_metrics();
+    sw::install_service("metered", "metered_test");
+    sw::start_service("metered");
+    auto th = std::thread([&] {
+        sw::start_service_and_wait("metered",
+                [] { sleep_millis(30); },
+                [] { throw std::runtime_error("stop failed"); },
+                [](const std::string&) {});
+    });
+    scm->wait_for_state("metered", sw::state_running, timeout);
+    scm->send_control("metered", 200);
+    sw::stop_service("metered");
+    th.join();
+
+    auto me = sw::get_service_metrics("metered");
+    slassert("metered" == me.service_name);
+    slassert(1 == me.start.succeeded);
+    slassert(0 == me.start.failed);
+    slassert(1 == me.start.latency.count);
+    slassert(me.start.latency.max_millis >= 30);
+    slassert(me.start.latency.percentile_millis(0.5) >= 30);
+    slassert(me.start.latency.counts.size() == me.start.latency.bounds_millis.size() + 1);
+    slassert(1 == me.stop.failed);
+    slassert(0 == me.pause.latency.count);
+    slassert(2 == me.controls_received);
+    slassert(1 == me.controls_ignored);
+    // START_PENDING, RUNNING, STOP_PENDING, STOPPED
+    slassert(me.status_updates >= 4);
+    slassert(0 == me.status_update_failures);
+
+    sw::reset_service_metrics();
+    slassert(0 == sw::get_service_metrics("metered").start.succeeded);
+    slassert(0 == sw::get_service_metrics("unknown").controls_received);
+    sw::uninstall_service("metered");
+}
+
+void test_state_view() {
+    auto scm = std::make_shared<sw::simulated_scm>();
+    sw::set_scm_backend(scm);
+    sw::install_service("viewed", "viewed_test");
+    sw::service_state_view view{"viewed"};
+    slassert(view.is_stopping());
+    slassert(0 == view.snapshot().version);
+    std::vector<uint32_t> seen;
+    auto sub = view.subscribe([&seen](const sw::service_state_snapshot& snap) {
+        seen.push_back(snap.current_state);
+    });
+    sw::start_service("viewed");
+    auto th = std::thread([&] {
+        sw::start_service_and_wait("viewed", [] { sleep_millis(50); }, [] {}, [](const std::string&) {});
+    });
+    auto snap = view.wait_for_state(sw::state_running, timeout);
+    slassert(sw::state_running == snap.current_state);
+    slassert(view.is_running());
+    slassert(!view.is_stopping());
+    slassert(snap.transition_time_millis > 0);
+    slassert(snap.version > 0);
+    slassert(snap.version == view.wait_for_change(snap.version, 10).version);
+    // snapshot is published before the status is reported to SCM
+    scm->wait_for_state("viewed", sw::state_running, timeout);
+    sw::stop_service("viewed");
+    th.join();
+    slassert(view.is_stopping());
+    slassert(view.wait_for_change(snap.version, timeout).version > snap.version);
+    view.unsubscribe(sub);
+    // checkpoints are not reported to listeners
+    slassert(4 == seen.size());
+    slassert(sw::state_start_pending == seen[0]);
+    slassert(sw::state_running == seen[1]);
+    slassert(sw::state_stop_pending == seen[2]);
+    slassert(sw::state_stopped == seen[3]);
+    sw::uninstall_service("viewed");
+}
+
+void test_listener_outside_lock() {
+    auto scm = std::make_shared<sw::simulated_scm>();
+    sw::set_scm_backend(scm);
+    sw::install_service("viewed", "viewed_test");
+    sw::service_state_view view{"viewed"};
+    std::atomic<bool> heartbeat_seen{false};
+    auto sub = view.subscribe([&view, &heartbeat_seen](const sw::service_state_snapshot& snap) {
+        if (sw::state_start_pending != snap.current_state) return;
+        // heartbeat is not blocked while the listener runs
+        auto next = view.wait_for_change(snap.version, 5000);
+        heartbeat_seen.store(next.check_point > snap.check_point);
+    });
+    sw::start_service("viewed");
+    auto th = std::thread([&] {
+        sw::service_lifecycle lc;
+        lc.starter = [](sw::service_transition&) { };
+        lc.stopper = [](sw::service_transition&) { };
+        lc.heartbeat_interval_millis = 10;
+        sw::start_service_and_wait("viewed", std::move(lc));
+    });
+    scm->wait_for_state("viewed", sw::state_running, timeout);
+    sw::stop_service("viewed");
+    th.join();
+    view.unsubscribe(sub);
+    slassert(heartbeat_seen.load());
+    sw::uninstall_service("viewed");
+}
+
+void test_preshutdown_budget() {
+    auto scm = std::make_shared<sw::simulated_scm>();
+    sw::set_scm_backend(scm);
+    sw::service_config cfg;
+    cfg.name = "drained";
+    cfg.preshutdown_timeout_millis = 60000;
+    scm->connect()->install_service(cfg);
+    sw::start_service("drained");
+    std::atomic<uint32_t> start_reason{42};
+    std::atomic<uint32_t> stop_reason{0};
+    std::atomic<uint32_t> stop_remaining{0};
+    auto th = std::thread([&] {
+        sw::service_lifecycle lc;
+        lc.starter = [&](sw::service_transition& tr) { start_reason = tr.reason(); };
+        lc.stopper = [&](sw::service_transition& tr) {
+            stop_reason = tr.reason();
+            stop_remaining = tr.remaining_millis();
+        };
+        lc.preshutdown_timeout_millis = cfg.preshutdown_timeout_millis;
+        sw::start_service_and_wait("drained", std::move(lc));
+    });
+    auto st = scm->wait_for_state("drained", sw::state_running, timeout);
+    slassert(0 != (st.controls_accepted & sw::accept_preshutdown));
+    scm->send_control("drained", sw::control_preshutdown);
+    th.join();
+    slassert(0 == start_reason);
+    slassert(sw::control_preshutdown == stop_reason);
+    slassert(stop_remaining > 50000 && stop_remaining <= 60000);
+    sw::uninstall_service("drained");
+}
+
+void test_cancellation() {
+    auto scm = std::make_shared<sw::simulated_scm>();
+    sw::set_scm_backend(scm);
+    sw::install_service("cancelled", "cancelled_test");
+    sw::start_service("cancelled");
+    std::atomic<bool> start_cancelled{false};
+    std::atomic<bool> stop_cancelled{true};
+    auto th = std::thread([&] {
+        sw::service_lifecycle lc;
+        lc.starter = [&](sw::service_transition& tr) {
+            start_cancelled = tr.cancellation().wait_for(timeout);
+        };
+        lc.stopper = [&](sw::service_transition& tr) { stop_cancelled = tr.is_cancelled(); };
+        sw::start_service_and_wait("cancelled", std::move(lc));
+    });
+    scm->wait_for_state("cancelled", sw::state_start_pending, timeout);
+    // wait for the handler to be registered
+    while (scm->status_history("cancelled").size() < 2) {
+        sleep_millis(1);
+    }
+    auto start = std::chrono::steady_clock::now();
+    scm->send_control("cancelled", sw::control_stop);
+    th.join();
+    slassert(elapsed_millis(start) < timeout / 2);
+    slassert(start_cancelled);
+    slassert(!stop_cancelled);
+    sw::uninstall_service("cancelled");
+}
+
+void test_event_bus() {
+    auto scm = std::make_shared<sw::simulated_scm>();
+    sw::set_scm_backend(scm);
+    sw::install_service("bus", "bus_test");
+    sw::start_service("bus");
+    auto bus = std::make_shared<sw::service_event_bus>();
+    std::atomic<int> reloaded{0};
+    std::atomic<uint32_t> user_code{0};
+    std::atomic<uint32_t> session_id{0};
+    std::atomic<uint32_t> session_type{0};
+    std::atomic<bool> name_passed{false};
+    bus->on_param_change([&](const sw::service_event& ev) {
+        name_passed = "bus" == ev.service_name;
+        sleep_millis(200);
+        reloaded += 1;
+    });
+    bus->on_user_control([&](const sw::service_event& ev) { user_code = ev.control; });
+    bus->on_session_change([&](const sw::service_event& ev) {
+        session_type = ev.event_type;
+        session_id = ev.session_id;
+    });
+    std::atomic<int> started{0};
+    auto th = std::thread([&] {
+        sw::service_lifecycle lc;
+        lc.starter = [&](sw::service_transition&) { started += 1; };
+        lc.event_bus = bus;
+        sw::start_service_and_wait("bus", std::move(lc));
+    });
+    auto st = scm->wait_for_state("bus", sw::state_running, timeout);
+    slassert(0 != (st.controls_accepted & sw::accept_paramchange));
+    slassert(0 != (st.controls_accepted & sw::accept_session_change));
+    slassert(0 == (st.controls_accepted & sw::accept_power_event));
+    auto start = std::chrono::steady_clock::now();
+    scm->connect()->control_service("bus", sw::control_paramchange);
+    // subscriber runs off the dispatcher thread
+    slassert(elapsed_millis(start) < 150);
+    scm->connect()->control_service("bus", 150);
+    scm->send_control("bus", sw::control_session_change, sw::session_logon, 3);
+    scm->send_control("bus", sw::control_power_event, sw::power_suspend);
+    while (0 == reloaded || 0 == user_code || 0 == session_id) {
+        sleep_millis(1);
+    }
+    slassert(name_passed);
+    slassert(150 == user_code);
+    slassert(sw::session_logon == session_type);
+    slassert(3 == session_id);
+    sw::stop_service("bus");
+    th.join();
+    // reload does not restart the service
+    slassert(1 == started);
+    slassert(1 == reloaded);
+    slassert(1 == sw::get_service_metrics("bus").controls_ignored);
+    sw::uninstall_service("bus");
+}
+
+void test_supervisor_restart() {
+    auto scm = std::make_shared<sw::simulated_scm>();
+    sw::set_scm_backend(scm);
+    sw::install_service("supervised", "supervised_test");
+    sw::start_service("supervised");
+    auto sv = std::make_shared<sw::service_supervisor>("supervised", timeout, timeout, 42);
+    std::atomic<int> db_started{0};
+    std::atomic<int> cache_started{0};
+    std::atomic<int> cache_stopped{0};
+    sw::restart_policy policy;
+    policy.max_restarts = 1;
+    policy.initial_backoff_millis = 10;
+    sv->add_component("db", [&] { db_started += 1; }, [] {});
+    sv->add_component("cache", [&] { cache_started += 1; }, [&] { cache_stopped += 1; }, policy);
+    auto th = std::thread([&] {
+        sw::start_service_and_wait("supervised", sv->create_lifecycle(nullptr));
+    });
+    scm->wait_for_state("supervised", sw::state_running, timeout);
+    sv->report_failure("cache", "connection lost");
+    while (sv->restart_count("cache") < 1 || cache_started < 2) {
+        sleep_millis(1);
+    }
+    // component is restarted without the service restart
+    slassert(sw::state_running == scm->connect()->query_service_status("supervised").current_state);
+    slassert(1 == db_started);
+    slassert(1 == cache_stopped);
+    // restart policy is exhausted
+    sv->report_failure("cache", "connection lost again");
+    auto st = scm->wait_for_state("supervised", sw::state_stopped, timeout);
+    th.join();
+    slassert(sw::exit_code_service_specific == st.win32_exit_code);
+    slassert(42 == st.service_specific_exit_code);
+    slassert(2 == cache_stopped);
+    sw::uninstall_service("supervised");
+}
+
+void test_supervisor_hang() {
+    auto scm = std::make_shared<sw::simulated_scm>();
+    sw::set_scm_backend(scm);
+    sw::install_service("hung", "hung_test");
+    sw::start_service("hung");
+    auto sv = std::make_shared<sw::service_supervisor>("hung", 200, 0, 7);
+    sv->add_component("deadlocked", [] { sleep_millis(2000); }, [] {});
+    auto start = std::chrono::steady_clock::now();
+    auto th = std::thread([&] {
+        sw::start_service_and_wait("hung", sv->create_lifecycle(nullptr));
+    });
+    auto st = scm->wait_for_state("hung", sw::state_stopped, timeout);
+    th.join();
+    slassert(elapsed_millis(start) < 1500);
+    slassert(sw::exit_code_service_specific == st.win32_exit_code);
+    slassert(7 == st.service_specific_exit_code);
+    sw::uninstall_service("hung");
+}
+
+void test_trace() {
+    auto scm = std::make_shared<sw::simulated_scm>();
+    sw::set_scm_backend(scm);
+    sw::install_service("traced", "traced_test");
+    sw::start_service("traced");
+    sw::clear_trace();
+    sw::enable_tracing();
+    auto th = std::thread([&] {
+        sw::service_lifecycle lc;
+        lc.starter = [](sw::service_transition&) {
+            sw::trace_span span("load \"config\"");
+            sleep_millis(10);
+        };
+        sw::start_service_and_wait("traced", std::move(lc));
+    });
+    scm->wait_for_state("traced", sw::state_running, timeout);
+    sw::stop_service("traced");
+    th.join();
+    sw::enable_tracing(false);
+    {
+        sw::trace_span span("disabled");
+    }
+    auto json = sw::dump_trace_json();
+    slassert(0 == json.find("{\"traceEvents\":[{"));
+    slassert(std::string::npos != json.find("\"name\":\"service_main\""));
+    slassert(std::string::npos != json.find("\"name\":\"service_control_handler\""));
+    slassert(std::string::npos != json.find("\"name\":\"starter\",\"cat\":\"callback\",\"ph\":\"X\""));
+    slassert(std::string::npos != json.find("\"name\":\"stopper\""));
+    slassert(std::string::npos != json.find("\"name\":\"scm_set_service_status\""));
+    slassert(std::string::npos != json.find("\"name\":\"load \\\"config\\\"\",\"cat\":\"user\""));
+    slassert(std::string::npos == json.find("disabled"));
+    sw::clear_trace();
+    slassert("{\"traceEvents\":[],\"displayTimeUnit\":\"ms\"}" == sw::dump_trace_json());
+    sw::uninstall_service("traced");
+}
+
+void test_resource_accounting() {
+    auto before = sw::sample_resource_usage();
+    slassert(before.cpu_user_micros + before.cpu_system_micros > 0);
+    slassert(before.peak_resident_bytes > 0);
+    slassert(before.open_handles > 0);
+    auto scm = std::make_shared<sw::simulated_scm>();
+    sw::set_scm_backend(scm);
+    sw::reset_service_metrics();
+    sw::install_service("accounted", "accounted_test");
+    sw::start_service("accounted");
+    std::vector<std::FILE*> files;
+    std::mutex mutex;
+    std::vector<std::string> messages;
+    auto th = std::thread([&] {
+        sw::service_lifecycle lc;
+        lc.starter = [&](sw::service_transition&) {
+            // busy CPU and keep some files open
+            auto start = std::chrono::steady_clock::now();
+            while (elapsed_millis(start) < 50) { }
+            for (int i = 0; i < 3; i++) {
+                files.push_back(std::tmpfile());
+            }
+        };
+        lc.stopper = [&](sw::service_transition&) {
+            for (auto fi : files) {
+                std::fclose(fi);
+            }
+        };
+        lc.logger = [&](const std::string& msg) {
+            std::lock_guard<std::mutex> guard{mutex};
+            messages.push_back(msg);
+        };
+        sw::start_service_and_wait("accounted", std::move(lc));
+    });
+    scm->wait_for_state("accounted", sw::state_running, timeout);
+    sw::stop_service("accounted");
+    th.join();
+    auto me = sw::get_service_metrics("accounted");
+    slassert(me.start.last_resources.cpu_user_micros + me.start.last_resources.cpu_system_micros >= 20000);
+    slassert(3 == me.start.last_resources.open_handles);
+    slassert(-3 == me.stop.last_resources.open_handles);
+    std::lock_guard<std::mutex> guard{mutex};
+    slassert(2 == messages.size());
+    slassert(std::string::npos != messages[0].find("Service transition completed, name: [accounted]"));
+    slassert(std::string::npos != messages[0].find("pending: [SERVICE_START_PENDING]"));
+    slassert(std::string::npos != messages[1].find("open handles: [-3]"));
+    sw::uninstall_service("accounted");
+}
+
+// minimal event loop, completes the pending transition after a delay
+class event_loop {
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::deque<std::function<void()>> tasks;
+    std::vector<std::pair<std::chrono::steady_clock::time_point, sw::transition_completion>> timers;
+    bool closed = false;
+    std::thread th;
+
+public:
+    event_loop() :
+    th([this] { this->run(); }) { }
+
+    ~event_loop() {
+        {
+            std::lock_guard<std::mutex> guard{mutex};
+            closed = true;
+        }
+        cv.notify_all();
+        th.join();
+    }
+
+    void post(std::function<void()> task) {
+        std::lock_guard<std::mutex> guard{mutex};
+        tasks.push_back(std::move(task));
+        cv.notify_all();
+    }
+
+    void complete_after(int millis, sw::transition_completion completion) {
+        auto when = std::chrono::steady_clock::now() + std::chrono::milliseconds(millis);
+        timers.emplace_back(when, std::move(completion));
+    }
+
+private:
+    void run() {
+        std::unique_lock<std::mutex> lock{mutex};
+        while (!closed) {
+            cv.wait_for(lock, std::chrono::milliseconds(5));
+            while (!tasks.empty()) {
+                auto task = std::move(tasks.front());
+                tasks.pop_front();
+                lock.unlock();
+                task();
+                lock.lock();
+            }
+            auto now = std::chrono::steady_clock::now();
+            for (auto it = timers.begin(); it != timers.end();) {
+                if (it->first <= now) {
+                    it->second.complete();
+                    it = timers.erase(it);
+                } else {
+                    ++it;
+                }
+            }
+        }
+    }
+};
+
+void test_async_lifecycle() {
+    auto scm = std::make_shared<sw::simulated_scm>();
+    sw::set_scm_backend(scm);
+    sw::install_service("async", "async_test");
+    sw::start_service("async");
+    auto loop = std::make_shared<event_loop>();
+    std::atomic<long long> starter_millis{-1};
+    auto th = std::thread([&] {
+        sw::async_service_lifecycle alc;
+        alc.starter = [&](sw::service_transition& tr, sw::transition_completion completion) {
+            slassert(sw::state_start_pending == tr.pending_state());
+            auto start = std::chrono::steady_clock::now();
+            loop->complete_after(200, std::move(completion));
+            starter_millis = elapsed_millis(start);
+        };
+        alc.stopper = [&](sw::service_transition&, sw::transition_completion completion) {
+            loop->complete_after(10, std::move(completion));
+        };
+        alc.executor = [&](std::function<void()> task) {
+            loop->post(std::move(task));
+        };
+        auto lc = sw::make_async_lifecycle(std::move(alc));
+        lc.heartbeat_interval_millis = 10;
+        sw::start_service_and_wait("async", std::move(lc));
+    });
+    scm->wait_for_state("async", sw::state_running, timeout);
+    // callback returned without waiting for the completion
+    slassert(starter_millis >= 0 && starter_millis < 100);
+    uint32_t last_checkpoint = 0;
+    for (auto& st : scm->status_history("async")) {
+        if (sw::state_start_pending == st.current_state) {
+            last_checkpoint = st.check_point;
+        }
+    }
+    slassert(last_checkpoint > 5);
+    sw::stop_service("async");
+    auto st = scm->wait_for_state("async", sw::state_stopped, timeout);
+    th.join();
+    slassert(0 == st.win32_exit_code);
+
+    // completion dropped by the callback
+    sw::start_service("async");
+    auto th_abandoned = std::thread([&] {
+        sw::async_service_lifecycle alc;
+        alc.starter = [](sw::service_transition&, sw::transition_completion) { };
+        alc.stopper = [](sw::service_transition&, sw::transition_completion completion) {
+            completion.complete();
+            slassert(completion.is_finished());
+            // ignored
+            completion.fail("late failure");
+        };
+        alc.executor = [&](std::function<void()> task) {
+            loop->post(std::move(task));
+        };
+        sw::start_service_and_wait("async", sw::make_async_lifecycle(std::move(alc)));
+    });
+    st = scm->wait_for_state("async", sw::state_stopped, timeout);
+    th_abandoned.join();
+    slassert(0 != st.win32_exit_code);
+    sw::uninstall_service("async");
+}
+
+int main() {
+    try {
+        test_shutdown_during_start();
+        test_coalescing();
+        test_heartbeat();
+        test_progress_hint();
+        test_pause_resume();
+        test_shared_process();
+        test_metrics();
+        test_state_view();
+        test_listener_outside_lock();
+        test_preshutdown_budget();
+        test_cancellation();
+        test_event_bus();
+        test_supervisor_restart();
+        test_supervisor_hang();
+        test_trace();
+        test_resource_accounting();
+        test_async_lifecycle();
+    } catch (const std::exception& e) {
+        std::cout << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,306 @@
+/*
+ * Copyright 2026, alex at staticlibs.net
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * File:   posix_scm_test.cpp
+ * Author: alex
+ *
+ * Created on October 17, 2026, 11:20 AM
+ */
+
+#include "staticlib/winservice.hpp"
+
+#include <iostream>
+
+#ifndef STATICLIB_WINDOWS
+
+#include <atomic>
+#include <chrono>
+#include <csignal>
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <signal.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "staticlib/config/assert.hpp"
+#include "staticlib/support.hpp"
+
+namespace sw = sl::winservice;
+
+const uint32_t timeout = 10000;
+
+void test_signals() {
+    sw::set_scm_backend(std::make_shared<sw::posix_scm>());
+    std::atomic<int> started{0};
+    std::atomic<int> paused{0};
+    std::atomic<int> stopped{0};
+    sw::service_lifecycle lc;
+    lc.starter = [&](sw::service_transition&) { started += 1; };
+    lc.stopper = [&](sw::service_transition&) { stopped += 1; };
+    lc.pauser = [&](sw::service_transition&) { paused += 1; };
+    lc.logger = [](const std::string& msg) { std::cout << msg << std::endl; };
+    auto controller = std::thread([&] {
+        sw::service_state_view view{"posix"};
+        slassert(sw::state_running == view.wait_for_state(sw::state_running, timeout).current_state);
+        ::kill(::getpid(), SIGTSTP);
+        slassert(sw::state_paused == view.wait_for_state(sw::state_paused, timeout).current_state);
+        ::kill(::getpid(), SIGCONT);
+        slassert(sw::state_running == view.wait_for_state(sw::state_running, timeout).current_state);
+        ::kill(::getpid(), SIGTERM);
+    });
+    sw::start_service_and_wait("posix", lc);
+    controller.join();
+    slassert(2 == started);
+    slassert(1 == paused);
+    slassert(1 == stopped);
+
+    // default handlers are restored
+    struct sigaction sa;
+    ::sigaction(SIGTERM, nullptr, &sa);
+    slassert(SIG_DFL == sa.sa_handler);
+}
+
+// stand-in for the service manager side of the notification socket
+class notify_listener {
+    std::string path;
+    int fd;
+    std::atomic<bool> stopped{false};
+    std::mutex mutex;
+    std::vector<std::string> messages;
+    std::thread reader;
+
+public:
+    notify_listener(const std::string& socket_path) :
+    path(socket_path) {
+        fd = ::socket(AF_UNIX, SOCK_DGRAM, 0);
+        slassert(fd >= 0);
+        struct sockaddr_un addr;
+        std::memset(std::addressof(addr), '\0', sizeof(addr));
+        addr.sun_family = AF_UNIX;
+        std::memcpy(addr.sun_path, path.data(), path.length());
+        if ('@' == path[0]) {
+            addr.sun_path[0] = '\0';
+        } else {
+            ::unlink(path.c_str());
+        }
+        auto len = static_cast<socklen_t>(offsetof(struct sockaddr_un, sun_path) + path.length());
+        slassert(0 == ::bind(fd, reinterpret_cast<struct sockaddr*>(std::addressof(addr)), len));
+        struct timeval tv;
+        tv.tv_sec = 0;
+        tv.tv_usec = 20000;
+        ::setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, std::addressof(tv), sizeof(tv));
+        reader = std::thread([this] {
+            char buf[1024];
+            while (!stopped) {
+                auto count = ::recv(fd, buf, sizeof(buf), 0);
+                if (count > 0) {
+                    std::lock_guard<std::mutex> guard{mutex};
+                    messages.emplace_back(buf, static_cast<size_t>(count));
+                }
+            }
+        });
+    }
+
+    ~notify_listener() {
+        stopped = true;
+        reader.join();
+        ::close(fd);
+        if ('@' != path[0]) {
+            ::unlink(path.c_str());
+        }
+    }
+
+    bool received(const std::string& assignment) {
+        std::lock_guard<std::mutex> guard{mutex};
+        for (auto& msg : messages) {
+            if (std::string::npos != msg.find(assignment)) return true;
+        }
+        return false;
+    }
+
+    size_t count(const std::string& assignment) {
+        std::lock_guard<std::mutex> guard{mutex};
+        size_t res = 0;
+        for (auto& msg : messages) {
+            if (std::string::npos != msg.find(assignment)) {
+                res += 1;
+            }
+        }
+        return res;
+    }
+};
+
+void test_notify_socket() {
+    auto path = "@staticlib_winservice_test_" + sl::support::to_string(::getpid());
+    notify_listener listener{path};
+    sw::notify_socket sock{path};
+    slassert(sock.is_enabled());
+    sock.notify("STATUS=foo");
+    for (int i = 0; i < 100 && !listener.received("STATUS=foo"); i++) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    slassert(listener.received("STATUS=foo"));
+
+    sw::notify_socket disabled{""};
+    slassert(!disabled.is_enabled());
+    disabled.notify("READY=1");
+}
+
+void test_notify() {
+    auto path = "/tmp/staticlib_winservice_test_" + sl::support::to_string(::getpid()) + ".sock";
+    notify_listener listener{path};
+    ::setenv("NOTIFY_SOCKET", path.c_str(), 1);
+    ::setenv("WATCHDOG_USEC", "40000", 1);
+    sw::service_lifecycle lc;
+    lc.starter = [](sw::service_transition&) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    };
+    lc.stopper = [](sw::service_transition&) { };
+    lc.wait_hint_millis = 5000;
+    lc.heartbeat_interval_millis = 10;
+    auto controller = std::thread([&] {
+        sw::service_state_view view{"posix_notify"};
+        slassert(sw::state_running == view.wait_for_state(sw::state_running, timeout).current_state);
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        ::kill(::getpid(), SIGTERM);
+    });
+    sw::start_service_and_wait("posix_notify", lc);
+    controller.join();
+    ::unsetenv("NOTIFY_SOCKET");
+    ::unsetenv("WATCHDOG_USEC");
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+
+    slassert(listener.received("EXTEND_TIMEOUT_USEC=5000000"));
+    slassert(listener.received("READY=1"));
+    slassert(listener.received("WATCHDOG=1"));
+    slassert(listener.received("STOPPING=1"));
+    slassert(listener.received("STATUS=posix_notify: SERVICE_STOPPED"));
+}
+
+void test_watchdog_stalled() {
+    auto path = "/tmp/staticlib_winservice_test_watchdog_" + sl::support::to_string(::getpid()) + ".sock";
+    notify_listener listener{path};
+    ::setenv("NOTIFY_SOCKET", path.c_str(), 1);
+    ::setenv("WATCHDOG_USEC", "40000", 1);
+    std::atomic<size_t> pings_running{0};
+    std::atomic<size_t> pings_stalled{0};
+    sw::service_lifecycle lc;
+    lc.starter = [](sw::service_transition&) { };
+    // stuck longer than the wait hint, heartbeat keeps publishing checkpoints
+    lc.stopper = [&](sw::service_transition&) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(300));
+        pings_stalled = listener.count("WATCHDOG=1");
+        std::this_thread::sleep_for(std::chrono::milliseconds(300));
+        slassert(pings_stalled == listener.count("WATCHDOG=1"));
+    };
+    lc.wait_hint_millis = 100;
+    lc.heartbeat_interval_millis = 10;
+    auto controller = std::thread([&] {
+        sw::service_state_view view{"posix_watchdog"};
+        slassert(sw::state_running == view.wait_for_state(sw::state_running, timeout).current_state);
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        pings_running = listener.count("WATCHDOG=1");
+        ::kill(::getpid(), SIGTERM);
+    });
+    sw::start_service_and_wait("posix_watchdog", lc);
+    controller.join();
+    ::unsetenv("NOTIFY_SOCKET");
+    ::unsetenv("WATCHDOG_USEC");
+
+    slassert(pings_running > 0);
+    auto st = sw::service_state_view("posix_watchdog").snapshot();
+    // stopper assertion has passed
+    slassert(0 == st.win32_exit_code);
+}
+
+void test_notify_failure() {
+    auto path = "/tmp/staticlib_winservice_test_failure_" + sl::support::to_string(::getpid()) + ".sock";
+    notify_listener listener{path};
+    ::setenv("NOTIFY_SOCKET", path.c_str(), 1);
+    sw::service_lifecycle lc;
+    lc.starter = [](sw::service_transition&) {
+        throw sw::winservice_exception("start failed");
+    };
+    lc.stopper = [](sw::service_transition&) { };
+    sw::start_service_and_wait("posix_failed", lc);
+    ::unsetenv("NOTIFY_SOCKET");
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+
+    slassert(listener.received("STATUS=posix_failed: SERVICE_STOPPED, exit code: 1\n"));
+    slassert(!listener.received("ERRNO="));
+}
+
+void test_notify_unreachable() {
+    ::setenv("NOTIFY_SOCKET", "/tmp/staticlib_winservice_test_missing.sock", 1);
+    sw::service_lifecycle lc;
+    lc.starter = [](sw::service_transition&) { };
+    lc.stopper = [](sw::service_transition&) { };
+    auto controller = std::thread([&] {
+        sw::service_state_view view{"posix_unreachable"};
+        slassert(sw::state_running == view.wait_for_state(sw::state_running, timeout).current_state);
+        ::kill(::getpid(), SIGTERM);
+    });
+    sw::start_service_and_wait("posix_unreachable", lc);
+    controller.join();
+    ::unsetenv("NOTIFY_SOCKET");
+    // lost notifications do not fail the transitions
+    auto st = sw::service_state_view("posix_unreachable").snapshot();
+    slassert(sw::state_stopped == st.current_state);
+    slassert(0 == st.win32_exit_code);
+}
+
+void test_connect_unsupported() {
+    bool thrown = false;
+    try {
+        sw::posix_scm().connect();
+    } catch (const sw::winservice_exception&) {
+        thrown = true;
+    }
+    slassert(thrown);
+}
+
+int main() {
+    try {
+        test_signals();
+        test_notify_socket();
+        test_notify();
+        test_watchdog_stalled();
+        test_notify_failure();
+        test_notify_unreachable();
+        test_connect_unsupported();
+    } catch (const std::exception& e) {
+        std::cout << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
+
+#else // STATICLIB_WINDOWS
+
+int main() {
+    std::cout << "test skipped" << std::endl;
+    return 0;
+}
+
+#endif // !STATICLIB_WINDOWS
@@ -0,0 +1,385 @@
+/*
+ * Copyright 2026, alex at staticlibs.net
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * File:   simulated_scm_test.cpp
+ * Author: alex
+ *
+ * Created on October 17, 2026, 12:03 PM
+ */
+
+#include "staticlib/winservice.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+#include "staticlib/config/assert.hpp"
+
+namespace sw = sl::winservice;
+
+const uint32_t timeout = 10000;
+
+void test_lifecycle() {
+    auto scm = std::make_shared<sw::simulated_scm>();
+    sw::set_scm_backend(scm);
+    sw::install_service("foo", "foo_test");
+    bool thrown = false;
+    try {
+        sw::install_service("foo", "foo_test");
+    } catch (const sw::winservice_exception&) {
+        thrown = true;
+    }
+    slassert(thrown);
+
+    std::atomic<int> started{0};
+    std::atomic<int> stopped{0};
+    sw::start_service("foo");
+    auto th = std::thread([&] {
+        sw::start_service_and_wait("foo",
+                [&] { started += 1; },
+                [&] { stopped += 1; },
+                [](const std::string& msg) { std::cout << msg << std::endl; });
+    });
+    scm->wait_for_state("foo", sw::state_running, timeout);
+    slassert(1 == started);
+
+    auto conn = scm->connect();
+    conn->control_service("foo", sw::control_pause);
+    scm->wait_for_state("foo", sw::state_paused, timeout);
+    slassert(1 == stopped);
+    conn->control_service("foo", sw::control_continue);
+    scm->wait_for_state("foo", sw::state_running, timeout);
+    slassert(2 == started);
+
+    sw::stop_service("foo");
+    th.join();
+    slassert(2 == stopped);
+    slassert(sw::state_stopped == conn->query_service_status("foo").current_state);
+
+    auto hist = scm->status_history("foo");
+    slassert(hist.size() >= 8);
+    slassert(sw::state_start_pending == hist.front().current_state);
+    slassert(sw::state_stopped == hist.back().current_state);
+
+    sw::uninstall_service("foo");
+    thrown = false;
+    try {
+        conn->query_service_status("foo");
+    } catch (const sw::winservice_exception&) {
+        thrown = true;
+    }
+    slassert(thrown);
+}
+
+void test_control_checks() {
+    auto scm = std::make_shared<sw::simulated_scm>();
+    sw::set_scm_backend(scm);
+    sw::install_service("bar", "bar_test");
+    auto conn = scm->connect();
+    bool thrown = false;
+    try {
+        conn->control_service("bar", sw::control_stop);
+    } catch (const sw::winservice_exception&) {
+        thrown = true;
+    }
+    slassert(thrown);
+
+    // dispatcher requires the start to be requested first
+    thrown = false;
+    try {
+        sw::start_service_and_wait("bar", [] {}, [] {}, [](const std::string&) {});
+    } catch (const sw::winservice_exception&) {
+        thrown = true;
+    }
+    slassert(thrown);
+
+    sw::start_service("bar");
+    auto th = std::thread([&] {
+        sw::start_service_and_wait("bar", [] {}, [] {}, [](const std::string&) {});
+    });
+    scm->wait_for_state("bar", sw::state_running, timeout);
+    thrown = false;
+    try {
+        sw::uninstall_service("bar");
+    } catch (const sw::winservice_exception&) {
+        thrown = true;
+    }
+    slassert(thrown);
+    scm->send_control("bar", sw::control_shutdown);
+    th.join();
+    sw::uninstall_service("bar");
+}
+
+void test_session_batch() {
+    auto scm = std::make_shared<sw::simulated_scm>();
+    sw::set_scm_backend(scm);
+    sw::install_service("foo", "foo_test");
+    sw::install_service("bar", "bar_test");
+    sw::scm_session session{2};
+    auto started = session.start_services({"foo", "missing", "bar"});
+    slassert(3 == started.size());
+    slassert("foo" == started[0].service_name);
+    slassert(started[0].success);
+    slassert(!started[1].success);
+    slassert(!started[1].error.empty());
+    slassert(started[2].success);
+
+    std::atomic<int> stopped{0};
+    auto th_foo = std::thread([&] {
+        sw::start_service_and_wait("foo", [] {}, [&] { stopped += 1; }, [](const std::string&) {});
+    });
+    scm->wait_for_state("foo", sw::state_running, timeout);
+    // not launched services stay in 'START_PENDING' and do not accept controls
+    auto stopped_res = session.stop_services({"foo", "bar"});
+    slassert(stopped_res[0].success);
+    slassert(!stopped_res[1].success);
+    th_foo.join();
+    slassert(1 == stopped);
+
+    auto th_bar = std::thread([&] {
+        sw::start_service_and_wait("bar", [] {}, [] {}, [](const std::string&) {});
+    });
+    scm->wait_for_state("bar", sw::state_running, timeout);
+    session.stop_service("bar");
+    th_bar.join();
+    auto removed = session.uninstall_services({"foo", "bar"});
+    slassert(removed[0].success);
+    slassert(removed[1].success);
+}
+
+void test_async() {
+    auto scm = std::make_shared<sw::simulated_scm>();
+    sw::set_scm_backend(scm);
+    sw::install_service("foo", "foo_test");
+    auto started = sw::start_service_async("foo", timeout);
+    auto th = std::thread([&] {
+        sw::start_service_and_wait("foo", [] {}, [] {}, [](const std::string&) {});
+    });
+    slassert(sw::state_running == started.get().current_state);
+
+    std::promise<std::string> stopped;
+    sw::stop_service_async("foo", timeout, [&stopped](const sw::service_status& st, const std::string& err) {
+        stopped.set_value(sw::state_stopped == st.current_state ? err : "invalid state");
+    });
+    slassert(stopped.get_future().get().empty());
+    th.join();
+
+    // service process is not launched, start remains pending
+    auto timed_out = sw::start_service_async("foo", 100);
+    bool thrown = false;
+    try {
+        timed_out.get();
+    } catch (const sw::winservice_exception& e) {
+        thrown = true;
+        slassert(std::string(e.what()).find("checkpoint: [0]") != std::string::npos);
+    }
+    slassert(thrown);
+
+    // exception from the callback does not terminate the process
+    sw::install_service("bar", "bar_test");
+    std::atomic<bool> called{false};
+    sw::start_service_async("bar", 10, [&called](const sw::service_status&, const std::string&) {
+        called.store(true);
+        throw std::runtime_error("callback failed");
+    });
+    while (!called.load()) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+}
+
+void test_reconcile() {
+    auto scm = std::make_shared<sw::simulated_scm>();
+    sw::set_scm_backend(scm);
+    sw::service_config cf;
+    cf.name = "reconciled";
+    cf.display_name = "Reconciled";
+    cf.binary_path = "C:\\Program Files\\foo\\foo.exe";
+    cf.arguments = {"--config", "C:\\foo\\config.json"};
+    cf.account = "NT AUTHORITY\\LocalService";
+    cf.description = "Foo";
+
+    auto res = sw::reconcile_service(cf);
+    slassert(res.installed);
+    slassert(0 == res.changed_fields);
+
+    // unchanged config is a no-op
+    auto same = cf;
+    same.account = "nt authority\\localservice";
+    same.display_name = "";
+    res = sw::reconcile_service(same);
+    slassert(!res.installed);
+    slassert(0 == res.changed_fields);
+    slassert(0 == scm->config_change_count("reconciled"));
+
+    auto changed = cf;
+    changed.display_name = "";
+    changed.start_type = sw::start_type_auto;
+    changed.delayed_auto_start = true;
+    changed.description = "Foo Service";
+    sw::service_failure_action restart;
+    restart.type = sw::failure_action_restart;
+    restart.delay_millis = 5000;
+    changed.failure_actions.actions.push_back(restart);
+    changed.failure_actions.reset_period_secs = 86400;
+    res = sw::reconcile_service(changed);
+    slassert((sw::config_start_type | sw::config_description | sw::config_failure_actions) == res.changed_fields);
+    slassert("start_type, description, failure_actions" == sw::config_fields_to_string(res.changed_fields));
+    slassert(1 == scm->config_change_count("reconciled"));
+    auto current = scm->connect()->query_service_config("reconciled");
+    slassert("Reconciled" == current.display_name);
+    slassert(current.delayed_auto_start);
+    slassert("Foo Service" == current.description);
+    slassert(1 == current.failure_actions.actions.size());
+    slassert(0 == sw::diff_service_config(current, changed));
+
+    res = sw::reconcile_service(changed);
+    slassert(0 == res.changed_fields);
+    slassert(1 == scm->config_change_count("reconciled"));
+    sw::uninstall_service("reconciled");
+
+    // missing service is installed with the current executable
+    sw::service_config no_path;
+    no_path.name = "reconciled_no_path";
+    res = sw::reconcile_service(no_path);
+    slassert(res.installed);
+    current = scm->connect()->query_service_config("reconciled_no_path");
+    slassert(!current.binary_path.empty());
+    res = sw::reconcile_service(no_path);
+    slassert(0 == res.changed_fields);
+    sw::uninstall_service("reconciled_no_path");
+}
+
+void test_snapshot() {
+    auto scm = std::make_shared<sw::simulated_scm>();
+    sw::set_scm_backend(scm);
+    sw::install_service("snap_a", "snap_a_test");
+    sw::install_service("snap_b", "snap_b_test");
+    sw::install_service("snap_c", "snap_c_test");
+    sw::scm_session session{scm};
+    sw::service_snapshot snap{{"snap_a", "snap_b"}};
+    auto changes = snap.refresh(session.get_connection());
+    slassert(2 == changes.size());
+    slassert(sw::change_added == changes[0].changes);
+    slassert(nullptr != snap.find("snap_a"));
+    slassert(nullptr == snap.find("snap_c"));
+    slassert(snap.refresh(session.get_connection()).empty());
+
+    sw::start_service("snap_a");
+    auto th = std::thread([] {
+        sw::start_service_and_wait("snap_a", [] {}, [] {}, [](const std::string&) {});
+    });
+    scm->wait_for_state("snap_a", sw::state_running, timeout);
+    sw::uninstall_service("snap_b");
+    changes = snap.refresh(session.get_connection());
+    slassert(2 == changes.size());
+    slassert("snap_a" == changes[0].service_name);
+    slassert((sw::change_state | sw::change_process) == changes[0].changes);
+    slassert(sw::state_running == changes[0].current.current_state);
+    slassert(0 != snap.find("snap_a")->status.process_id);
+    slassert("snap_b" == changes[1].service_name);
+    slassert(sw::change_removed == changes[1].changes);
+    slassert(3 == snap.get_version());
+
+    sw::stop_service("snap_a");
+    th.join();
+    sw::uninstall_service("snap_a");
+    sw::uninstall_service("snap_c");
+}
+
+void test_install_config() {
+    auto scm = std::make_shared<sw::simulated_scm>();
+    sw::set_scm_backend(scm);
+    sw::install_service("delayed", "Delayed", "NT AUTHORITY\\LocalService", "", "SERVICE_DELAYED_AUTO_START");
+    auto delayed = scm->connect()->query_service_config("delayed");
+    slassert(sw::start_type_auto == delayed.start_type);
+    slassert(delayed.delayed_auto_start);
+    slassert(!delayed.binary_path.empty());
+    sw::uninstall_service("delayed");
+
+    sw::service_config cf;
+    cf.name = "triggered";
+    cf.display_name = "Triggered";
+    cf.description = "Started when the network is available";
+    cf.start_type = sw::start_type_demand;
+    cf.load_order_group = "NetworkProvider";
+    sw::service_trigger on_ip;
+    on_ip.type = sw::trigger_type_ip_address_availability;
+    on_ip.subtype = sw::trigger_subtype_first_ip_address_arrival;
+    cf.triggers.push_back(on_ip);
+    sw::service_trigger on_port;
+    on_port.type = sw::trigger_type_firewall_port_event;
+    on_port.action = sw::trigger_action_stop;
+    on_port.subtype = "{A144ED38-8E12-4DE4-9D96-E64740B1A524}";
+    on_port.data.push_back("5001;TCP");
+    cf.triggers.push_back(on_port);
+    sw::install_service(cf);
+    auto current = scm->connect()->query_service_config("triggered");
+    slassert(!current.binary_path.empty());
+    slassert("NetworkProvider" == current.load_order_group);
+    slassert(2 == current.triggers.size());
+    slassert(1 == current.triggers[1].data.size());
+    // GUIDs are compared regardless of case and braces
+    auto same = cf;
+    same.triggers[1].subtype = sw::trigger_subtype_firewall_port_close;
+    slassert(0 == sw::diff_service_config(current, same));
+
+    // triggers removed, group changed
+    auto changed = cf;
+    changed.triggers.clear();
+    changed.load_order_group = "";
+    auto res = sw::reconcile_service(changed);
+    slassert((sw::config_load_order_group | sw::config_triggers) == res.changed_fields);
+    slassert("load_order_group, triggers" == sw::config_fields_to_string(res.changed_fields));
+    current = scm->connect()->query_service_config("triggered");
+    slassert(current.triggers.empty());
+    slassert(current.load_order_group.empty());
+
+    // malformed subtype is rejected
+    auto invalid = cf;
+    invalid.name = "invalid_trigger";
+    invalid.triggers[0].subtype = "not-a-guid";
+    bool thrown = false;
+    try {
+        sw::install_service(invalid);
+    } catch (const sw::winservice_exception& e) {
+        thrown = std::string::npos != std::string(e.what()).find("ERROR_INVALID_PARAMETER");
+    }
+    slassert(thrown);
+    slassert(!scm->connect()->is_service_installed("invalid_trigger"));
+    sw::uninstall_service("triggered");
+}
+
+int main() {
+    try {
+        test_lifecycle();
+        test_control_checks();
+        test_session_batch();
+        test_async();
+        test_reconcile();
+        test_snapshot();
+        test_install_config();
+    } catch (const std::exception& e) {
+        std::cout << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,242 @@
+/*
+ * Copyright 2026, alex at staticlibs.net
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * File:   socket_handoff_test.cpp
+ * Author: alex
+ *
+ * Created on October 17, 2026, 5:05 PM
+ */
+
+#include "staticlib/winservice.hpp"
+
+#include <iostream>
+
+#ifndef STATICLIB_WINDOWS
+
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <thread>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "staticlib/config/assert.hpp"
+#include "staticlib/support.hpp"
+
+namespace sw = sl::winservice;
+
+const uint32_t timeout = 10000;
+
+std::string endpoint() {
+    return "/tmp/winservice_handoff_test_" + sl::support::to_string(::getpid()) + ".sock";
+}
+
+int listen_tcp() {
+    auto fd = ::socket(AF_INET, SOCK_STREAM, 0);
+    slassert(-1 != fd);
+    struct sockaddr_in addr;
+    std::memset(std::addressof(addr), '\0', sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr.sin_port = 0;
+    slassert(0 == ::bind(fd, reinterpret_cast<struct sockaddr*>(std::addressof(addr)), sizeof(addr)));
+    slassert(0 == ::listen(fd, 16));
+    return fd;
+}
+
+uint16_t local_port(int fd) {
+    struct sockaddr_in addr;
+    socklen_t len = sizeof(addr);
+    slassert(0 == ::getsockname(fd, reinterpret_cast<struct sockaddr*>(std::addressof(addr)), std::addressof(len)));
+    return ntohs(addr.sin_port);
+}
+
+int connect_tcp(uint16_t port) {
+    auto fd = ::socket(AF_INET, SOCK_STREAM, 0);
+    struct sockaddr_in addr;
+    std::memset(std::addressof(addr), '\0', sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr.sin_port = htons(port);
+    slassert(0 == ::connect(fd, reinterpret_cast<struct sockaddr*>(std::addressof(addr)), sizeof(addr)));
+    return fd;
+}
+
+void test_handoff() {
+    auto old_fd = listen_tcp();
+    auto port = local_port(old_fd);
+    std::atomic<bool> drained{false};
+    auto old_server = sw::handoff_server(endpoint(), [&] {
+        sw::handoff_state st;
+        st.sockets.push_back(old_fd);
+        st.state = "port=" + sl::support::to_string(port);
+        return st;
+    }, [&] {
+        ::close(old_fd);
+        drained.store(true);
+    });
+
+    // new instance in standby
+    auto client = sw::handoff_client(endpoint());
+    sw::handoff_state received;
+    slassert(client.receive(timeout, received));
+    slassert(1 == received.sockets.size());
+    slassert("port=" + sl::support::to_string(port) == received.state);
+    auto new_fd = static_cast<int>(received.sockets[0]);
+    slassert(new_fd != old_fd);
+    slassert(port == local_port(new_fd));
+    slassert(!old_server.is_released());
+
+    // connection made before the release is accepted by the new instance
+    auto conn1 = connect_tcp(port);
+    auto accepted1 = ::accept(new_fd, nullptr, nullptr);
+    slassert(-1 != accepted1);
+
+    client.release_previous();
+    while (!drained.load()) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    slassert(old_server.is_released());
+
+    // listener stays open after the old instance has closed its copy
+    auto conn2 = connect_tcp(port);
+    auto accepted2 = ::accept(new_fd, nullptr, nullptr);
+    slassert(-1 != accepted2);
+
+    // endpoint is free for the next upgrade
+    auto new_server = sw::handoff_server(endpoint(), [] { return sw::handoff_state(); }, nullptr);
+    new_server.close();
+
+    for (auto fd : {conn1, accepted1, conn2, accepted2, new_fd}) {
+        ::close(fd);
+    }
+}
+
+void test_cold_start() {
+    auto client = sw::handoff_client(endpoint());
+    sw::handoff_state received;
+    slassert(!client.receive(timeout, received));
+    slassert(received.sockets.empty());
+}
+
+void test_aborted_standby() {
+    auto old_fd = listen_tcp();
+    std::atomic<int> requests{0};
+    auto old_server = sw::handoff_server(endpoint(), [&] {
+        requests += 1;
+        sw::handoff_state st;
+        st.sockets.push_back(old_fd);
+        return st;
+    }, nullptr);
+    {
+        // new instance fails before the release
+        auto client = sw::handoff_client(endpoint());
+        sw::handoff_state received;
+        slassert(client.receive(timeout, received));
+        ::close(static_cast<int>(received.sockets[0]));
+    }
+    // old instance continues to serve the next one
+    auto client = sw::handoff_client(endpoint());
+    sw::handoff_state received;
+    slassert(client.receive(timeout, received));
+    slassert(!old_server.is_released());
+    client.release_previous();
+    slassert(old_server.is_released());
+    slassert(2 == requests);
+    ::close(static_cast<int>(received.sockets[0]));
+    ::close(old_fd);
+}
+
+void test_silent_peer() {
+    auto old_fd = listen_tcp();
+    auto old_server = sw::handoff_server(endpoint(), [&] {
+        sw::handoff_state st;
+        st.sockets.push_back(old_fd);
+        return st;
+    }, nullptr, 200);
+    // connects and sends nothing
+    auto silent = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    struct sockaddr_un addr;
+    std::memset(std::addressof(addr), '\0', sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    auto path = endpoint();
+    std::memcpy(addr.sun_path, path.data(), path.length());
+    slassert(0 == ::connect(silent, reinterpret_cast<struct sockaddr*>(std::addressof(addr)), sizeof(addr)));
+    // connection is dropped after the timeout
+    auto client = sw::handoff_client(endpoint());
+    sw::handoff_state received;
+    slassert(client.receive(timeout, received));
+    client.release_previous();
+    slassert(old_server.is_released());
+    ::close(static_cast<int>(received.sockets[0]));
+    ::close(silent);
+    ::close(old_fd);
+}
+
+void test_dropped_on_release() {
+    auto old_fd = listen_tcp();
+    std::shared_ptr<sw::handoff_server> old_server;
+    std::atomic<bool> dropped{false};
+    old_server = std::make_shared<sw::handoff_server>(endpoint(), [&] {
+        sw::handoff_state st;
+        st.sockets.push_back(old_fd);
+        return st;
+    }, [&] {
+        // closed and destroyed from the worker thread
+        old_server->close();
+        old_server.reset();
+        dropped.store(true);
+    });
+    auto client = sw::handoff_client(endpoint());
+    sw::handoff_state received;
+    slassert(client.receive(timeout, received));
+    client.release_previous();
+    while (!dropped.load()) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    ::close(static_cast<int>(received.sockets[0]));
+    ::close(old_fd);
+}
+
+int main() {
+    try {
+        test_handoff();
+        test_cold_start();
+        test_aborted_standby();
+        test_silent_peer();
+        test_dropped_on_release();
+    } catch (const std::exception& e) {
+        std::cout << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
+
+#else // STATICLIB_WINDOWS
+
+int main() {
+    std::cout << "test skipped" << std::endl;
+    return 0;
+}
+
+#endif // !STATICLIB_WINDOWS